@@ -0,0 +1,213 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "../src/PluginProcessor.h"
+
+// Offline renderer: runs audio files through the processor chain that a
+// saved filter state (the blob `getStateInformation` writes) compiles to,
+// without a host. Each file is rendered on its own thread pool job.
+
+static void printUsage()
+{
+    std::cout
+        << "usage: DigitalFilterVisualizer_Render <state file> <output dir> <input files...>\n"
+        << "                                      [--threads N] [--block N]\n"
+        << "\n"
+        << "Writes <output dir>/<input name>_filtered.wav (32-bit float) for every input file.\n"
+        << std::endl;
+}
+
+struct RenderStats
+{
+    std::atomic<juce::int64> samples{ 0 };      // frames * channels
+    std::atomic<juce::int64> busyTicks{ 0 };    // summed over worker threads
+    std::atomic<int> failures{ 0 };
+};
+
+class RenderJob final : public juce::ThreadPoolJob
+{
+public:
+    RenderJob(std::unique_ptr<juce::AudioFormatReader> readerToUse,
+              const juce::File& inputFile,
+              const juce::File& outputFileToWrite,
+              FilterState& filterState,
+              int blockSizeToUse,
+              RenderStats& statsToUpdate)
+        : juce::ThreadPoolJob(inputFile.getFileName()),
+          reader(std::move(readerToUse)),
+          outputFile(outputFileToWrite),
+          blockSize(blockSizeToUse),
+          stats(statsToUpdate)
+    {
+        // NOTE: the chain is compiled here, on the main thread, since
+        // FilterState isn't meant to be read from several threads at once
+        const auto numChannels = (int)reader->numChannels;
+        juce::dsp::ProcessSpec spec{ reader->sampleRate, (juce::uint32)blockSize, 1 };
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* chain = new ProcessorChain<float>;
+            chain->prepare(spec);
+            chains.add(chain);
+        }
+        ProcessorChainModifier::rootsToJuceCoeffs(&filterState, &chains, spec, ChainCompileOptions::optimised());
+    }
+
+    JobStatus runJob() override
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        if (!render())
+        {
+            std::cerr << "failed to render " << getJobName() << std::endl;
+            stats.failures.fetch_add(1);
+        }
+        stats.busyTicks.fetch_add(juce::Time::getHighResolutionTicks() - startTicks);
+        return jobHasFinished;
+    }
+
+private:
+    bool render()
+    {
+        outputFile.deleteFile();
+        auto stream = outputFile.createOutputStream();
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        const auto numChannels = (int)reader->numChannels;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(
+            stream.get(), reader->sampleRate, (unsigned int)numChannels, 32, {}, 0));
+        if (writer == nullptr)
+            return false;
+        stream.release(); // the writer owns it now
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        const auto length = reader->lengthInSamples;
+        for (juce::int64 position = 0; position < length; position += blockSize)
+        {
+            if (shouldExit())
+                return false;
+
+            const int numSamples = (int)std::min<juce::int64>(blockSize, length - position);
+            if (!reader->read(&buffer, 0, numSamples, position, true, true))
+                return false;
+
+            juce::dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(), (size_t)numChannels, (size_t)numSamples);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto channelBlock = block.getSingleChannelBlock((size_t)ch);
+                juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+                chains.getUnchecked(ch)->process(context);
+            }
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+                return false;
+            stats.samples.fetch_add((juce::int64)numSamples * numChannels, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    const juce::File outputFile;
+    const int blockSize;
+    RenderStats& stats;
+    FullState<float> chains;
+};
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+
+    juce::StringArray positional;
+    int numThreads = juce::SystemStats::getNumCpus();
+    int blockSize = 4096;
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        if (arg == "--threads" && i + 1 < argc)
+            numThreads = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--block" && i + 1 < argc)
+            blockSize = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        else
+            positional.add(arg);
+    }
+
+    if (positional.size() < 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    juce::MemoryBlock stateData;
+    if (!cwd.getChildFile(positional[0]).loadFileAsData(stateData))
+    {
+        std::cerr << "can't read state file " << positional[0] << std::endl;
+        return 1;
+    }
+
+    auto tree = juce::ValueTree::readFromData(stateData.getData(), stateData.getSize());
+    if (!tree.isValid())
+    {
+        std::cerr << "not a filter state: " << positional[0] << std::endl;
+        return 1;
+    }
+    juce::UndoManager um;
+    FilterState filterState(tree, &um);
+
+    const auto outputDir = cwd.getChildFile(positional[1]);
+    if (!outputDir.createDirectory())
+    {
+        std::cerr << "can't create output directory " << outputDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    RenderStats stats;
+    juce::OwnedArray<RenderJob> jobs;
+    for (int i = 2; i < positional.size(); ++i)
+    {
+        const auto inputFile = cwd.getChildFile(positional[i]);
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+        if (reader == nullptr)
+        {
+            std::cerr << "can't open " << inputFile.getFullPathName() << std::endl;
+            stats.failures.fetch_add(1);
+            continue;
+        }
+
+        const auto outputFile = outputDir.getChildFile(inputFile.getFileNameWithoutExtension() + "_filtered.wav");
+        jobs.add(new RenderJob(std::move(reader), inputFile, outputFile, filterState, blockSize, stats));
+    }
+
+    numThreads = juce::jmin(numThreads, juce::jmax(1, jobs.size()));
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    {
+        juce::ThreadPool pool(numThreads);
+        for (auto* job : jobs)
+            pool.addJobToPool(job, false);
+        for (auto* job : jobs)
+            pool.waitForJobToFinish(job, -1);
+    }
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const double busySeconds = juce::Time::highResolutionTicksToSeconds(stats.busyTicks.load());
+
+    const auto samples = (double)stats.samples.load();
+    const int numFiles = positional.size() - 2;
+    std::cout << "rendered " << numFiles - stats.failures.load() << "/" << numFiles
+              << " files, " << (juce::int64)samples << " samples on " << numThreads << " threads in "
+              << wallSeconds << " s\n"
+              << "throughput: " << (wallSeconds > 0 ? samples / wallSeconds : 0.0) << " samples/s total, "
+              << (busySeconds > 0 ? samples / busySeconds : 0.0) << " samples/s per core" << std::endl;
+
+    return stats.failures.load() == 0 ? 0 : 1;
+}
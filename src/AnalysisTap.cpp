@@ -0,0 +1,222 @@
+#include "AnalysisTap.h"
+
+static void mixToMono(const juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples, float* dest)
+{
+    numChannels = std::min(numChannels, buffer.getNumChannels());
+    if (numChannels <= 0)
+    {
+        juce::FloatVectorOperations::clear(dest, numSamples);
+        return;
+    }
+
+    const float gain = 1.0f / (float)numChannels;
+    juce::FloatVectorOperations::copyWithMultiply(dest, buffer.getReadPointer(0, startSample), gain, numSamples);
+    for (int ch = 1; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::addWithMultiply(dest, buffer.getReadPointer(ch, startSample), gain, numSamples);
+}
+
+AnalysisTap::AnalysisTap()
+    : juce::Thread("Analysis tap")
+{
+}
+
+AnalysisTap::~AnalysisTap()
+{
+    stopAnalysis();
+}
+
+void AnalysisTap::prepare(double sampleRate, int maximumBlockSize)
+{
+    inputScratch.assign((size_t)std::max(1, maximumBlockSize), 0.0f);
+    capturedSamples = 0;
+    currentSampleRate.store(sampleRate);
+}
+
+void AnalysisTap::captureInput(const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    const int numSamples = buffer.getNumSamples();
+    capturedSamples = 0;
+    if (!isActive.load(std::memory_order_relaxed) || numSamples > (int)inputScratch.size())
+        return;
+
+    mixToMono(buffer, numChannels, 0, numSamples, inputScratch.data());
+    capturedSamples = numSamples;
+}
+
+void AnalysisTap::pushOutput(const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    const int numSamples = buffer.getNumSamples();
+    if (capturedSamples != numSamples || numSamples <= 0)
+        return;
+    capturedSamples = 0;
+
+    if (fifo.getFreeSpace() < numSamples)
+    {
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    ring.copyFrom(0, start1, inputScratch.data(), size1);
+    mixToMono(buffer, numChannels, 0, size1, ring.getWritePointer(1, start1));
+    if (size2 > 0)
+    {
+        ring.copyFrom(0, start2, inputScratch.data() + size1, size2);
+        mixToMono(buffer, numChannels, size1, size2, ring.getWritePointer(1, start2));
+    }
+
+    fifo.finishedWrite(size1 + size2);
+}
+
+void AnalysisTap::startAnalysis()
+{
+    isActive.store(true);
+    startThread(juce::Thread::Priority::low);
+}
+
+void AnalysisTap::stopAnalysis()
+{
+    isActive.store(false);
+    stopThread(1000);
+}
+
+void AnalysisTap::setFftOrder(int order)
+{
+    requestedOrder.store(juce::jlimit(minFftOrder, maxFftOrder, order));
+}
+
+void AnalysisTap::setOverlap(int overlap)
+{
+    requestedOverlap.store(juce::jlimit(1, maxOverlap, overlap));
+}
+
+AnalysisTap::Levels AnalysisTap::getInputLevels() const
+{
+    return { inputRms.load(), inputPeak.load() };
+}
+
+AnalysisTap::Levels AnalysisTap::getOutputLevels() const
+{
+    return { outputRms.load(), outputPeak.load() };
+}
+
+bool AnalysisTap::getOutputSpectrum(std::vector<float>& magnitudesDb, double& binWidthHz) const
+{
+    const juce::SpinLock::ScopedLockType lock(spectrumLock);
+    if (publishedSpectrum.empty())
+        return false;
+
+    magnitudesDb = publishedSpectrum;
+    binWidthHz = publishedBinWidth;
+    return true;
+}
+
+void AnalysisTap::configure(int order, int overlap)
+{
+    fft = std::make_unique<juce::dsp::FFT>(order);
+    fftSize = 1 << order;
+    hopSize = fftSize / overlap;
+    hopFill = 0;
+    analysedSampleRate = currentSampleRate.load();
+
+    window.resize((size_t)fftSize);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(
+        window.data(), (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false);
+    fftData.assign((size_t)(2 * fftSize), 0.0f);
+    for (auto& h : history)
+        h.assign((size_t)fftSize, 0.0f);
+    smoothedPower.assign((size_t)(fftSize / 2 + 1), 0.0f);
+    spectrumDb.assign(smoothedPower.size(), 0.0f);
+
+    const juce::SpinLock::ScopedLockType lock(spectrumLock);
+    publishedSpectrum.clear();
+}
+
+void AnalysisTap::run()
+{
+    while (!threadShouldExit())
+    {
+        const int order = requestedOrder.load();
+        const int overlap = requestedOverlap.load();
+        if (fft == nullptr || fft->getSize() != (1 << order) || hopSize != (1 << order) / overlap
+            || !juce::approximatelyEqual(analysedSampleRate, currentSampleRate.load()))
+            configure(order, overlap);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(hopSize - hopFill, start1, size1, start2, size2);
+        if (size1 + size2 == 0)
+        {
+            wait(idleWaitMs);
+            continue;
+        }
+
+        // new samples go to the tail of the history, one hop at a time
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto* dest = history[ch].data() + fftSize - hopSize + hopFill;
+            juce::FloatVectorOperations::copy(dest, ring.getReadPointer(ch, start1), size1);
+            if (size2 > 0)
+                juce::FloatVectorOperations::copy(dest + size1, ring.getReadPointer(ch, start2), size2);
+        }
+        fifo.finishedRead(size1 + size2);
+        hopFill += size1 + size2;
+
+        if (hopFill == hopSize)
+        {
+            analyseHop();
+            for (auto& h : history)
+                std::memmove(h.data(), h.data() + hopSize, sizeof(float) * (size_t)(fftSize - hopSize));
+            hopFill = 0;
+        }
+    }
+}
+
+void AnalysisTap::analyseHop()
+{
+    // levels over the new hop
+    const auto measure = [this](const std::vector<float>& h, std::atomic<float>& rms, std::atomic<float>& peak)
+    {
+        const float* x = h.data() + fftSize - hopSize;
+        double sumSquares = 0.0;
+        float maxAbs = 0.0f;
+        for (int i = 0; i < hopSize; ++i)
+        {
+            sumSquares += (double)x[i] * x[i];
+            maxAbs = std::max(maxAbs, std::abs(x[i]));
+        }
+        rms.store((float)std::sqrt(sumSquares / hopSize));
+        peak.store(maxAbs);
+    };
+    measure(history[0], inputRms, inputPeak);
+    measure(history[1], outputRms, outputPeak);
+
+    // output spectrum over the whole window
+    juce::FloatVectorOperations::multiply(fftData.data(), history[1].data(), window.data(), fftSize);
+    juce::FloatVectorOperations::clear(fftData.data() + fftSize, fftSize);
+    fft->performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // NOTE: a full scale sine reads 0 dB, the Hann window's coherent gain is 1/2
+    const float amplitudeScale = 4.0f / (float)fftSize;
+    for (size_t k = 0; k < smoothedPower.size(); ++k)
+    {
+        const float amplitude = fftData[k] * amplitudeScale;
+        smoothedPower[k] = spectrumSmoothing * smoothedPower[k] + (1.0f - spectrumSmoothing) * amplitude * amplitude;
+        spectrumDb[k] = 10.0f * std::log10(std::max(smoothedPower[k], 1e-20f));
+    }
+
+    const juce::SpinLock::ScopedLockType lock(spectrumLock);
+    publishedSpectrum.swap(spectrumDb);
+    if (spectrumDb.size() != publishedSpectrum.size())
+        spectrumDb.resize(publishedSpectrum.size());
+    publishedBinWidth = analysedSampleRate / fftSize;
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,99 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/** Carries the processor's input and output from processBlock to a
+ * background analyser, which turns them into RMS/peak levels and a
+ * smoothed magnitude spectrum for the UI.
+ * The audio thread side (captureInput / pushOutput) is wait-free: it mixes
+ * to mono into preallocated memory and writes into a single-producer,
+ * single-consumer ring. When the ring is full the block is dropped rather
+ * than waited for.
+ */
+class AnalysisTap final : private juce::Thread
+{
+public:
+    struct Levels
+    {
+        float rms = 0.0f;
+        float peak = 0.0f;
+    };
+
+    AnalysisTap();
+    ~AnalysisTap() override;
+
+    /** Sizes the input scratch buffer. Allocates, call from prepareToPlay. */
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    /** Audio thread. Keeps the mono mix of the block before it is processed. */
+    void captureInput(const juce::AudioBuffer<float>& buffer, int numChannels);
+    /** Audio thread. Pushes the captured input and the mono mix of the processed block. */
+    void pushOutput(const juce::AudioBuffer<float>& buffer, int numChannels);
+
+    void startAnalysis();
+    void stopAnalysis();
+
+    /** FFT size is 2^order, order in [minFftOrder, maxFftOrder] */
+    void setFftOrder(int order);
+    /** number of analysis frames per FFT length, in [1, maxOverlap] */
+    void setOverlap(int overlap);
+
+    Levels getInputLevels() const;
+    Levels getOutputLevels() const;
+
+    /** Copies the latest output spectrum in dBFS, one value per bin from DC to Nyquist.
+     * Returns false until the first frame has been analysed.
+     */
+    bool getOutputSpectrum(std::vector<float>& magnitudesDb, double& binWidthHz) const;
+
+    /** number of blocks the audio thread dropped because the ring was full */
+    juce::uint32 getDroppedBlocks() const { return droppedBlocks.load(std::memory_order_relaxed); }
+
+    static constexpr int minFftOrder = 9;
+    static constexpr int maxFftOrder = 14;
+    static constexpr int maxOverlap = 8;
+
+private:
+    void run() override;
+    void configure(int order, int overlap);
+    void analyseHop();
+
+    // audio thread -> analyser
+    static constexpr int ringSize = 1 << 16;
+    juce::AbstractFifo fifo{ ringSize };
+    juce::AudioBuffer<float> ring{ 2, ringSize };       // channel 0: input, channel 1: output
+    std::vector<float> inputScratch;
+    int capturedSamples = 0;
+    std::atomic<double> currentSampleRate{ 0.0 };
+    std::atomic<bool> isActive{ false };           // the audio thread only writes while the analyser runs
+    std::atomic<juce::uint32> droppedBlocks{ 0 };
+
+    // analyser settings
+    std::atomic<int> requestedOrder{ 11 };
+    std::atomic<int> requestedOverlap{ 4 };
+
+    // analyser thread state
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window, fftData, history[2], smoothedPower, spectrumDb;
+    int fftSize = 0, hopSize = 0, hopFill = 0;
+    double analysedSampleRate = 0.0;
+
+    // analyser -> UI
+    std::atomic<float> inputRms{ 0.0f }, inputPeak{ 0.0f }, outputRms{ 0.0f }, outputPeak{ 0.0f };
+    mutable juce::SpinLock spectrumLock;
+    std::vector<float> publishedSpectrum;
+    double publishedBinWidth = 0.0;
+
+    static constexpr float spectrumSmoothing = 0.7f;    // weight of the previous frame
+    static constexpr int idleWaitMs = 10;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisTap)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
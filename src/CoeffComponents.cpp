@@ -136,6 +136,17 @@ juce::Component* CoefficientsComponent::refreshComponentForCell(int row, int col
 }
 
 void CoefficientsComponent::updateFilterStateOnCoefEdit(int row, int col, double value)
+{
+    const auto revision = processor->filterState->revision;
+    {
+        const juce::ScopedValueSetter<bool> applying(isApplyingEdit, true);
+        applyCoefEdit(row, col, value);
+    }
+    if (processor->filterState->revision != revision)
+        updateCoeffTable();
+}
+
+void CoefficientsComponent::applyCoefEdit(int row, int col, double value)
 {
     // calculate roots through the coefficient2roots function && notify other listeners about this change
 
@@ -146,7 +157,9 @@ void CoefficientsComponent::updateFilterStateOnCoefEdit(int row, int col, double
 
     if (col == 2)
     {
-        auto zeros = CoefficientsToRoots::QR(this->ffcoeffs);
+        auto zeros = CoefficientsToRoots::refine(this->ffcoeffs, getRoots(processor->filterState->zeros), workspace);
+        if (moveRootsInPlace(processor->filterState->zeros, zeros, 1))
+            return;
 
         while (!processor->filterState->zeros.isEmpty())
         {
@@ -163,7 +176,7 @@ void CoefficientsComponent::updateFilterStateOnCoefEdit(int row, int col, double
     }
     else if (col == 3)
     {
-        auto poles =  CoefficientsToRoots::QR(this->fbcoeffs);
+        auto poles = CoefficientsToRoots::refine(this->fbcoeffs, getRoots(processor->filterState->poles), workspace);
 
         // check stability
         auto filterStable = [&]() -> bool {
@@ -185,6 +198,8 @@ void CoefficientsComponent::updateFilterStateOnCoefEdit(int row, int col, double
             return;
         }
 
+        if (moveRootsInPlace(processor->filterState->poles, poles, -1))
+            return;
 
         size_t prev_sz = static_cast<size_t>(processor->filterState->poles.size());
 
@@ -225,8 +240,56 @@ void CoefficientsComponent::updateFilterStateOnCoefEdit(int row, int col, double
     }
 }
 
+std::vector<std::pair<c128, int>> CoefficientsComponent::getRoots(const juce::OwnedArray<FilterRoot>& roots)
+{
+    std::vector<std::pair<c128, int>> result;
+    result.reserve(static_cast<size_t>(roots.size()));
+    for (auto* r : roots)
+        result.emplace_back(r->value.get(), std::abs(r->order.get()));
+    return result;
+}
+
+bool CoefficientsComponent::moveRootsInPlace(juce::OwnedArray<FilterRoot>& current, const std::vector<std::pair<c128, int>>& newRoots, int sign)
+{
+    // NOTE: only when every root has a counterpart of the same order that is on the real axis iff it is,
+    // so the filter order doesn't change. Otherwise the roots are rebuilt.
+    if (static_cast<size_t>(current.size()) != newRoots.size())
+        return false;
+
+    std::vector<int> match(newRoots.size(), -1);
+    std::vector<bool> isTaken(newRoots.size(), false);
+    for (int i = 0; i < current.size(); i++)
+    {
+        auto* r = current[i];
+        const c128 value = r->value.get();
+        double nearest = std::numeric_limits<double>::max();
+        for (size_t j = 0; j < newRoots.size(); j++)
+        {
+            auto& [newValue, order] = newRoots[j];
+            if (isTaken[j] || sign * order != r->order.get() || r->isReal() != juce::exactlyEqual(newValue.imag(), 0.0))
+                continue;
+            const double distance = std::abs(newValue - value);
+            if (distance < nearest)
+            {
+                nearest = distance;
+                match[static_cast<size_t>(i)] = static_cast<int>(j);
+            }
+        }
+        if (match[static_cast<size_t>(i)] < 0)
+            return false;
+        isTaken[static_cast<size_t>(match[static_cast<size_t>(i)])] = true;
+    }
+
+    for (int i = 0; i < current.size(); i++)
+        current[i]->value = newRoots[static_cast<size_t>(match[static_cast<size_t>(i)])].first;
+    return true;
+}
+
 void CoefficientsComponent::valueTreePropertyChanged (juce::ValueTree& node, const juce::Identifier& property)
 {
+    if (isApplyingEdit)
+        return;
+
     if(property == IDs::ValueRe || property == IDs::ValueIm)    // when dragging roots
     {
         updateCoeffTable();
@@ -246,7 +309,8 @@ void CoefficientsComponent::valueTreeChildAdded (juce::ValueTree& node, juce::Va
 	juce::ignoreUnused(node);
 	juce::ignoreUnused(child);
 
-    updateCoeffTable();
+    if (!isApplyingEdit)
+        updateCoeffTable();
 }
 
 void CoefficientsComponent::valueTreeChildRemoved (juce::ValueTree& node, juce::ValueTree& child, int idx)
@@ -255,6 +319,12 @@ void CoefficientsComponent::valueTreeChildRemoved (juce::ValueTree& node, juce::
 	juce::ignoreUnused(child);
 	juce::ignoreUnused(idx);
 
+    if (!isApplyingEdit)
+        updateCoeffTable();
+}
+
+void CoefficientsComponent::updateCoeffTable()
+{
     if (processor->filterState->totalOrder==0) // if filter is cleaned out by erasing the last root
     {
         ffcoeffs.clear();
@@ -262,11 +332,7 @@ void CoefficientsComponent::valueTreeChildRemoved (juce::ValueTree& node, juce::
         coeffTable.updateContent();
         return;
     }
-    updateCoeffTable();
-}
 
-void CoefficientsComponent::updateCoeffTable()
-{
     fbcoeffs = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(
         processor->filterState->poles);
     ffcoeffs = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FilterState.h"
+#include "CoefficientsToRoots.h"
 #include <vector>
 #include <string>
 
@@ -17,6 +18,9 @@ class CoefficientsComponent final
 
         void resized() override;
 
+        // what editing a cell does: col 2 is a feedforward, col 3 a feedback coefficient
+        void updateFilterStateOnCoefEdit(int row, int col, double value);
+
     private:
         std::vector<double> ffcoeffs;
         std::vector<double> fbcoeffs;
@@ -24,10 +28,18 @@ class CoefficientsComponent final
         juce::TableListBox coeffTable;
         bool isExpanded;
         AudioPluginAudioProcessor *processor;
+        CoefficientsToRoots::Workspace workspace; // kept between edits, see CoefficientsToRoots::refine
+        bool isApplyingEdit = false; // the roots change one property at a time, the table follows once they all have
 
         void toggleCollapseExpand();
         void updateCoeffTable();
-        void updateFilterStateOnCoefEdit(int row, int col, double value);
+        void applyCoefEdit(int row, int col, double value);
+
+        // the current roots as guesses for CoefficientsToRoots::refine
+        static std::vector<std::pair<c128, int>> getRoots(const juce::OwnedArray<FilterRoot>&);
+        // moves each root to its nearest new root of the same order (sign: 1 for zeros, -1 for poles),
+        // returns false without touching anything if they don't pair up
+        static bool moveRootsInPlace(juce::OwnedArray<FilterRoot>&, const std::vector<std::pair<c128, int>>&, int sign);
 
         // override juce::Component
         // void paint(juce::Graphics &g) override; // TODO is this trully needed?
@@ -8,9 +8,676 @@
 #include <cmath>
 
 std::vector<std::pair<c128, int>> CoefficientsToRoots::QR(std::vector<double> coefs)
+{
+    thread_local Workspace workspace;
+    return QR(coefs, workspace);
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::QR(const std::vector<double>& input, Workspace& workspace)
 {
     PROFILE_FUNCTION();
 
+    std::vector<std::pair<c128, int>> roots;
+    const auto* monic = monicOf(input, workspace.monic);
+    if (monic == nullptr)
+        return roots;
+    const auto& coefs = *monic;
+
+    size_t orderAtZero = 0;
+    const size_t degree = preprocess(roots, coefs, orderAtZero);
+    if (degree > 1)
+        QR(roots, coefs, degree, orderAtZero, workspace);
+    return roots;
+}
+
+void CoefficientsToRoots::QR(std::vector<std::pair<c128, int>>& roots, const std::vector<double>& coefs, size_t degree, size_t orderAtZero, Workspace& workspace)
+{
+    // build companion Matrix (Hessenberg form), same layout as QRGramSchmidt
+    auto& H = workspace.H;
+    H.assign(degree * degree, 0.0);
+    for (size_t i = 0; i < degree; i++)
+    {
+        H[i * degree + (degree - 1)] = -coefs[coefs.size() - 1 - orderAtZero - i];
+        if (i != degree - 1)
+            H[(i + 1) * degree + i] = 1.0;
+    }
+
+    balance(H, degree);
+    hessenbergEigenvalues(H, degree, workspace.eigenvalues);
+
+    setPolynomial(workspace, coefs, degree, orderAtZero);
+    groupRoots(roots, workspace);
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::Aberth(std::vector<double> coefs)
+{
+    thread_local Workspace workspace;
+    return Aberth(coefs, workspace);
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::Aberth(const std::vector<double>& input, Workspace& workspace)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<std::pair<c128, int>> roots;
+    const auto* monic = monicOf(input, workspace.monic);
+    if (monic == nullptr)
+        return roots;
+    const auto& coefs = *monic;
+
+    size_t orderAtZero = 0;
+    const size_t degree = preprocess(roots, coefs, orderAtZero);
+    if (degree > 1)
+        Aberth(roots, coefs, degree, orderAtZero, workspace);
+    return roots;
+}
+
+void CoefficientsToRoots::Aberth(std::vector<std::pair<c128, int>>& roots, const std::vector<double>& coefs, size_t degree, size_t orderAtZero, Workspace& workspace)
+{
+    setPolynomial(workspace, coefs, degree, orderAtZero);
+    if (!aberthEstimates(workspace))
+    {
+        DBG("CoefficientsToRoots::Aberth failed at degree " << (int)degree << ", falling back to QR");
+        QR(roots, coefs, degree, orderAtZero, workspace);
+        return;
+    }
+    groupRoots(roots, workspace);
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::solve(std::vector<double> coefs)
+{
+    thread_local Workspace workspace;
+    return solve(coefs, workspace);
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::solve(const std::vector<double>& input, Workspace& workspace)
+{
+    std::vector<std::pair<c128, int>> roots;
+    const auto* monic = monicOf(input, workspace.monic);
+    if (monic == nullptr)
+        return roots;
+    const auto& coefs = *monic;
+
+    size_t orderAtZero = 0;
+    const size_t degree = preprocess(roots, coefs, orderAtZero);
+    if (degree > 1)
+        solve(roots, coefs, degree, orderAtZero, workspace);
+    return roots;
+}
+
+void CoefficientsToRoots::solve(std::vector<std::pair<c128, int>>& roots, const std::vector<double>& coefs, size_t degree, size_t orderAtZero, Workspace& workspace)
+{
+    if (degree < aberthMinDegree)
+        QR(roots, coefs, degree, orderAtZero, workspace);
+    else
+        Aberth(roots, coefs, degree, orderAtZero, workspace);
+}
+
+std::vector<std::vector<std::pair<c128, int>>> CoefficientsToRoots::solveBatch(const double* coefs, size_t count, size_t length, WorkerPool& pool, int maxWorkers)
+{
+    PROFILE_FUNCTION();
+
+    struct Worker
+    {
+        Workspace workspace;
+        std::vector<double> monic;
+    };
+    std::vector<Worker> workers(static_cast<size_t>(pool.getNumWorkers()));
+    std::vector<std::vector<std::pair<c128, int>>> results(count);
+
+    pool.parallelFor(count, [&](size_t item, int worker)
+    {
+        const double* row = coefs + item * length;
+        size_t first = 0;
+        while (first < length && row[first] == 0.0)
+            first++;
+        if (first == length)
+            return;
+
+        // NOTE: preprocess finds the leading coefficient as the first exact 1.0
+        auto& monic = workers[static_cast<size_t>(worker)].monic;
+        monic.assign(row + first, row + length);
+        const double lead = monic[0];
+        for (auto& c : monic)
+            c /= lead;
+        monic[0] = 1.0;
+
+        results[item] = solve(monic, workers[static_cast<size_t>(worker)].workspace);
+    }, maxWorkers);
+
+    return results;
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::refine(const std::vector<double>& coefs, const std::vector<std::pair<c128, int>>& guesses)
+{
+    thread_local Workspace workspace;
+    return refine(coefs, guesses, workspace);
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::refine(const std::vector<double>& input, const std::vector<std::pair<c128, int>>& guesses, Workspace& workspace)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<std::pair<c128, int>> roots;
+    const auto* monic = monicOf(input, workspace.monic);
+    if (monic == nullptr)
+        return roots;
+    const auto& coefs = *monic;
+
+    size_t orderAtZero = 0;
+    const size_t degree = preprocess(roots, coefs, orderAtZero);
+    if (degree <= 1)
+        return roots;
+
+    setPolynomial(workspace, coefs, degree, orderAtZero);
+    if (!warmStart(workspace, guesses, orderAtZero) || aberthIterate(workspace, MaxRefineIterations) > 0)
+        solve(roots, coefs, degree, orderAtZero, workspace);
+    else
+        groupRoots(roots, workspace);
+    return roots;
+}
+
+bool CoefficientsToRoots::warmStart(Workspace& workspace, const std::vector<std::pair<c128, int>>& guesses, size_t orderAtZero)
+{
+    const size_t n = workspace.poly.size() - 1;
+    auto& re = workspace.re;
+    auto& im = workspace.im;
+    re.clear();
+    im.clear();
+
+    constexpr double twoPi = 6.283185307179586;
+    size_t zerosLeft = orderAtZero;
+    for (auto& [value, order] : guesses)
+    {
+        auto count = static_cast<size_t>(std::abs(order));
+        if (value == c128(0.0, 0.0))
+        {
+            const size_t taken = std::min(count, zerosLeft);
+            zerosLeft -= taken;
+            count -= taken;
+        }
+        if (re.size() + (value.imag() == 0.0 ? count : 2 * count) > n)
+            return false;
+
+        const double radius = count > 1 ? refineSpread * std::max(1.0, std::abs(value)) : 0.0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const c128 estimate = value + std::polar(radius, twoPi * static_cast<double>(i) / static_cast<double>(count) + 0.4);
+            re.push_back(estimate.real());
+            im.push_back(estimate.imag());
+            if (value.imag() != 0.0)
+            {
+                re.push_back(estimate.real());
+                im.push_back(-estimate.imag());
+            }
+        }
+    }
+    return re.size() == n;
+}
+
+void CoefficientsToRoots::setPolynomial(Workspace& workspace, const std::vector<double>& coefs, size_t degree, size_t orderAtZero)
+{
+    const size_t last = coefs.size() - 1 - orderAtZero;
+    workspace.poly.assign(coefs.begin() + static_cast<std::ptrdiff_t>(last - degree), coefs.begin() + static_cast<std::ptrdiff_t>(last + 1));
+}
+
+bool CoefficientsToRoots::aberthEstimates(Workspace& workspace)
+{
+    PROFILE_FUNCTION();
+
+    const auto& a = workspace.poly;
+    const size_t n = a.size() - 1;
+    auto& re = workspace.re;
+    auto& im = workspace.im;
+    re.resize(n);
+    im.resize(n);
+
+    // Initial estimates on circles from the Newton polygon (Bini): the upper convex hull of
+    // (k, log |c_k|), c_k the coefficient of z^k. An edge from k to l puts l - k estimates on the circle of
+    // radius (|c_k| / |c_l|)^(1/(l - k)), which is close to the magnitudes of that many roots. Starting
+    // them all on one circle leaves groups of them to crawl past the others.
+    // NOTE: the angle offsets keep estimates off the real axis and the circles out of step
+    auto& hull = workspace.cluster;
+    hull.clear();
+    const auto logMagnitude = [&](size_t k) { return std::log(std::abs(a[n - k])); };
+    for (size_t k = 0; k <= n; k++)
+    {
+        if (a[n - k] == 0.0)
+            continue;
+        while (hull.size() >= 2)
+        {
+            const auto i = static_cast<size_t>(hull[hull.size() - 2]);
+            const auto j = static_cast<size_t>(hull.back());
+            // drop j if it lies on or below the line from i to k
+            if ((logMagnitude(j) - logMagnitude(i)) * static_cast<double>(k - i)
+                <= (logMagnitude(k) - logMagnitude(i)) * static_cast<double>(j - i))
+                hull.pop_back();
+            else
+                break;
+        }
+        hull.push_back(static_cast<int>(k));
+    }
+
+    constexpr double twoPi = 6.283185307179586;
+    size_t index = 0;
+    for (size_t edge = 0; edge + 1 < hull.size(); edge++)
+    {
+        const auto from = static_cast<size_t>(hull[edge]);
+        const auto to = static_cast<size_t>(hull[edge + 1]);
+        const size_t count = to - from;
+        double radius = std::exp((logMagnitude(from) - logMagnitude(to)) / static_cast<double>(count));
+        if (!(radius > 0.0) || !std::isfinite(radius))
+            radius = 1.0;
+        for (size_t i = 0; i < count; i++, index++)
+        {
+            const double angle = twoPi * (static_cast<double>(i) / static_cast<double>(count)
+                + static_cast<double>(edge) / static_cast<double>(n)) + 0.4;
+            re[index] = radius * std::cos(angle);
+            im[index] = radius * std::sin(angle);
+        }
+    }
+    jassert(index == n);
+
+    // NOTE: estimates still moving are kept, their inclusion discs are just wider.
+    // QR does worse than that at the degrees this is used for.
+    const size_t unconverged = aberthIterate(workspace, MaxAberthIterations);
+    if (unconverged > 0)
+    {
+        DBG("CoefficientsToRoots::Aberth: " << (int)unconverged << " estimates did not converge");
+    }
+
+    for (auto& estimate : workspace.eigenvalues)
+        if (!std::isfinite(estimate.real()) || !std::isfinite(estimate.imag()))
+            return false;
+    return true;
+}
+
+size_t CoefficientsToRoots::aberthIterate(Workspace& workspace, size_t maxIterations)
+{
+    const size_t n = workspace.poly.size() - 1;
+    auto& re = workspace.re;
+    auto& im = workspace.im;
+    jassert(re.size() == n && im.size() == n);
+    workspace.nextRe.resize(n);
+    workspace.nextIm.resize(n);
+
+    // the first `active` estimates are the ones still moving
+    size_t active = n;
+    for (size_t iter = 0; iter < maxIterations && active > 0; iter++)
+    {
+        evaluateNewtonSteps(workspace, active);
+
+        // Jacobi sweep: every estimate moves against the old positions of the others,
+        // so the rows are independent
+        for (size_t i = 0; i < active; i++)
+        {
+            workspace.nextRe[i] = re[i];
+            workspace.nextIm[i] = im[i];
+            if (workspace.isConverged[i])
+                continue;
+
+            // sum of 1 / (z_i - z_j) over j != i
+            double sumRe = 0.0, sumIm = 0.0;
+            const auto accumulate = [&](size_t from, size_t to)
+            {
+                for (size_t j = from; j < to; j++)
+                {
+                    const double dRe = re[i] - re[j];
+                    const double dIm = im[i] - im[j];
+                    const double inv = 1.0 / (dRe * dRe + dIm * dIm);
+                    sumRe += dRe * inv;
+                    sumIm -= dIm * inv;
+                }
+            };
+            accumulate(0, i);
+            accumulate(i + 1, n);
+
+            const c128 newton(workspace.newtonRe[i], workspace.newtonIm[i]);
+            const c128 step = newton / (1.0 - newton * c128(sumRe, sumIm));
+            if (std::isfinite(step.real()) && std::isfinite(step.imag()))
+            {
+                workspace.nextRe[i] = re[i] - step.real();
+                workspace.nextIm[i] = im[i] - step.imag();
+            }
+        }
+        std::copy_n(workspace.nextRe.begin(), active, re.begin());
+        std::copy_n(workspace.nextIm.begin(), active, im.begin());
+
+        // converged estimates go behind the active ones and stay put
+        for (size_t i = 0; i < active;)
+        {
+            if (workspace.isConverged[i])
+            {
+                --active;
+                std::swap(re[i], re[active]);
+                std::swap(im[i], im[active]);
+                std::swap(workspace.isConverged[i], workspace.isConverged[active]);
+            }
+            else
+                ++i;
+        }
+    }
+
+    workspace.eigenvalues.resize(n);
+    for (size_t i = 0; i < n; i++)
+        workspace.eigenvalues[i] = c128(re[i], im[i]);
+    return active;
+}
+
+void CoefficientsToRoots::evaluateNewtonSteps(Workspace& workspace, size_t count)
+{
+    // Horner for p and p' over blocks of estimates, one lane each, so the inner loop vectorises.
+    // Outside the unit circle the reversed polynomial q(w) = w^n p(1/w) is evaluated at w = 1/z,
+    // then p/p' = z q / (n q - w q').
+    // The bound is Horner's rounding error scale, sum |a_k| |x|^k.
+    constexpr size_t lanes = 8;
+    const auto& a = workspace.poly;
+    const size_t n = a.size() - 1;
+    const double convergenceBound = 4.0 * std::sqrt(static_cast<double>(n)) * std::numeric_limits<double>::epsilon();
+
+    workspace.newtonRe.resize(count);
+    workspace.newtonIm.resize(count);
+    workspace.bound.resize(count);
+    workspace.isConverged.resize(count);
+
+    for (size_t start = 0; start < count; start += lanes)
+    {
+        const size_t width = std::min(lanes, count - start);
+        double xRe[lanes], xIm[lanes], xAbs[lanes], pRe[lanes], pIm[lanes], dRe[lanes], dIm[lanes], e[lanes];
+        bool isReversed[lanes];
+        for (size_t l = 0; l < lanes; l++)
+        {
+            const size_t i = start + std::min(l, width - 1); // spare lanes repeat the last estimate
+            const double zRe = workspace.re[i];
+            const double zIm = workspace.im[i];
+            const double magnitudeSquared = zRe * zRe + zIm * zIm;
+            isReversed[l] = magnitudeSquared > 1.0;
+            xRe[l] = isReversed[l] ? zRe / magnitudeSquared : zRe;
+            xIm[l] = isReversed[l] ? -zIm / magnitudeSquared : zIm;
+            xAbs[l] = std::sqrt(xRe[l] * xRe[l] + xIm[l] * xIm[l]);
+            pRe[l] = pIm[l] = dRe[l] = dIm[l] = e[l] = 0.0;
+        }
+
+        for (size_t k = 0; k <= n; k++)
+        {
+            const double forward = a[k];
+            const double reversed = a[n - k];
+            for (size_t l = 0; l < lanes; l++)
+            {
+                const double c = isReversed[l] ? reversed : forward;
+                const double nextDRe = dRe[l] * xRe[l] - dIm[l] * xIm[l] + pRe[l];
+                const double nextDIm = dRe[l] * xIm[l] + dIm[l] * xRe[l] + pIm[l];
+                const double nextPRe = pRe[l] * xRe[l] - pIm[l] * xIm[l] + c;
+                const double nextPIm = pRe[l] * xIm[l] + pIm[l] * xRe[l];
+                dRe[l] = nextDRe;
+                dIm[l] = nextDIm;
+                pRe[l] = nextPRe;
+                pIm[l] = nextPIm;
+                e[l] = e[l] * xAbs[l] + std::abs(c);
+            }
+        }
+
+        for (size_t l = 0; l < width; l++)
+        {
+            const size_t i = start + l;
+            const c128 p(pRe[l], pIm[l]);
+            const c128 d(dRe[l], dIm[l]);
+            const c128 newton = isReversed[l] ?
+                c128(workspace.re[i], workspace.im[i]) * p / (static_cast<double>(n) * p - c128(xRe[l], xIm[l]) * d) :
+                p / d;
+            workspace.newtonRe[i] = newton.real();
+            workspace.newtonIm[i] = newton.imag();
+            workspace.bound[i] = e[l];
+            workspace.isConverged[i] = std::abs(p) <= convergenceBound * e[l];
+        }
+    }
+}
+
+void CoefficientsToRoots::groupRoots(std::vector<std::pair<c128, int>> & roots, Workspace& workspace)
+{
+    PROFILE_FUNCTION();
+
+    const auto& estimates = workspace.eigenvalues;
+    const auto& a = workspace.poly;
+    const size_t n = estimates.size();
+
+    // The estimates together with their mirror images, so that the set is exactly symmetric about
+    // the real axis and every root shows up twice. Aberth doesn't keep the estimates symmetric.
+    // NOTE: the inclusion radius is doubled, for a root of full multiplicity the discs only touch.
+    const size_t count = 2 * n;
+    auto& re = workspace.re;
+    auto& im = workspace.im;
+    re.resize(count);
+    im.resize(count);
+    for (size_t i = 0; i < n; i++)
+    {
+        re[i] = re[n + i] = estimates[i].real();
+        im[i] = estimates[i].imag();
+        im[n + i] = -estimates[i].imag();
+    }
+    evaluateNewtonSteps(workspace, n);
+    auto& radius = workspace.bound;
+    for (size_t i = 0; i < n; i++)
+    {
+        radius[i] = 2.0 * static_cast<double>(n) * std::hypot(workspace.newtonRe[i], workspace.newtonIm[i]);
+        if (!std::isfinite(radius[i]))
+            radius[i] = std::numeric_limits<double>::max();
+    }
+    radius.resize(count);
+    std::copy_n(radius.begin(), n, radius.begin() + static_cast<std::ptrdiff_t>(n));
+
+    // connected groups of overlapping discs
+    auto& cluster = workspace.cluster;
+    cluster.resize(count);
+    for (size_t i = 0; i < count; i++)
+        cluster[i] = static_cast<int>(i);
+    const auto find = [&](size_t i)
+    {
+        while (cluster[i] != static_cast<int>(i))
+        {
+            cluster[i] = cluster[static_cast<size_t>(cluster[i])];
+            i = static_cast<size_t>(cluster[i]);
+        }
+        return i;
+    };
+    // Sweep over the discs by the left end of their extent on the real axis: the discs after i
+    // that start before i ends are the only ones it can overlap.
+    auto& byLeft = workspace.byLeft;
+    byLeft.resize(count);
+    for (size_t i = 0; i < count; i++)
+        byLeft[i] = static_cast<int>(i);
+    const auto left = [&](int i) { return re[static_cast<size_t>(i)] - radius[static_cast<size_t>(i)]; };
+    std::sort(byLeft.begin(), byLeft.end(), [&](int x, int y) { return left(x) < left(y); });
+    for (size_t s = 0; s < count; s++)
+    {
+        const auto i = static_cast<size_t>(byLeft[s]);
+        const double right = re[i] + radius[i];
+        for (size_t t = s + 1; t < count && left(byLeft[t]) <= right; t++)
+        {
+            const auto j = static_cast<size_t>(byLeft[t]);
+            const double dRe = re[i] - re[j];
+            const double dIm = im[i] - im[j];
+            const double reach = radius[i] + radius[j];
+            if (dRe * dRe + dIm * dIm <= reach * reach)
+            {
+                const auto ri = find(i), rj = find(j);
+                if (ri != rj)
+                    cluster[std::max(ri, rj)] = static_cast<int>(std::min(ri, rj));
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t>> groups(count);
+    for (size_t i = 0; i < count; i++)
+        groups[find(i)].push_back(i);
+
+    // A group symmetric about the real axis holds |group| / 2 roots, a real multiple root if it is one.
+    // Other groups come in mirrored pairs, the upper one holding |group| / 2 complex roots.
+    std::vector<c128> points;
+    for (size_t g = 0; g < count; g++)
+    {
+        const auto& members = groups[g];
+        if (members.empty())
+            continue;
+
+        c128 centroid(0.0, 0.0);
+        bool isSymmetric = false;
+        for (auto i : members)
+        {
+            centroid += c128(re[i], im[i]);
+            isSymmetric = isSymmetric || find(i < n ? i + n : i - n) == g;
+        }
+        centroid /= static_cast<double>(members.size());
+        if (!isSymmetric && centroid.imag() <= 0.0)
+            continue;
+
+        const size_t k = members.size() / 2;
+
+        if (members.size() % 2 == 0)
+        {
+            // the centroid of the estimates is only as good as they are, the test needs it polished
+            const auto root = polish(a, isSymmetric ? c128(centroid.real(), 0.0) : centroid, k);
+            if (k == 1 || isMultipleRoot(a, root, k))
+            {
+                roots.emplace_back(root, static_cast<int>(k));
+                continue;
+            }
+        }
+
+        // Not one root, so its members are the roots, moved to the upper half plane.
+        // Only ill-conditioned estimates get here, all this has to get right is the total order.
+        points.clear();
+        if (isSymmetric)
+        {
+            // The k estimates, matched up greedily, closest first: an estimate goes with the mirror of
+            // one from the other side into a complex root, or with its own mirror into a real one.
+            struct Match { double distance; size_t i, j; };
+            std::vector<Match> matches;
+            for (auto i : members)
+                if (i < n)
+                {
+                    matches.push_back({ 2.0 * std::abs(im[i]), i, i });
+                    if (im[i] > 0.0)
+                        for (auto j : members)
+                            if (j < n && im[j] < 0.0)
+                                matches.push_back({ std::hypot(re[i] - re[j], im[i] + im[j]), i, j });
+                }
+            std::sort(matches.begin(), matches.end(), [](const Match& x, const Match& y) { return x.distance < y.distance; });
+
+            auto& isMatched = workspace.isConverged;
+            isMatched.assign(n, false);
+            for (auto& match : matches)
+                if (!isMatched[match.i] && !isMatched[match.j])
+                {
+                    isMatched[match.i] = isMatched[match.j] = true;
+                    points.emplace_back(0.5 * (re[match.i] + re[match.j]), 0.5 * std::abs(im[match.i] - im[match.j]));
+                }
+        }
+        else
+        {
+            // the members hold the roots about twice, as estimates and as mirrors; estimates first
+            for (size_t p = 0; p < k; p++)
+                points.emplace_back(re[members[p]], std::abs(im[members[p]]));
+            if (members.size() % 2 != 0)
+                points.emplace_back(centroid.real(), 0.0);
+        }
+        for (auto& point : points)
+            roots.emplace_back(polish(a, point, 1), 1);
+    }
+}
+
+bool CoefficientsToRoots::isMultipleRoot(const std::vector<double>& a, c128 centre, size_t multiplicity)
+{
+    // p has a k-fold root at c when its Taylor coefficients t_j = p^(j)(c) / j! vanish for j < k. With rounded
+    // coefficients they only vanish up to the same expansion of the coefficients' magnitudes,
+    // sum_i |a_i| C(i, j) |c|^(i-j), which bounds how far rounding moves t_j.
+    // Repeated synthetic division gives both, t_j once j + 1 divisions are done.
+    const size_t n = a.size() - 1;
+    const double scale = 16.0 * static_cast<double>(n) * std::numeric_limits<double>::epsilon();
+    const double magnitude = std::abs(centre);
+    std::vector<c128> taylor(a.begin(), a.end());
+    std::vector<double> bound(n + 1);
+    for (size_t i = 0; i <= n; i++)
+        bound[i] = std::abs(a[i]);
+
+    for (size_t j = 0; j < multiplicity; j++)
+    {
+        for (size_t i = 1; i + j <= n; i++)
+        {
+            taylor[i] += taylor[i - 1] * centre;
+            bound[i] += bound[i - 1] * magnitude;
+        }
+        if (!(std::abs(taylor[n - j]) <= scale * bound[n - j]))
+            return false;
+    }
+    return true;
+}
+
+c128 CoefficientsToRoots::polish(const std::vector<double>& a, c128 root, size_t multiplicity)
+{
+    // Newton on p^(k-1), for which a k-fold root of p is simple
+    const size_t n = a.size() - 1;
+    if (multiplicity > n)
+        return root;
+    const size_t m = n - (multiplicity - 1);
+    std::vector<double> b(m + 1);
+    for (size_t j = 0; j <= m; j++)
+    {
+        // d^(k-1)/dz^(k-1) z^(n-j) = (n-j)! / (n-j-k+1)! z^(n-j-k+1)
+        double factor = 1.0;
+        for (size_t f = 0; f + 1 < multiplicity; f++)
+            factor *= static_cast<double>(n - j - f);
+        b[j] = a[j] * factor;
+    }
+
+    const auto evaluate = [&](c128 x, c128& value, c128& derivative)
+    {
+        value = derivative = c128(0.0, 0.0);
+        for (double c : b)
+        {
+            derivative = derivative * x + value;
+            value = value * x + c;
+        }
+    };
+
+    c128 value, derivative;
+    evaluate(root, value, derivative);
+    for (int iter = 0; iter < 3; iter++)
+    {
+        const c128 candidate = root - value / derivative;
+        c128 candidateValue, candidateDerivative;
+        evaluate(candidate, candidateValue, candidateDerivative);
+        if (!std::isfinite(std::abs(candidateValue)) || !(std::abs(candidateValue) < std::abs(value)))
+            break;
+        root = candidate;
+        value = candidateValue;
+        derivative = candidateDerivative;
+    }
+    return root;
+}
+
+const std::vector<double>* CoefficientsToRoots::monicOf(const std::vector<double>& coefs, std::vector<double>& scratch)
+{
+    size_t first = 0;
+    while (first < coefs.size() && coefs[first] == 0.0)
+        first++;
+    if (first == coefs.size())
+        return nullptr;
+    if (coefs[first] == 1.0)
+        return &coefs;
+
+    // NOTE: each solver calls this once, on its input, so coefs is never scratch
+    jassert(&coefs != &scratch);
+    const double lead = coefs[first];
+    scratch.assign(coefs.begin() + static_cast<std::ptrdiff_t>(first), coefs.end());
+    for (auto& c : scratch)
+        c /= lead;
+    scratch[0] = 1.0;
+    return &scratch;
+}
+
+size_t CoefficientsToRoots::preprocess(std::vector<std::pair<c128, int>> & roots, const std::vector<double>& coefs, size_t& orderAtZero)
+{
     // filter out leading zeros, increasing counter until the leading 1.0 is found.
     size_t degree = 0;
     while( degree < coefs.size() && coefs[degree] != 1.0)
@@ -18,7 +685,7 @@ std::vector<std::pair<c128, int>> CoefficientsToRoots::QR(std::vector<double> co
     degree = coefs.size() - degree -1; // subtract 1 for the leading 1.0
 
    // filter out trailing zeros increasing the order of root at Zero (usually for default poles)
-    size_t orderAtZero = 0;
+    orderAtZero = 0;
     for( int i = static_cast<int>(coefs.size()-1); i >= 0 && std::abs(coefs[(size_t)i]) == 0.0 ; --i)
     {
         ++orderAtZero;
@@ -26,20 +693,274 @@ std::vector<std::pair<c128, int>> CoefficientsToRoots::QR(std::vector<double> co
     }
 
     // append root at zero of "orderAtZero" order
-    std::vector<std::pair<c128, int>> roots;
     if (orderAtZero>0)
         roots.emplace_back(std::make_pair(0.0, orderAtZero));
 
-    if (degree == 0 )
-        // Returing root at (0,0) if any
-        return roots;
-
     if (degree==1)
+        // 1 non-zero root + root at (0,0) if any
+        roots.emplace_back( std::make_pair(static_cast<c128>(-coefs[coefs.size() - 1 - orderAtZero]), 1) );
+
+    return degree;
+}
+
+void CoefficientsToRoots::balance(std::vector<double>& H, size_t degree)
+{
+    // Parlett-Reinsch: scale row/column i by a power of 2 until their off-diagonal norms are within
+    // a factor of 2 of each other. Powers of 2 keep it exact, and a diagonal similarity keeps the
+    // Hessenberg form.
+    constexpr double radix = 2.0;
+    constexpr double radixSquared = radix * radix;
+
+    bool isDone = false;
+    while (!isDone)
     {
-        // Returing 1 non-zero root + root at (0,0) if any
-        roots.emplace_back( std::make_pair(static_cast<c128>(-coefs[coefs.size() - 1]), 1) );
-        return roots;
+        isDone = true;
+        for (size_t i = 0; i < degree; ++i)
+        {
+            double c = 0.0, r = 0.0;
+            for (size_t j = 0; j < degree; ++j)
+                if (j != i)
+                {
+                    c += std::abs(H[j * degree + i]);
+                    r += std::abs(H[i * degree + j]);
+                }
+            if (c == 0.0 || r == 0.0)
+                continue;
+
+            const double s = c + r;
+            double f = 1.0;
+            double g = r / radix;
+            while (c < g)
+            {
+                f *= radix;
+                c *= radixSquared;
+            }
+            g = r * radix;
+            while (c > g)
+            {
+                f /= radix;
+                c /= radixSquared;
+            }
+
+            if ((c + r) / f < 0.95 * s)
+            {
+                isDone = false;
+                const double fInv = 1.0 / f;
+                for (size_t j = 0; j < degree; ++j)
+                    H[i * degree + j] *= fInv;
+                for (size_t j = 0; j < degree; ++j)
+                    H[j * degree + i] *= f;
+            }
+        }
+    }
+}
+
+void CoefficientsToRoots::hessenbergEigenvalues(std::vector<double>& H, size_t degree, std::vector<c128>& eigenvalues)
+{
+    PROFILE_FUNCTION();
+
+    // NOTE: this is the EISPACK hqr scheme. Indices are signed as the bulge chase
+    // looks one row above the active block.
+    const int n = static_cast<int>(degree);
+    auto a = [&](int row, int col) -> double& { return H[static_cast<size_t>(row) * degree + static_cast<size_t>(col)]; };
+    const auto sign = [](double magnitude, double s) { return s >= 0.0 ? std::abs(magnitude) : -std::abs(magnitude); };
+    constexpr double eps = std::numeric_limits<double>::epsilon();
+
+    eigenvalues.assign(degree, c128(0.0, 0.0));
+
+    double norm = 0.0;
+    for (int i = 0; i < n; i++)
+        for (int j = std::max(i - 1, 0); j < n; j++)
+            norm += std::abs(a(i, j));
+
+    int nn = n - 1;
+    double t = 0.0; // accumulated exceptional shifts
+    while (nn >= 0)
+    {
+        size_t iter = 0;
+        int l;
+        do
+        {
+            // look for a single small subdiagonal element
+            for (l = nn; l > 0; l--)
+            {
+                double s = std::abs(a(l - 1, l - 1)) + std::abs(a(l, l));
+                if (s == 0.0)
+                    s = norm;
+                if (std::abs(a(l, l - 1)) <= eps * s)
+                {
+                    a(l, l - 1) = 0.0;
+                    break;
+                }
+            }
+
+            double x = a(nn, nn);
+            if (l == nn)
+            {
+                // one root found
+                eigenvalues[static_cast<size_t>(nn--)] = c128(x + t, 0.0);
+                continue;
+            }
+
+            double y = a(nn - 1, nn - 1);
+            double w = a(nn, nn - 1) * a(nn - 1, nn);
+            if (l == nn - 1)
+            {
+                // two roots found
+                const double p = 0.5 * (y - x);
+                const double q = p * p + w;
+                double z = std::sqrt(std::abs(q));
+                x += t;
+                if (q >= 0.0)
+                {
+                    // real pair
+                    z = p + sign(z, p);
+                    eigenvalues[static_cast<size_t>(nn - 1)] = eigenvalues[static_cast<size_t>(nn)] = c128(x + z, 0.0);
+                    if (z != 0.0)
+                        eigenvalues[static_cast<size_t>(nn)] = c128(x - w / z, 0.0);
+                }
+                else
+                {
+                    // complex pair
+                    eigenvalues[static_cast<size_t>(nn - 1)] = c128(x + p, z);
+                    eigenvalues[static_cast<size_t>(nn)] = c128(x + p, -z);
+                }
+                nn -= 2;
+                continue;
+            }
+
+            if (iter == MaxIterations)
+            {
+                // NOTE: no convergence, the remaining diagonal is the best estimate there is
+                DBG("CoefficientsToRoots::QR did not converge, " << nn + 1 << " roots left");
+                for (int i = nn; i >= 0; i--)
+                    eigenvalues[static_cast<size_t>(i)] = c128(a(i, i) + t, 0.0);
+                nn = -1;
+                break;
+            }
+            if (iter > 0 && iter % 10 == 0)
+            {
+                // exceptional shift
+                t += x;
+                for (int i = 0; i <= nn; i++)
+                    a(i, i) -= x;
+                const double s = std::abs(a(nn, nn - 1)) + std::abs(a(nn - 1, nn - 2));
+                y = x = 0.75 * s;
+                w = -0.4375 * s * s;
+            }
+            ++iter;
+
+            // form the shift and look for 2 consecutive small subdiagonal elements
+            int m;
+            double p = 0.0, q = 0.0, r = 0.0, z;
+            for (m = nn - 2; m >= l; m--)
+            {
+                z = a(m, m);
+                r = x - z;
+                double s = y - z;
+                p = (r * s - w) / a(m + 1, m) + a(m, m + 1);
+                q = a(m + 1, m + 1) - z - r - s;
+                r = a(m + 2, m + 1);
+                s = std::abs(p) + std::abs(q) + std::abs(r);
+                p /= s;
+                q /= s;
+                r /= s;
+                if (m == l)
+                    break;
+                const double u = std::abs(a(m, m - 1)) * (std::abs(q) + std::abs(r));
+                const double v = std::abs(p) * (std::abs(a(m - 1, m - 1)) + std::abs(z) + std::abs(a(m + 1, m + 1)));
+                if (u <= eps * v)
+                    break;
+            }
+            for (int i = m; i < nn - 1; i++)
+            {
+                a(i + 2, i) = 0.0;
+                if (i != m)
+                    a(i + 2, i - 1) = 0.0;
+            }
+
+            // double QR step on rows l..nn and columns m..nn, chasing the bulge
+            for (int k = m; k < nn; k++)
+            {
+                if (k != m)
+                {
+                    p = a(k, k - 1);
+                    q = a(k + 1, k - 1);
+                    r = 0.0;
+                    if (k + 1 != nn)
+                        r = a(k + 2, k - 1);
+                    if ((x = std::abs(p) + std::abs(q) + std::abs(r)) != 0.0)
+                    {
+                        p /= x;
+                        q /= x;
+                        r /= x;
+                    }
+                }
+
+                const double s = sign(std::sqrt(p * p + q * q + r * r), p);
+                if (s == 0.0)
+                    continue;
+
+                if (k == m)
+                {
+                    if (l != m)
+                        a(k, k - 1) = -a(k, k - 1);
+                }
+                else
+                    a(k, k - 1) = -s * x;
+                p += s;
+                x = p / s;
+                y = q / s;
+                z = r / s;
+                q /= p;
+                r /= p;
+
+                // row modification
+                for (int j = k; j <= nn; j++)
+                {
+                    p = a(k, j) + q * a(k + 1, j);
+                    if (k + 1 != nn)
+                    {
+                        p += r * a(k + 2, j);
+                        a(k + 2, j) -= p * z;
+                    }
+                    a(k + 1, j) -= p * y;
+                    a(k, j) -= p * x;
+                }
+
+                // column modification
+                const int mmin = nn < k + 3 ? nn : k + 3;
+                for (int i = l; i <= mmin; i++)
+                {
+                    p = x * a(i, k) + y * a(i, k + 1);
+                    if (k + 1 != nn)
+                    {
+                        p += z * a(i, k + 2);
+                        a(i, k + 2) -= p * r;
+                    }
+                    a(i, k + 1) -= p * q;
+                    a(i, k) -= p;
+                }
+            }
+        } while (l + 1 < nn);
     }
+}
+
+std::vector<std::pair<c128, int>> CoefficientsToRoots::QRGramSchmidt(std::vector<double> input)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<std::pair<c128, int>> roots;
+    std::vector<double> scratch;
+    const auto* monic = monicOf(input, scratch);
+    if (monic == nullptr)
+        return roots;
+    const auto& coefs = *monic;
+
+    size_t orderAtZero = 0;
+    const size_t degree = preprocess(roots, coefs, orderAtZero);
+    if (degree <= 1)
+        return roots;
 
     // build companion Matrix
     std::vector<double> A(degree * degree, 0.0);
@@ -174,23 +1095,20 @@ std::vector<std::pair<c128, int>> CoefficientsToRoots::QR(std::vector<double> co
     return roots;
 }
 
-void CoefficientsToRoots::extractRoots(std::vector<std::pair<c128, int>> & roots, const std::vector<double>& M, size_t degree)
+void CoefficientsToRoots::addRoot(std::vector<std::pair<c128, int>> & roots, c128 newVal)
 {
-    PROFILE_FUNCTION();
-
-    auto addRoot = [&](c128 newVal) {
-        for (auto& [val, order] : roots)
-        {
+    for (auto& [val, order] : roots)
+    {
 #if 0
-            double diff_re = std::abs(val.real() - newVal.real());
-            double diff_im = std::abs(val.imag() - newVal.imag());
-            double scale = std::abs(val) + std::abs(newVal) + 1e-7; // + 1e-7 to avoid division with zero
+        double diff_re = std::abs(val.real() - newVal.real());
+        double diff_im = std::abs(val.imag() - newVal.imag());
+        double scale = std::abs(val) + std::abs(newVal) + 1e-7; // + 1e-7 to avoid division with zero
 	    if (diff_re / scale < tolerance && diff_im / scale < tolerance)
-            {
-                order++;
-                val += (newVal - val) / static_cast<double>(order);
-                return;
-            }
+        {
+            order++;
+            val += (newVal - val) / static_cast<double>(order);
+            return;
+        }
 #else
 	    if ((juce::exactlyEqual(val.imag(), 0.0)) != (juce::exactlyEqual(newVal.imag(), 0.0)))
 	    {
@@ -231,9 +1149,13 @@ void CoefficientsToRoots::extractRoots(std::vector<std::pair<c128, int>> & roots
 	      }
 	    }
 #endif
-        }
-        roots.emplace_back(newVal, 1);
-    };
+    }
+    roots.emplace_back(newVal, 1);
+}
+
+void CoefficientsToRoots::extractRoots(std::vector<std::pair<c128, int>> & roots, const std::vector<double>& M, size_t degree)
+{
+    PROFILE_FUNCTION();
 
     size_t i = 0;
     while (i < degree)
@@ -243,7 +1165,7 @@ void CoefficientsToRoots::extractRoots(std::vector<std::pair<c128, int>> & roots
         {
             // Real eigenvalue on diagonal
             c128 newRoot (M[i * degree + i], 0.0);
-            addRoot(newRoot);
+            addRoot(roots, newRoot);
             ++i;
         }
         else
@@ -271,16 +1193,16 @@ void CoefficientsToRoots::extractRoots(std::vector<std::pair<c128, int>> & roots
             if ( discriminant >= 0.0)
             {
                 // tow real roots
-                addRoot(c128(halfSum + halfSqrt, 0.0));
-                addRoot(c128(halfSum - halfSqrt, 0.0));
+                addRoot(roots, c128(halfSum + halfSqrt, 0.0));
+                addRoot(roots, c128(halfSum - halfSqrt, 0.0));
             }
             else
             {
                 // Complex conjugate pair
                 const double re = halfSum;
                 const double im = halfSqrt;
-                addRoot(c128(re,im));
-                // addRoot(c128(re,-im)); // Note: this is added automatically later using FilterState::add method. Commenting this, removes the bug of overlapping roots.
+                addRoot(roots, c128(re,im));
+                // addRoot(roots, c128(re,-im)); // Note: this is added automatically later using FilterState::add method. Commenting this, removes the bug of overlapping roots.
             }
             i += 2;
         }
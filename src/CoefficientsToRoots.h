@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FilterState.h"
+#include "WorkerPool.h"
 #include <vector>
 #include <utility>
 
@@ -11,28 +12,87 @@ class CoefficientsToRoots
 	*/
 
 	public:
+		/*	Scratch memory for the solvers. Keeping one around between calls means repeated solves
+			(e.g. while editing coefficients) don't allocate once it has grown to the largest degree seen. */
+		struct Workspace
+		{
+			std::vector<double> H;			// balanced companion matrix, degree x degree, row-major
+			std::vector<c128> eigenvalues;	// root estimates, one per degree, conjugates included
+			std::vector<double> poly;		// the monic polynomial left after preprocess, highest power first
+			std::vector<double> monic;		// the input divided by its leading coefficient, when it wasn't 1.0 already
+
+			// Aberth iteration, one entry per estimate (structure of arrays so the Horner loop vectorises)
+			std::vector<double> re, im, nextRe, nextIm, newtonRe, newtonIm, bound;	// bound doubles as the inclusion radii
+			std::vector<char> isConverged;
+
+			// Newton polygon of the initial estimates, then the groups for multiplicity detection
+			std::vector<int> cluster;
+			std::vector<int> byLeft;	// the inclusion discs in order of their leftmost point
+		};
+
 		/*	Method used to convert polynomial coefficients into roots using a QR method.
 			Consists of the following steps:
 				- Preprocessing:
 					- Filter out leading zeros if any
 					- Filter out trailing zeros if any
 					- Build companion matrix of Hessenberg form from given coefficients
-					- Calculate rayleigh quotient shift 
-				- apply shifted QR iterations (starting from bottom right) with deflation when subdiagonal entries become ~0
-						- Step 1 calculate Q0 via Gram Schmidt orthogonalization method
-						- Step 2 calculate R0 :  R0 = Q0 A0
-						- Step 3 calculate A1 : A1 = R0 Q0
-						- Step 4 add shift back in A1 and check sub-diagonal entries for deflation
-				- Extract eigenvalues:
-					- merge roots that have smaller scaled difference than tolerance
-					- scan subdiagonal:
-						- if values on the subdiagonal smaller than Epsilon, then real root
-						- else 2 solutions. Solve det(A - λI) = 0 for 2x2 square matrix:
-							- if discriminant >= 0, then two real solutions
-							- else then root has a complex conjugate (conjugate is not appended on returned vector, as this is done automatically when using FilterState::add to add that root in the Value tree)
+					- Balance it (diagonal similarity with powers of 2), which leaves the eigenvalues exact but
+					  evens out row and column norms, so roundoff is relative to a much smaller matrix norm
+				- apply Francis double-shift QR iterations on the Hessenberg matrix (starting from bottom right):
+						- the two shifts are the eigenvalues of the trailing 2x2 block, applied implicitly
+						  by chasing a 3x3 Householder bulge down the subdiagonal, so real arithmetic finds complex pairs
+						- O(degree^2) per iteration instead of forming Q and R
+						- deflate when subdiagonal entries become ~0, exceptional shifts every 10 iterations
+				- Group the eigenvalues into roots with multiplicities, see groupRoots
+					- complex conjugates are not appended on returned vector, as this is done automatically when using FilterState::add to add that root in the Value tree
 			Returns complex roots paired with their corresponding order.
 		 */
 		static std::vector<std::pair<c128, int>> QR(std::vector<double> coefs);
+		static std::vector<std::pair<c128, int>> QR(const std::vector<double>& coefs, Workspace& workspace);
+
+		/*	Method used to convert polynomial coefficients into roots by Aberth-Ehrlich iteration.
+				- Start from estimates on circles given by the Newton polygon of the coefficients
+				- Each sweep evaluates p and p' at all estimates at once (Horner, on the reversed polynomial
+				  where |z| > 1 so nothing overflows) and moves every estimate by its Newton step corrected
+				  for the repulsion of all the other estimates: O(degree^2) per sweep, every estimate independent
+				- An estimate stops once |p| is down to the rounding error of evaluating it
+				- Group the estimates into roots with multiplicities, see groupRoots
+			Falls back to QR if an estimate runs off to infinity.
+			Same return format as QR.
+		 */
+		static std::vector<std::pair<c128, int>> Aberth(std::vector<double> coefs);
+		static std::vector<std::pair<c128, int>> Aberth(const std::vector<double>& coefs, Workspace& workspace);
+
+		/*	QR below aberthMinDegree, where it is the more robust of the two, Aberth from there on. */
+		static std::vector<std::pair<c128, int>> solve(std::vector<double> coefs);
+		static std::vector<std::pair<c128, int>> solve(const std::vector<double>& coefs, Workspace& workspace);
+
+		/*	Warm start for small edits of a polynomial whose roots are already known, e.g. one coefficient
+			changed in the table: Aberth sweeps starting from the given roots instead of the Newton polygon.
+				- guesses are in the return format, conjugates implied; a k-fold guess starts as k estimates
+				  on a small circle around it, since a perturbed multiple root splits up
+				- usually done in a few sweeps, as every estimate starts next to its root
+			Falls back to solve when the guesses don't add up to the degree or haven't all converged
+			after MaxRefineIterations sweeps.
+			Same return format as QR.
+		 */
+		static std::vector<std::pair<c128, int>> refine(const std::vector<double>& coefs, const std::vector<std::pair<c128, int>>& guesses);
+		static std::vector<std::pair<c128, int>> refine(const std::vector<double>& coefs, const std::vector<std::pair<c128, int>>& guesses, Workspace& workspace);
+
+		/*	Many polynomials at once, each solved like solve, spread over the workers of the pool.
+				- coefs holds `count` polynomials one after the other, `length` coefficients each, highest
+				  power first; shorter ones are padded with leading zeros
+				- they needn't be monic, each is divided by its leading coefficient first
+				- every worker keeps one Workspace for all the polynomials it takes
+			results[i] always belongs to polynomial i, whichever worker solved it, so the output doesn't
+			depend on the number of workers or the scheduling. An all-zero polynomial has no roots.
+		 */
+		static std::vector<std::vector<std::pair<c128, int>>> solveBatch(const double* coefs, size_t count, size_t length, WorkerPool& pool, int maxWorkers = 0);
+
+		/*	The original single-shift QR: rebuilds full Q and R with classical Gram-Schmidt
+			and two dense degree x degree products every iteration, O(degree^3) per step.
+			Kept as the reference QR is benchmarked and tested against. */
+		static std::vector<std::pair<c128, int>> QRGramSchmidt(std::vector<double> coefs);
 	private:
 
 		// TODO Finetune these parameters
@@ -44,8 +104,82 @@ class CoefficientsToRoots
 	    static constexpr size_t MaxIterations = 100;
 
 		/* 	Threshold for considering two roots with negligible diff the same. 
-			Expressed in % after scaling differences, since zeros may lie outside the unit circle. */
+			Expressed in % after scaling differences, since zeros may lie outside the unit circle.
+			Only QRGramSchmidt merges by it, the other solvers group by inclusion discs. */
 		static constexpr double tolerance = 5e-2; 
+
+		/*	The solvers take any leading coefficient, edited in the table or not: returns coefs itself if its first
+			non-zero coefficient is exactly 1.0, otherwise coefs divided by it in scratch. nullptr if coefs is empty
+			or all zeros, which has no roots. */
+		static const std::vector<double>* monicOf(const std::vector<double>& coefs, std::vector<double>& scratch);
+
+		/*	Strips leading and trailing zeros and appends the root at zero, if any.
+			Takes a polynomial from monicOf, whose leading coefficient is exactly 1.0.
+			Returns the degree left; when it is 1 the remaining root is appended too. */
+		static size_t preprocess(std::vector<std::pair<c128, int>> &, const std::vector<double>&, size_t& orderAtZero);
+
+		/*	The solvers past monicOf and preprocess, for a degree above 1: append the roots of coefs without its
+			orderAtZero trailing zeros to those preprocess left. solve picks QR or Aberth by the degree. */
+		static void QR(std::vector<std::pair<c128, int>> &, const std::vector<double>& coefs, size_t degree, size_t orderAtZero, Workspace&);
+		static void Aberth(std::vector<std::pair<c128, int>> &, const std::vector<double>& coefs, size_t degree, size_t orderAtZero, Workspace&);
+		static void solve(std::vector<std::pair<c128, int>> &, const std::vector<double>& coefs, size_t degree, size_t orderAtZero, Workspace&);
+
+		/*	Balances the companion matrix in place, see QR */
+		static void balance(std::vector<double>& H, size_t degree);
+
+		/*	Francis double-shift QR on an upper Hessenberg matrix, which it destroys. */
+		static void hessenbergEigenvalues(std::vector<double>& H, size_t degree, std::vector<c128>& eigenvalues);
+
+		/*	Degree from which solve uses Aberth */
+		static constexpr size_t aberthMinDegree = 64;
+
+		/*	Maximum Aberth sweeps, estimates still moving after that are grouped as they are */
+		static constexpr size_t MaxAberthIterations = 500;
+
+		/*	Maximum sweeps of refine before it gives up on the guesses */
+		static constexpr size_t MaxRefineIterations = 30;
+
+		/*	Radius of the circle the copies of a multiple guess start on, relative to its magnitude (at least 1) */
+		static constexpr double refineSpread = 1e-3;
+
+		/*	Copies the monic polynomial left after preprocess into the workspace */
+		static void setPolynomial(Workspace&, const std::vector<double>&, size_t degree, size_t orderAtZero);
+
+		/*	Aberth iteration from scratch, leaves the estimates in workspace.eigenvalues.
+			Returns false if an estimate ran off to infinity. */
+		static bool aberthEstimates(Workspace&);
+
+		/*	Places the estimates of refine in workspace.re/im, skipping guesses at zero that preprocess
+			already took out. Returns false if they don't make up the degree. */
+		static bool warmStart(Workspace&, const std::vector<std::pair<c128, int>>& guesses, size_t orderAtZero);
+
+		/*	Aberth sweeps from the estimates in workspace.re/im until they have all converged or maxIterations
+			is reached, then leaves them in workspace.eigenvalues. Returns the number still moving. */
+		static size_t aberthIterate(Workspace&, size_t maxIterations);
+
+		/*	Newton step p/p' and the rounding error bound of p at each of the first `count` estimates in
+			workspace.re/im; marks the estimates whose |p| is within the bound as converged. */
+		static void evaluateNewtonSteps(Workspace&, size_t count);
+
+		/*	Turns the estimates in workspace.eigenvalues into roots with multiplicities, appended to roots:
+				- every estimate z gets its inclusion disc, radius degree * |p(z)/p'(z)|, which holds a root,
+				  and so does its mirror image conj(z)
+				- connected groups of overlapping discs hold as many roots as they have discs; a group
+				  is taken as one multiple root at its centroid if the polynomial has one there up to
+				  rounding (see isMultipleRoot), otherwise as separate roots
+				- groups symmetric about the real axis give real roots
+				- each root is polished by Newton on the (k-1)th derivative, where a k-fold root is simple
+			The orders always add up to the degree. */
+		static void groupRoots(std::vector<std::pair<c128, int>> &, Workspace&);
+
+		/*	Whether the polynomial has a root of the given multiplicity at centre, up to rounding of its coefficients */
+		static bool isMultipleRoot(const std::vector<double>& poly, c128 centre, size_t multiplicity);
+
+		/*	Newton steps on the (multiplicity-1)th derivative of the polynomial, kept only while they reduce it */
+		static c128 polish(const std::vector<double>& poly, c128 root, size_t multiplicity);
+
+		/*	Adds a root to the list, merging it with an existing root when they are within tolerance */
+		static void addRoot(std::vector<std::pair<c128, int>> &, c128);
 		
 		/*	Extracts roots from the eigenvalues of the converged quasi-triangular QR matrix and merges duplicates. 
 			For more details see description of QR method */
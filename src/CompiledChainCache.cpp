@@ -0,0 +1,128 @@
+#include "CompiledChainCache.h"
+
+CompiledChainCache::CompiledChainCache(std::size_t maxEntries)
+	: capacity(std::max<std::size_t>(1, maxEntries))
+{
+}
+
+CompiledChain::Ptr CompiledChainCache::getOrCompile(
+	FilterState* state,
+	const ChainCompileOptions& options)
+{
+	auto key = makeKey(state, options);
+	const auto hash = hashKey(key);
+
+	const juce::ScopedLock scopedLock(lock);
+	auto found = index.find(hash);
+	if (found != index.end())
+	{
+		if (found->second->key == key)
+		{
+			hits.fetch_add(1, std::memory_order_relaxed);
+			entries.splice(entries.begin(), entries, found->second);
+			return entries.front().chain;
+		}
+
+		// NOTE: a hash collision, the newer state takes the slot
+		entries.erase(found->second);
+		index.erase(found);
+	}
+
+	misses.fetch_add(1, std::memory_order_relaxed);
+	auto chain = ProcessorChainModifier::compile(state, options);
+
+	if (entries.size() >= capacity)
+	{
+		index.erase(entries.back().hash);
+		entries.pop_back();
+	}
+	entries.push_front({ hash, std::move(key), chain });
+	index[hash] = entries.begin();
+	return chain;
+}
+
+void CompiledChainCache::clear()
+{
+	const juce::ScopedLock scopedLock(lock);
+	entries.clear();
+	index.clear();
+}
+
+std::size_t CompiledChainCache::size() const
+{
+	const juce::ScopedLock scopedLock(lock);
+	return entries.size();
+}
+
+double CompiledChainCache::getHitRate() const
+{
+	const auto hitCount = getHits();
+	const auto lookups = hitCount + getMisses();
+	return lookups == 0 ? 0.0 : static_cast<double>(hitCount) / static_cast<double>(lookups);
+}
+
+std::vector<double> CompiledChainCache::makeKey(
+	FilterState* state,
+	const ChainCompileOptions& options)
+{
+	struct RootKey
+	{
+		double order, re, im;
+		bool operator<(const RootKey& other) const
+		{
+			return std::tie(order, re, im) < std::tie(other.order, other.re, other.im);
+		}
+	};
+
+	// NOTE: adding 0.0 turns -0.0 into 0.0, they must not make different keys
+	std::vector<RootKey> roots;
+	roots.reserve(static_cast<std::size_t>(state->poles.size() + state->zeros.size()));
+	for (auto* rootArray : { &state->poles, &state->zeros })
+		for (auto* root : *rootArray)
+			if (root->order.get() != 0)
+				roots.push_back({
+					static_cast<double>(root->order.get()),
+					root->value.re.get() + 0.0,
+					root->value.im.get() + 0.0 });
+	std::sort(roots.begin(), roots.end());
+
+	std::vector<double> key;
+	key.reserve(4 + 3 * roots.size());
+	key.push_back(static_cast<double>(options.pairing));
+	key.push_back(static_cast<double>(options.ordering));
+	key.push_back(static_cast<double>(options.scaling));
+	key.push_back(state->gain.get() + 0.0);
+	for (auto& root : roots)
+	{
+		key.push_back(root.order);
+		key.push_back(root.re);
+		key.push_back(root.im);
+	}
+	return key;
+}
+
+juce::uint64 CompiledChainCache::hashKey(const std::vector<double>& key)
+{
+	// 64-bit FNV-1a over the bit patterns
+	juce::uint64 hash = 14695981039346656037ull;
+	for (double value : key)
+	{
+		juce::uint64 bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		for (int i = 0; i < 8; i++)
+		{
+			hash ^= (bits >> (8 * i)) & 0xff;
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 8 */
+/* c-basic-offset: 8 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,68 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include "ProcessorChainModifier.h"
+
+/** Keeps the most recently compiled chains, so that going back to a state
+ * that was already compiled (undo/redo, A/B switching, preset recall) costs
+ * a lookup instead of a compile.
+ * Chains are keyed by a canonical description of the roots, the gain and the
+ * compile options: the same transfer function hits the cache however its
+ * roots happen to be ordered in the value tree.
+ */
+class CompiledChainCache
+{
+public:
+	explicit CompiledChainCache(std::size_t maxEntries = defaultCapacity);
+
+	/** Returns the cached chain for the state, compiling and caching it on a miss.
+	 * Evicts the least recently used chain when full.
+	 */
+	CompiledChain::Ptr getOrCompile(
+		FilterState* state,
+		const ChainCompileOptions& options);
+
+	void clear();
+
+	std::size_t size() const;
+	juce::uint64 getHits() const { return hits.load(std::memory_order_relaxed); }
+	juce::uint64 getMisses() const { return misses.load(std::memory_order_relaxed); }
+	/** hits / lookups, 0 before the first lookup */
+	double getHitRate() const;
+
+	/** the canonical description: options, gain, then every root with a
+	 * nonzero order as (order, re, im), sorted
+	 */
+	static std::vector<double> makeKey(
+		FilterState* state,
+		const ChainCompileOptions& options);
+	static juce::uint64 hashKey(const std::vector<double>& key);
+
+private:
+	struct Entry
+	{
+		juce::uint64 hash;
+		std::vector<double> key;
+		CompiledChain::Ptr chain;
+	};
+
+	const std::size_t capacity;
+	std::list<Entry> entries;   // most recently used first
+	std::unordered_map<juce::uint64, std::list<Entry>::iterator> index;
+	mutable juce::CriticalSection lock;
+	std::atomic<juce::uint64> hits{ 0 };
+	std::atomic<juce::uint64> misses{ 0 };
+
+	static constexpr std::size_t defaultCapacity = 64;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CompiledChainCache)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 8 */
+/* c-basic-offset: 8 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
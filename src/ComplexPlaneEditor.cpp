@@ -399,6 +399,7 @@ ComplexPlaneEditor(AudioPluginAudioProcessor *p)
   ,defaultInteractionButton("def")
   ,constantMagnitudeInteractionButton("mag")
   ,constantAngleInteractionButton("arg")
+  ,heatMapButton("|H|")
 {
   processor->filterState->addListener(this);
 
@@ -448,6 +449,11 @@ ComplexPlaneEditor(AudioPluginAudioProcessor *p)
 
   defaultInteractionButton.setToggleState(true, juce::sendNotification);
 
+  heatMapButton.setClickingTogglesState(true);
+  heatMapButton.setTooltip("Colour the plane by the magnitude of the transfer function");
+  heatMapButton.onClick = [this](){ repaint(); };
+  addAndMakeVisible(heatMapButton);
+
   processor->filterState->syncListener(this);
 }
 
@@ -594,6 +600,9 @@ resized(void)
     constantAngleInteractionButton.setBounds(area.removeFromLeft(thirdWidth));
   }
 
+  heatMapButton.setBounds(getWidth() - heatMapButtonWidth - heatMapButtonPadding, heatMapButtonPadding,
+			  heatMapButtonWidth, heatMapButtonHeight);
+
   updateTransformsAndChildBounds();
 }
 
@@ -632,6 +641,27 @@ paint(juce::Graphics &g)
   worldUnitsFromPixels.transformPoint(leftWorld, topWorld);
   worldUnitsFromPixels.transformPoint(rightWorld, bottomWorld);
 
+  // NOTE: draw |H(z)| under the grid
+  if(heatMapButton.getToggleState())
+  {
+    PROFILE_SCOPE("draw heat map");
+
+    auto const *state = processor->filterState.get();
+    RootSnapshot snapshot;
+    snapshot.capture(*state);
+    transferFunctionMap.update(snapshot, state->gain.get(), unitsPerPixel,
+			       leftWorld, rightWorld, bottomWorld, topWorld, &heatMapPool.get());
+
+    auto const tileUnits = transferFunctionMap.getTileUnits();
+    for(auto const *tile : transferFunctionMap.getVisibleTiles())
+    {
+      auto tileX = tile->column * tileUnits;
+      auto tileY = -tile->row * tileUnits;
+      pixelsFromWorldUnits.transformPoint(tileX, tileY);
+      g.drawImageAt(tile->image, int(std::round(tileX)), int(std::round(tileY)));
+    }
+  }
+
   {
     PROFILE_SCOPE("draw lines");
 
@@ -815,6 +845,15 @@ updateTransformsAndChildBounds(void)
   }
 }
 
+void ComplexPlaneEditor::
+valueTreePropertyChanged(juce::ValueTree &node, const juce::Identifier &property)
+{
+  juce::ignoreUnused(node, property);
+
+  // NOTE: the points repaint themselves, the overlay under them is ours
+  if(heatMapButton.getToggleState()) repaint();
+}
+
 void ComplexPlaneEditor::
 valueTreeChildAdded(juce::ValueTree &parent, juce::ValueTree &child)
 {
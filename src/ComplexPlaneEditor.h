@@ -1,5 +1,5 @@
 #pragma once
-
+#include "TransferFunctionMap.h"
 
 class ComplexPlaneEditor final
   :public juce::Component
@@ -239,6 +239,7 @@ private:
   void updateTransforms(void);
   void updateTransformsAndChildBounds(void);
 
+  void valueTreePropertyChanged(juce::ValueTree &node, const juce::Identifier &property) override;
   void valueTreeChildAdded(juce::ValueTree &parent, juce::ValueTree &child) override;
   void valueTreeChildRemoved(juce::ValueTree &parent, juce::ValueTree &child, int index) override;
 
@@ -260,10 +261,19 @@ private:
   juce::TextButton constantMagnitudeInteractionButton;
   juce::TextButton constantAngleInteractionButton;
 
+  // NOTE: |H(z)| overlay, tiles are kept between paints
+  juce::TextButton heatMapButton;
+  TransferFunctionMap transferFunctionMap;
+  juce::SharedResourcePointer<WorkerPool> heatMapPool; // shared with the response worker
+
   u32 authoritativeInteractionFlags;
   u32 transientInteractionFlags;
 
   static constexpr int InteractionToggleGroupID = 0x00867068;
 
+  static constexpr int heatMapButtonWidth = 40;
+  static constexpr int heatMapButtonHeight = 24;
+  static constexpr int heatMapButtonPadding = 5;
+
   bool pointHoveringOverAxis;
 };
@@ -29,6 +29,7 @@ FilterState(juce::ValueTree treeToUse, juce::UndoManager *umToUse)
 
   totalOrder = 0;
   finiteZerosOrder = 0;
+  revision = nextRevision();
 
   syncListener(this);
 
@@ -359,6 +360,8 @@ getRootFromTreeNode(const juce::ValueTree &nodeToFind)
 void FilterState::
 valueTreeChildAdded(juce::ValueTree &parent, juce::ValueTree &child)
 {
+  revision = nextRevision();
+
   if(child.hasType(IDs::Root))
   {
     r64 valueIm = child.getProperty(IDs::ValueIm);
@@ -389,6 +392,8 @@ valueTreeChildAdded(juce::ValueTree &parent, juce::ValueTree &child)
 void FilterState::
 valueTreeChildRemoved(juce::ValueTree &parent, juce::ValueTree &child, int index)
 {
+  revision = nextRevision();
+
   juce::ignoreUnused(index);
 
   if(child.hasType(IDs::Root))
@@ -433,6 +438,8 @@ valueTreeChildRemoved(juce::ValueTree &parent, juce::ValueTree &child, int index
 void FilterState::
 valueTreePropertyChanged(juce::ValueTree &node, const juce::Identifier &property)
 {
+  revision = nextRevision();
+
   if(property == IDs::ValueRe || property == IDs::ValueIm)
   {
     if(auto *root = getRootFromTreeNode(node).get())
@@ -558,6 +565,13 @@ syncListener(juce::ValueTree::Listener *listener)
   listener->valueTreePropertyChanged(treeRoot, IDs::Gain);
 }
 
+u64 FilterState::
+nextRevision(void)
+{
+  static std::atomic<u64> counter{0};
+  return(++counter);
+}
+
 juce::UndoManager* FilterState::
 getCurrentUndoManager(void)
 {
@@ -307,6 +307,14 @@ struct FilterState : private juce::ValueTree::Listener
    */
   u32 totalOrder;
 
+  /** changed on every change to the tree (roots, orders and gain), so
+   * anything computed from the state can be keyed by it and recomputed only
+   * when it's out of date. Revisions are drawn from one counter for the whole
+   * process, so a state that replaces another never repeats one of its
+   * revisions.
+   */
+  u64 revision;
+
   // TODO(ry): separate trees for filter roots and parameters/automation
   juce::ValueTree treeRoot;
   juce::UndoManager *um;
@@ -328,6 +336,9 @@ private:
    */
   juce::UndoManager* getCurrentUndoManager(void);
 
+  /** the next revision of any filter state in the process */
+  static u64 nextRevision(void);
+
   // NOTE(ry): interaction state
   /** the root that is being weakly interacted with (eg mouse hovering) */
   FilterRoot::Ptr primedRoot;
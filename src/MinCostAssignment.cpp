@@ -0,0 +1,89 @@
+#include "MinCostAssignment.h"
+#include <limits>
+
+std::vector<int> MinCostAssignment::solve(
+	const std::vector<double>& cost,
+	int rows,
+	int columns)
+{
+	jassert(rows <= columns);
+	jassert(cost.size() == static_cast<std::size_t>(rows) * static_cast<std::size_t>(columns));
+
+	// Potentials u (rows) and v (columns) are kept so that
+	// cost(i, j) - u[i] - v[j] >= 0, with equality on the matched edges.
+	// Index 0 is a virtual row/column, the real ones are 1-based.
+	const double inf = std::numeric_limits<double>::infinity();
+	const auto width = static_cast<std::size_t>(columns) + 1;
+	std::vector<double> u(static_cast<std::size_t>(rows) + 1, 0.0), v(width, 0.0), minSlack(width);
+	std::vector<int> rowOfColumn(width, 0), previousColumn(width, 0);
+	std::vector<char> visited(width);
+
+	for (int row = 1; row <= rows; row++)
+	{
+		// grow an alternating tree from `row` until it reaches a free column
+		rowOfColumn[0] = row;
+		std::size_t column = 0;
+		std::fill(minSlack.begin(), minSlack.end(), inf);
+		std::fill(visited.begin(), visited.end(), false);
+		do
+		{
+			visited[column] = true;
+			const int treeRow = rowOfColumn[column];
+			const double* costRow = cost.data() + static_cast<std::size_t>(treeRow - 1) * static_cast<std::size_t>(columns);
+			double delta = inf;
+			std::size_t nextColumn = 0;
+			for (std::size_t j = 1; j < width; j++)
+			{
+				if (visited[j])
+					continue;
+				const double slack = costRow[j - 1] - u[static_cast<std::size_t>(treeRow)] - v[j];
+				if (slack < minSlack[j])
+				{
+					minSlack[j] = slack;
+					previousColumn[j] = static_cast<int>(column);
+				}
+				if (minSlack[j] < delta)
+				{
+					delta = minSlack[j];
+					nextColumn = j;
+				}
+			}
+			for (std::size_t j = 0; j < width; j++)
+			{
+				if (visited[j])
+				{
+					u[static_cast<std::size_t>(rowOfColumn[j])] += delta;
+					v[j] -= delta;
+				}
+				else
+				{
+					minSlack[j] -= delta;
+				}
+			}
+			column = nextColumn;
+		} while (rowOfColumn[column] != 0);
+
+		// flip the augmenting path
+		do
+		{
+			const auto previous = static_cast<std::size_t>(previousColumn[column]);
+			rowOfColumn[column] = rowOfColumn[previous];
+			column = previous;
+		} while (column != 0);
+	}
+
+	std::vector<int> columnOfRow(static_cast<std::size_t>(rows), -1);
+	for (std::size_t j = 1; j < width; j++)
+		if (rowOfColumn[j] != 0)
+			columnOfRow[static_cast<std::size_t>(rowOfColumn[j] - 1)] = static_cast<int>(j - 1);
+	return columnOfRow;
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 8 */
+/* c-basic-offset: 8 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
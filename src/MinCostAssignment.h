@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+
+class MinCostAssignment
+{
+public:
+	/** Solves the rectangular assignment problem with the Hungarian method,
+	 * O(rows^2 * columns).
+	 * `cost` is row-major, rows x columns, with rows <= columns, and every
+	 * entry must be finite. Returns the column assigned to each row so that
+	 * no column is used twice and the total cost is minimal.
+	 */
+	static std::vector<int> solve(
+		const std::vector<double>& cost,
+		int rows,
+		int columns);
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 8 */
+/* c-basic-offset: 8 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
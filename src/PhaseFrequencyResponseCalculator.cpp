@@ -1,4 +1,5 @@
 #include "PhaseFrequencyResponseCalculator.h"
+#include "RootsToCoefficients.h"
 #include <cmath>
 
 void PhaseFrequencyResponseCalculator::calculate(
@@ -10,40 +11,308 @@ void PhaseFrequencyResponseCalculator::calculate(
     int intWidth,
     std::vector<double>& angles,
     std::vector<double>& amplitudes,
-    std::vector<double>& phases)
+    std::vector<double>& phases,
+    WorkerPool* pool,
+    int maxWorkers,
+    double bandBegin,
+    double bandEnd)
 {
     std::size_t width = static_cast<size_t>(intWidth);
     angles.resize(width);
     amplitudes.resize(width, 1.);
     phases.resize(width, 0.);
 
-    const double maxAngle = pi;
     const double minAngle = pi * minFreq / (sampleRate / 2);
+
+    // NOTE: the roots are read here, on the calling thread; the workers only see the snapshot
+    RootSnapshot snapshot;
+    snapshot.capture(*filterState);
+
+    const size_t factors = snapshot.zeros.countFactors() + snapshot.poles.countFactors();
+    // NOTE: the FFT only gives the grid of the whole axis, zoomed bands are evaluated directly
+    if (!isLogScale
+        && bandBegin == 0.0
+        && bandEnd == 1.0
+        && width >= fftMinWidth
+        && factors >= fftMinFactors
+        && evaluateUniform(snapshot, width, amplitudes.data(), phases.data()))
+    {
+        fillAngles(0, width, minAngle, isLogScale, width, bandBegin, bandEnd, angles.data());
+        toDisplayUnits(width, amplitudes.data(), phases.data(), isDegrees);
+        return;
+    }
+
+    std::vector<double> cosines(width), sines(width);
+    forEachChunk(width, factors, pool, maxWorkers, [&](std::size_t begin, std::size_t end)
+    {
+        fillAngles(begin, end, minAngle, isLogScale, width, bandBegin, bandEnd, angles.data());
+        for (std::size_t i = begin; i < end; i++)
+        {
+            cosines[i] = std::cos(angles[i]);
+            sines[i] = std::sin(angles[i]);
+        }
+
+        evaluate(snapshot, cosines.data() + begin, sines.data() + begin, end - begin, amplitudes.data() + begin, phases.data() + begin);
+        toDisplayUnits(end - begin, amplitudes.data() + begin, phases.data() + begin, isDegrees);
+    });
+}
+
+void PhaseFrequencyResponseCalculator::calculateAngles(
+    float minFreq,
+    double sampleRate,
+    bool isLogScale,
+    int intWidth,
+    std::vector<double>& angles,
+    double bandBegin,
+    double bandEnd)
+{
+    std::size_t width = static_cast<size_t>(intWidth);
+    angles.resize(width);
+    fillAngles(0, width, pi * minFreq / (sampleRate / 2), isLogScale, width, bandBegin, bandEnd, angles.data());
+}
+
+void PhaseFrequencyResponseCalculator::fillAngles(
+    size_t begin,
+    size_t end,
+    double minAngle,
+    bool isLogScale,
+    size_t width,
+    double bandBegin,
+    double bandEnd,
+    double* angles)
+{
+    const double maxAngle = pi;
     const double logMaxAngle = std::log10(maxAngle);
     const double logMinAngle = std::log10(minAngle);
+    const double bandWidth = bandEnd - bandBegin;
     const double angleCoeff =
         isLogScale ?
-        (logMaxAngle - logMinAngle) / width :
-        maxAngle / width;
-    const double phaseUnitCoeff = isDegrees ? 180.0 / pi : 1.0;
-    const double phaseAmplitude = isDegrees ? 180.0 : pi;
+        (logMaxAngle - logMinAngle) * bandWidth / width :
+        maxAngle * bandWidth / width;
+    const double angleOffset =
+        isLogScale ?
+        logMinAngle + (logMaxAngle - logMinAngle) * bandBegin :
+        maxAngle * bandBegin;
 
-    for (std::size_t i = 0; i < width; i++)
+    for (std::size_t i = begin; i < end; i++)
     {
         angles[i] =
             isLogScale ?
-            std::pow(10., angleCoeff * i + logMinAngle) :
-            angleCoeff * i;
-        calculateForAngle(
-            filterState,
-            phaseUnitCoeff,
-            phaseAmplitude,
-            angles[i],
-            amplitudes[i],
-            phases[i]);
+            std::pow(10., angleCoeff * i + angleOffset) :
+            angleCoeff * i + angleOffset;
     }
 }
 
+void PhaseFrequencyResponseCalculator::calculateAdaptive(
+    FilterState* filterState,
+    float minFreq,
+    double sampleRate,
+    bool isLogScale,
+    bool isDegrees,
+    size_t budget,
+    ResponseSamples& samples,
+    double bandBegin,
+    double bandEnd)
+{
+    RootSnapshot snapshot;
+    snapshot.capture(*filterState);
+
+    const size_t uniformCount = std::max<size_t>(2, budget / 2);
+    std::vector<double> positions(uniformCount), angles;
+    for (size_t i = 0; i < uniformCount; i++)
+        positions[i] = static_cast<double>(i) / uniformCount;
+    calculateAngles(minFreq, sampleRate, isLogScale, static_cast<int>(uniformCount), angles, bandBegin, bandEnd);
+    samples = {};
+    addSamples(snapshot, positions, angles, isDegrees, samples);
+    refine(snapshot, minFreq, sampleRate, isLogScale, isDegrees, budget - std::min(budget, uniformCount), samples, bandBegin, bandEnd);
+}
+
+void PhaseFrequencyResponseCalculator::refine(
+    const RootSnapshot& snapshot,
+    float minFreq,
+    double sampleRate,
+    bool isLogScale,
+    bool isDegrees,
+    size_t budget,
+    ResponseSamples& samples,
+    double bandBegin,
+    double bandEnd)
+{
+    // the inverse of fillAngles and fillAngles itself at any position of the band
+    const double logMinAngle = std::log10(pi * minFreq / (sampleRate / 2));
+    const double logMaxAngle = std::log10(pi);
+    const double bandWidth = bandEnd - bandBegin;
+    const auto toPosition = [&](double angle)
+    {
+        const double axis = isLogScale ? (std::log10(angle) - logMinAngle) / (logMaxAngle - logMinAngle) : angle / pi;
+        return (axis - bandBegin) / bandWidth;
+    };
+    const auto toAngle = [&](double position)
+    {
+        const double axis = bandBegin + bandWidth * position;
+        return isLogScale ? std::pow(10., logMinAngle + (logMaxAngle - logMinAngle) * axis) : pi * axis;
+    };
+
+    const size_t target = samples.size() + budget;
+    std::vector<double> positions, angles;
+
+    // around the angles of roots near the unit circle, closest first
+    std::vector<std::pair<double, double>> resonances; // distance to the circle, angle
+    for (const auto* roots : { &snapshot.zeros, &snapshot.poles })
+    {
+        for (size_t k = 0; k < roots->size(); k++)
+        {
+            const double distance = std::abs(1.0 - std::hypot(roots->re[k], roots->im[k]));
+            if (distance < resonanceRadius)
+                resonances.emplace_back(std::max(distance, minResonanceWidth), std::abs(std::atan2(roots->im[k], roots->re[k])));
+        }
+    }
+    std::sort(resonances.begin(), resonances.end());
+
+    for (const auto& [distance, rootAngle] : resonances)
+    {
+        for (double offset : resonanceOffsets)
+        {
+            const double angle = rootAngle + offset * distance;
+            const double position = angle > 0 ? toPosition(angle) : -1.0;
+            if (position >= 0 && position < 1 && positions.size() < budget / 2)
+                positions.push_back(position);
+        }
+    }
+    std::sort(positions.begin(), positions.end());
+    for (double position : positions)
+        angles.push_back(toAngle(position));
+    addSamples(snapshot, positions, angles, isDegrees, samples);
+
+    // then where the amplitude bends most
+    std::vector<double> deviations;
+    std::vector<size_t> intervals;
+    for (int pass = 0; pass < refinePasses && samples.size() < target; pass++)
+    {
+        const size_t count = samples.size();
+        const auto& p = samples.positions;
+        const auto& y = samples.amplitudes;
+        deviations.assign(count, 0.0);
+        for (size_t i = 1; i + 1 < count; i++)
+        {
+            const double line = y[i - 1] + (y[i + 1] - y[i - 1]) * (p[i] - p[i - 1]) / (p[i + 1] - p[i - 1]);
+            deviations[i] = std::abs(y[i] - line);
+        }
+
+        intervals.clear();
+        for (size_t i = 0; i + 1 < count; i++)
+        {
+            if (p[i + 1] - p[i] > refineMinSpacing)
+                intervals.push_back(i);
+        }
+        const auto score = [&](size_t i) { return std::max(deviations[i], deviations[i + 1]); };
+        const size_t batch = std::min(intervals.size(), (target - count) / static_cast<size_t>(refinePasses - pass));
+        if (batch == 0)
+            break;
+        std::nth_element(intervals.begin(), intervals.begin() + static_cast<std::ptrdiff_t>(batch - 1), intervals.end(),
+            [&](size_t a, size_t b) { return score(a) > score(b); });
+        intervals.resize(batch);
+        std::sort(intervals.begin(), intervals.end());
+
+        positions.clear();
+        angles.clear();
+        for (size_t i : intervals)
+        {
+            positions.push_back((p[i] + p[i + 1]) / 2);
+            angles.push_back(toAngle(positions.back()));
+        }
+        addSamples(snapshot, positions, angles, isDegrees, samples);
+    }
+}
+
+void PhaseFrequencyResponseCalculator::addSamples(
+    const RootSnapshot& snapshot,
+    const std::vector<double>& positions,
+    const std::vector<double>& angles,
+    bool isDegrees,
+    ResponseSamples& samples)
+{
+    const size_t count = positions.size();
+    std::vector<double> cosines(count), sines(count), amplitudes(count), phases(count), groupDelays(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        cosines[i] = std::cos(angles[i]);
+        sines[i] = std::sin(angles[i]);
+    }
+    evaluate(snapshot, cosines.data(), sines.data(), count, amplitudes.data(), phases.data(), groupDelays.data());
+    toDisplayUnits(count, amplitudes.data(), phases.data(), isDegrees);
+
+    ResponseSamples merged;
+    const size_t total = samples.size() + count;
+    for (auto* v : { &merged.positions, &merged.angles, &merged.amplitudes, &merged.phases, &merged.groupDelays })
+        v->reserve(total);
+    const auto push = [&merged](double position, double angle, double amplitude, double phase, double groupDelay)
+    {
+        merged.positions.push_back(position);
+        merged.angles.push_back(angle);
+        merged.amplitudes.push_back(amplitude);
+        merged.phases.push_back(phase);
+        merged.groupDelays.push_back(groupDelay);
+    };
+
+    size_t i = 0, j = 0;
+    while (i < samples.size() || j < count)
+    {
+        if (j == count || (i < samples.size() && samples.positions[i] < positions[j]))
+        {
+            push(samples.positions[i], samples.angles[i], samples.amplitudes[i], samples.phases[i], samples.groupDelays[i]);
+            i++;
+        }
+        else
+        {
+            const bool isNew = (i == samples.size() || positions[j] < samples.positions[i])
+                && (merged.size() == 0 || positions[j] > merged.positions.back());
+            if (isNew)
+                push(positions[j], angles[j], amplitudes[j], phases[j], groupDelays[j]);
+            j++;
+        }
+    }
+    samples = std::move(merged);
+}
+
+void PhaseFrequencyResponseCalculator::toDisplayUnits(size_t count, double* amplitudes, double* phases, bool isDegrees)
+{
+    const double phaseUnitCoeff = isDegrees ? 180.0 / pi : 1.0;
+    const double phaseAmplitude = isDegrees ? 180.0 : pi;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        amplitudes[i] = juce::Decibels::gainToDecibels(std::exp(amplitudes[i]));
+        phases[i] = wrapPhase(phases[i], phaseUnitCoeff, phaseAmplitude);
+    }
+}
+
+void PhaseFrequencyResponseCalculator::forEachChunk(
+    size_t count,
+    size_t factorsPerPoint,
+    WorkerPool* pool,
+    int maxWorkers,
+    const std::function<void(size_t begin, size_t end)>& body)
+{
+    const std::size_t work = count * (factorsPerPoint + pointCost);
+    if (pool == nullptr || work < parallelMinWork || count <= blockSize)
+    {
+        body(0, count);
+        return;
+    }
+
+    // Chunks of whole blocks, so every point goes through the same block layout, and
+    // the same instructions, as in the serial case: the result doesn't depend on the
+    // number of workers. A few chunks per worker even out the rest of the machine.
+    const int workers = maxWorkers > 0 ? std::min(maxWorkers, pool->getNumWorkers()) : pool->getNumWorkers();
+    const std::size_t blocks = (count + blockSize - 1) / blockSize;
+    const std::size_t blocksPerChunk = std::max<std::size_t>(1, blocks / (chunksPerWorker * static_cast<std::size_t>(workers)));
+    const std::size_t chunk = blocksPerChunk * blockSize;
+    pool->parallelFor((count + chunk - 1) / chunk, [&](std::size_t item, int)
+    {
+        body(item * chunk, std::min(count, (item + 1) * chunk));
+    }, maxWorkers);
+}
+
 void PhaseFrequencyResponseCalculator::calculateForAngle(
     FilterState* filterState,
     double phaseUnitCoeff,
@@ -74,12 +343,628 @@ void PhaseFrequencyResponseCalculator::calculateForAngle(
     }
 
     amplitude = juce::Decibels::gainToDecibels(amplitude);
+    phase = wrapPhase(phase, phaseUnitCoeff, phaseAmplitude);
+}
 
+double PhaseFrequencyResponseCalculator::wrapPhase(double phase, double phaseUnitCoeff, double phaseAmplitude)
+{
     const double phaseAmplitude2 = phaseAmplitude * 2;
     double ph = phase * phaseUnitCoeff;
     ph = std::fmod(ph + phaseAmplitude, phaseAmplitude2);
     ph += ph >= 0 ? 0 : phaseAmplitude2;
-    phase = ph - phaseAmplitude;
+    return ph - phaseAmplitude;
+}
+
+double PhaseFrequencyResponseCalculator::unwrappedPhase(const RootSnapshot& snapshot, double angle)
+{
+    const c128 x = std::polar(1.0, angle);
+    const auto rootPhase = [&](c128 root)
+    {
+        // x - root = x (1 - root / x) inside the circle and -root (1 - x / root) outside,
+        // the second factor's real part never negative so its arg never jumps
+        if (std::norm(root) < 1.0)
+            return angle + std::arg(1.0 - root / x);
+        const double atZero = std::arg(-root) + std::arg(1.0 - 1.0 / root);
+        const double turns = std::round((std::arg(1.0 - root) - atZero) / (2.0 * pi));
+        return std::arg(-root) + std::arg(1.0 - x / root) + 2.0 * pi * turns;
+    };
+
+    double phase = 0.0;
+    for (const auto& [roots, sign] : { std::pair{ &snapshot.zeros, 1.0 }, std::pair{ &snapshot.poles, -1.0 } })
+    {
+        for (size_t k = 0; k < roots->size(); k++)
+        {
+            const c128 root(roots->re[k], roots->im[k]);
+            const double rootPhases = roots->isReal[k] ? rootPhase(root) : rootPhase(root) + rootPhase(std::conj(root));
+            phase += sign * roots->order[k] * rootPhases;
+        }
+    }
+    return phase;
+}
+
+void PhaseFrequencyResponseCalculator::phaseDelays(
+    const RootSnapshot& snapshot,
+    const double* angles,
+    const double* phases,
+    const double* groupDelays,
+    size_t count,
+    double* delays)
+{
+    double phase = 0.0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i == 0)
+            phase = unwrappedPhase(snapshot, angles[0]);
+        else
+        {
+            const double expected = phase - 0.5 * (groupDelays[i - 1] + groupDelays[i]) * (angles[i] - angles[i - 1]);
+            phase = phases[i] + 2.0 * pi * std::round((expected - phases[i]) / (2.0 * pi));
+        }
+        delays[i] = angles[i] > 0.0 ? -phase / angles[i] : groupDelays[i];
+    }
+}
+
+void PhaseFrequencyResponseCalculator::evaluate(
+    const RootSnapshot& snapshot,
+    const double* cosines,
+    const double* sines,
+    size_t count,
+    double* logMagnitudes,
+    double* phases,
+    double* groupDelays)
+{
+    const double logEps = std::log(eps);
+
+    double logPoles[blockSize];
+    for (size_t start = 0; start < count; start += blockSize)
+    {
+        const size_t width = std::min(blockSize, count - start);
+        evaluateBlock(snapshot, cosines + start, sines + start, width, logMagnitudes + start, logPoles, phases + start,
+            groupDelays != nullptr ? groupDelays + start : nullptr);
+        for (size_t i = 0; i < width; i++)
+            logMagnitudes[start + i] -= std::max(logPoles[i], logEps);
+    }
+}
+
+void PhaseFrequencyResponseCalculator::evaluateParts(
+    const RootSnapshot& snapshot,
+    const double* cosines,
+    const double* sines,
+    size_t count,
+    double* logZeros,
+    double* logPoles,
+    double* phases,
+    double* groupDelays)
+{
+    for (size_t start = 0; start < count; start += blockSize)
+    {
+        const size_t width = std::min(blockSize, count - start);
+        evaluateBlock(snapshot, cosines + start, sines + start, width, logZeros + start, logPoles + start, phases + start,
+            groupDelays != nullptr ? groupDelays + start : nullptr);
+    }
+}
+
+void PhaseFrequencyResponseCalculator::evaluateBlock(
+    const RootSnapshot& snapshot,
+    const double* cosines,
+    const double* sines,
+    size_t count,
+    double* logZeros,
+    double* logPoles,
+    double* phases,
+    double* groupDelays)
+{
+    jassert(count <= blockSize);
+    const double ln2 = std::log(2.0);
+
+    double zRe[blockSize], zIm[blockSize], pRe[blockSize], pIm[blockSize];
+    int zExponent[blockSize], pExponent[blockSize];
+    if (groupDelays != nullptr)
+        std::fill_n(groupDelays, count, 0.0);
+    accumulate(snapshot.zeros, cosines, sines, count, zRe, zIm, zExponent, groupDelays, -1.0);
+    accumulate(snapshot.poles, cosines, sines, count, pRe, pIm, pExponent, groupDelays, 1.0);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        logZeros[i] = std::log(std::hypot(zRe[i], zIm[i])) + zExponent[i] * ln2;
+        logPoles[i] = std::log(std::hypot(pRe[i], pIm[i])) + pExponent[i] * ln2;
+        // arg of zeros * conj(poles)
+        phases[i] = std::atan2(zIm[i] * pRe[i] - zRe[i] * pIm[i], zRe[i] * pRe[i] + zIm[i] * pIm[i]);
+    }
+}
+
+bool PhaseFrequencyResponseCalculator::evaluateUniform(
+    const RootSnapshot& snapshot,
+    size_t count,
+    double* logMagnitudes,
+    double* phases)
+{
+    // angle i = pi i / count is bin i of a transform of size 2 count
+    const size_t size = 2 * count;
+    if (count == 0 || (size & (size - 1)) != 0)
+        return false;
+
+    struct Factor
+    {
+        double re, im;
+        bool isReal;
+    };
+    struct Group
+    {
+        std::vector<Factor> factors;
+        std::vector<double> coefficients; // highest power first
+        double rootProduct;
+        bool isPole;
+    };
+    std::vector<Group> groups;
+    int degreeDifference = 0;
+
+    // The rounding error of the expanded coefficients, and so of the values on the circle, goes
+    // with the product of 1 + |root| over the roots rather than with the coefficients themselves.
+    // A group with a product above fftMaxRootProduct is split in two, every other factor each,
+    // until it's small enough or down to one factor.
+    std::function<void(const std::vector<Factor>&, bool)> addGroup = [&](const std::vector<Factor>& factors, bool isPole)
+    {
+        double rootProduct = 1.0;
+        for (auto& f : factors)
+        {
+            const double size = 1.0 + std::hypot(f.re, f.im);
+            rootProduct *= f.isReal ? size : size * size;
+        }
+        if (rootProduct > fftMaxRootProduct && factors.size() > 1)
+        {
+            std::vector<Factor> halves[2];
+            for (size_t k = 0; k < factors.size(); k++)
+                halves[k % 2].push_back(factors[k]);
+            addGroup(halves[0], isPole);
+            addGroup(halves[1], isPole);
+            return;
+        }
+
+        std::vector<double> coefficients{ 1.0 };
+        for (auto& f : factors)
+            coefficients = RootsToCoefficients::multiply(coefficients, f.isReal
+                ? std::vector<double>{ 1.0, -f.re }
+                : std::vector<double>{ 1.0, -2.0 * f.re, f.re * f.re + f.im * f.im });
+        groups.push_back({ factors, std::move(coefficients), rootProduct, isPole });
+    };
+
+    // Factors in order of angle, dealt out to the groups in turn, so that the roots of each group
+    // are spread round the circle: the coefficients of such a polynomial stay small, those of
+    // clustered roots grow like binomial coefficients.
+    const auto addGroups = [&](const RootSnapshot::Roots& roots, bool isPole)
+    {
+        std::vector<Factor> factors;
+        size_t degree = 0;
+        for (size_t k = 0; k < roots.size(); k++)
+            for (int o = 0; o < roots.order[k]; o++)
+            {
+                factors.push_back({ roots.re[k], roots.im[k], roots.isReal[k] != 0 });
+                degree += roots.isReal[k] ? 1 : 2;
+            }
+        degreeDifference += (isPole ? -1 : 1) * static_cast<int>(degree);
+        if (factors.empty())
+            return;
+
+        std::sort(factors.begin(), factors.end(), [](const Factor& a, const Factor& b)
+        {
+            return std::atan2(std::abs(a.im), a.re) < std::atan2(std::abs(b.im), b.re);
+        });
+        const size_t groupCount = (degree + fftGroupDegree - 1) / fftGroupDegree;
+        std::vector<std::vector<Factor>> dealt(groupCount);
+        for (size_t k = 0; k < factors.size(); k++)
+            dealt[k % groupCount].push_back(factors[k]);
+        for (auto& group : dealt)
+            addGroup(group, isPole);
+    };
+    addGroups(snapshot.zeros, false);
+    addGroups(snapshot.poles, true);
+
+    std::vector<double> zRe(count, 1.0), zIm(count, 0.0), pRe(count, 1.0), pIm(count, 0.0);
+    std::vector<int> zExponent(count, 0), pExponent(count, 0);
+    const double angleCoeff = pi / count;
+    const auto multiplyInto = [&](const Group& group, size_t i, double valueRe, double valueIm)
+    {
+        // Where the value is small against the error of the coefficients, near a root, the group
+        // is multiplied out at that point instead, as in accumulate
+        const double trusted = fftTrustRatio * group.rootProduct;
+        if (valueRe * valueRe + valueIm * valueIm < trusted * trusted)
+        {
+            const double angle = angleCoeff * i;
+            const double c = std::cos(angle);
+            const double s = std::sin(angle);
+            double productRe = 1.0, productIm = 0.0;
+            for (auto& f : group.factors)
+            {
+                const double dx = c - f.re;
+                const double vRe = f.isReal ? dx : dx * dx - s * s + f.im * f.im;
+                const double vIm = f.isReal ? s : 2.0 * dx * s;
+                const double nextRe = productRe * vRe - productIm * vIm;
+                productIm = productRe * vIm + productIm * vRe;
+                productRe = nextRe;
+            }
+            // the transform has P(e^iw) e^(-iw degree)
+            const double shift = -angle * static_cast<double>(group.coefficients.size() - 1);
+            const double shiftRe = std::cos(shift);
+            const double shiftIm = std::sin(shift);
+            valueRe = productRe * shiftRe - productIm * shiftIm;
+            valueIm = productRe * shiftIm + productIm * shiftRe;
+        }
+
+        auto& re = group.isPole ? pRe : zRe;
+        auto& im = group.isPole ? pIm : zIm;
+        const double nextRe = re[i] * valueRe - im[i] * valueIm;
+        im[i] = re[i] * valueIm + im[i] * valueRe;
+        re[i] = nextRe;
+    };
+
+    // P(e^iw) = e^(iw degree) sum c_n e^(-iwn), the sum being bin k of the forward transform
+    // of c, zero padded to size, for w = 2 pi k / size.
+    // The groups are short, so rather than transforming mostly zeros, the bins are split by k
+    // mod residues = size / length: those of residue r are the transform of length of
+    // c_n e^(-2 pi i n r / size), n < length. That's O(size log length) instead of O(size log size).
+    // Both groups of a pair are real, so one transform of a + ib carries the two spectra:
+    // A[k] = (Z[k] + conj(Z[-k])) / 2 and B[k] = (Z[k] - conj(Z[-k])) / 2i, with -k in residue -r.
+    std::vector<c128> y[2];
+    int sinceRenormalised = 0;
+    for (size_t g = 0; g < groups.size(); g += 2)
+    {
+        const Group& a = groups[g];
+        const Group* b = g + 1 < groups.size() ? &groups[g + 1] : nullptr;
+        size_t length = 2;
+        while (length < std::max(a.coefficients.size(), b != nullptr ? b->coefficients.size() : 0))
+            length <<= 1;
+        jassert(length <= size);
+        const size_t residues = size / length;
+        const auto twiddles = RootsToCoefficients::fftTwiddles(length, false);
+
+        const auto transform = [&](size_t r, std::vector<c128>& out)
+        {
+            out.assign(length, c128(0.0, 0.0));
+            const double stepRe = std::cos(-2.0 * pi * static_cast<double>(r) / static_cast<double>(size));
+            const double stepIm = std::sin(-2.0 * pi * static_cast<double>(r) / static_cast<double>(size));
+            double wRe = 1.0, wIm = 0.0;
+            for (size_t n = 0; n < length; n++)
+            {
+                const double cRe = n < a.coefficients.size() ? a.coefficients[n] : 0.0;
+                const double cIm = b != nullptr && n < b->coefficients.size() ? b->coefficients[n] : 0.0;
+                out[n] = c128(cRe * wRe - cIm * wIm, cRe * wIm + cIm * wRe);
+                const double nextRe = wRe * stepRe - wIm * stepIm;
+                wIm = wRe * stepIm + wIm * stepRe;
+                wRe = nextRe;
+            }
+            RootsToCoefficients::fft(out, twiddles);
+        };
+        // bins k = r + residues m, m < length / 2, are the ones below count
+        const auto emit = [&](size_t r, const std::vector<c128>& bins, const std::vector<c128>& mirrors)
+        {
+            for (size_t m = 0; m < length / 2; m++)
+            {
+                const size_t k = r + residues * m;
+                const c128 zk = bins[m];
+                const c128 mirror = mirrors[r == 0 ? (length - m) & (length - 1) : length - 1 - m];
+                // (zk + conj(mirror)) / 2 and (zk - conj(mirror)) / 2i
+                multiplyInto(a, k, 0.5 * (zk.real() + mirror.real()), 0.5 * (zk.imag() - mirror.imag()));
+                if (b != nullptr)
+                    multiplyInto(*b, k, 0.5 * (zk.imag() + mirror.imag()), -0.5 * (zk.real() - mirror.real()));
+            }
+        };
+
+        for (size_t r = 0; r <= residues / 2; r++)
+        {
+            const size_t opposite = (residues - r) % residues;
+            transform(r, y[0]);
+            if (opposite == r)
+            {
+                emit(r, y[0], y[0]);
+                continue;
+            }
+            transform(opposite, y[1]);
+            emit(r, y[0], y[1]);
+            emit(opposite, y[1], y[0]);
+        }
+
+        // NOTE: each group is at most fftMaxRootProduct, so a few pairs can't leave the range of a double
+        if (++sinceRenormalised == fftRenormaliseEvery)
+        {
+            renormalise(count, zRe.data(), zIm.data(), zExponent.data());
+            renormalise(count, pRe.data(), pIm.data(), pExponent.data());
+            sinceRenormalised = 0;
+        }
+    }
+    renormalise(count, zRe.data(), zIm.data(), zExponent.data());
+    renormalise(count, pRe.data(), pIm.data(), pExponent.data());
+
+    const double ln2 = std::log(2.0);
+    const double logEps = std::log(eps);
+    for (size_t i = 0; i < count; i++)
+    {
+        const double logZeros = std::log(std::hypot(zRe[i], zIm[i])) + zExponent[i] * ln2;
+        const double logPoles = std::log(std::hypot(pRe[i], pIm[i])) + pExponent[i] * ln2;
+        logMagnitudes[i] = logZeros - std::max(logPoles, logEps);
+        const double phase = std::atan2(zIm[i] * pRe[i] - zRe[i] * pIm[i], zRe[i] * pRe[i] + zIm[i] * pIm[i]);
+        phases[i] = std::remainder(phase + degreeDifference * (angleCoeff * i), 2.0 * pi);
+    }
+    return true;
+}
+
+void PhaseFrequencyResponseCalculator::accumulate(
+    const RootSnapshot::Roots& roots,
+    const double* cosines,
+    const double* sines,
+    size_t count,
+    double* re,
+    double* im,
+    int* exponent,
+    double* delays,
+    double delaySign)
+{
+    std::fill_n(re, count, 1.0);
+    std::fill_n(im, count, 0.0);
+    std::fill_n(exponent, count, 0);
+
+    const double minNorm = std::numeric_limits<double>::min();
+    int sinceRenormalised = 0;
+    for (size_t k = 0; k < roots.size(); k++)
+    {
+        const double rootRe = roots.re[k];
+        const double rootIm = roots.im[k];
+        const double rootImSquared = rootIm * rootIm;
+        const double weight = delaySign * roots.order[k];
+        for (int o = 0; o < roots.order[k]; o++)
+        {
+            // NOTE: the delay terms are added with the first factor of a root, from the
+            // same differences, the loops without them are kept for evaluate without delays
+            const bool isWithDelays = delays != nullptr && o == 0;
+            if (roots.isReal[k] && isWithDelays)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    const double vRe = cosines[i] - rootRe;
+                    const double vIm = sines[i];
+                    delays[i] += weight * (1.0 - cosines[i] * rootRe) / std::max(vRe * vRe + vIm * vIm, minNorm);
+                    const double nextRe = re[i] * vRe - im[i] * vIm;
+                    im[i] = re[i] * vIm + im[i] * vRe;
+                    re[i] = nextRe;
+                }
+            }
+            else if (roots.isReal[k])
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    const double vRe = cosines[i] - rootRe;
+                    const double vIm = sines[i];
+                    const double nextRe = re[i] * vRe - im[i] * vIm;
+                    im[i] = re[i] * vIm + im[i] * vRe;
+                    re[i] = nextRe;
+                }
+            }
+            else if (isWithDelays)
+            {
+                // the pair's two delay terms are Re(x v' / v) with v the quadratic below
+                // and v' = 2 (x - re): Re(x v' conj(v)) / |v|^2, one division for both
+                for (size_t i = 0; i < count; i++)
+                {
+                    const double dx = cosines[i] - rootRe;
+                    const double vRe = dx * dx - sines[i] * sines[i] + rootImSquared;
+                    const double vIm = 2.0 * dx * sines[i];
+                    const double xdRe = cosines[i] * dx - sines[i] * sines[i];
+                    const double xdIm = sines[i] * (cosines[i] + dx);
+                    delays[i] += weight * 2.0 * (xdRe * vRe + xdIm * vIm) / std::max(vRe * vRe + vIm * vIm, minNorm);
+                    const double nextRe = re[i] * vRe - im[i] * vIm;
+                    im[i] = re[i] * vIm + im[i] * vRe;
+                    re[i] = nextRe;
+                }
+            }
+            else
+            {
+                // (x - root)(x - conj(root)) = dx^2 - s^2 + im^2 + 2i dx s, with dx = c - re
+                for (size_t i = 0; i < count; i++)
+                {
+                    const double dx = cosines[i] - rootRe;
+                    const double vRe = dx * dx - sines[i] * sines[i] + rootImSquared;
+                    const double vIm = 2.0 * dx * sines[i];
+                    const double nextRe = re[i] * vRe - im[i] * vIm;
+                    im[i] = re[i] * vIm + im[i] * vRe;
+                    re[i] = nextRe;
+                }
+            }
+
+            if (++sinceRenormalised == renormaliseEvery)
+            {
+                renormalise(count, re, im, exponent);
+                sinceRenormalised = 0;
+            }
+        }
+    }
+    renormalise(count, re, im, exponent);
+}
+
+void PhaseFrequencyResponseCalculator::renormalise(size_t count, double* re, double* im, int* exponent)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const double magnitude = std::max(std::abs(re[i]), std::abs(im[i]));
+        if (!(magnitude > 0.0) || !std::isfinite(magnitude))
+            continue;
+        const int e = std::ilogb(magnitude);
+        re[i] = std::scalbn(re[i], -e);
+        im[i] = std::scalbn(im[i], -e);
+        exponent[i] += e;
+    }
+}
+
+void RootSnapshot::Roots::capture(const juce::OwnedArray<FilterRoot>& roots)
+{
+    re.clear();
+    im.clear();
+    order.clear();
+    isReal.clear();
+    for (auto* root : roots)
+    {
+        const c128 value = root->value.get();
+        re.push_back(value.real());
+        im.push_back(value.imag());
+        order.push_back(std::abs(root->order.get()));
+        isReal.push_back(root->isReal());
+    }
+}
+
+size_t RootSnapshot::Roots::countFactors() const
+{
+    size_t count = 0;
+    for (int o : order)
+        count += static_cast<size_t>(o);
+    return count;
+}
+
+void RootSnapshot::capture(const FilterState& state)
+{
+    zeros.capture(state.zeros);
+    poles.capture(state.poles);
+}
+
+void IncrementalResponse::setGrid(const std::vector<double>& angles)
+{
+    const size_t count = angles.size();
+    cosines.resize(count);
+    sines.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        cosines[i] = std::cos(angles[i]);
+        sines[i] = std::sin(angles[i]);
+    }
+    logZeros.resize(count);
+    logPoles.resize(count);
+    phases.resize(count);
+    groupDelays.resize(count);
+    isValid = false;
+}
+
+bool IncrementalResponse::update(const RootSnapshot& snapshot, WorkerPool* pool)
+{
+    if (isValid
+        && sinceFull < fullEvery
+        && snapshot.zeros.size() == roots.zeros.size()
+        && snapshot.poles.size() == roots.poles.size())
+    {
+        size_t moved = 0;
+        for (size_t k = 0; k < snapshot.zeros.size(); k++)
+            moved += isSameRoot(roots.zeros, snapshot.zeros, k) ? 0 : 1;
+        for (size_t k = 0; k < snapshot.poles.size(); k++)
+            moved += isSameRoot(roots.poles, snapshot.poles, k) ? 0 : 1;
+
+        // NOTE: a singular term leaves the sums half updated, the full evaluation below overwrites them
+        if (moved * movedRootCost <= snapshot.zeros.countFactors() + snapshot.poles.countFactors()
+            && updateTerms(roots.zeros, snapshot.zeros, logZeros.data(), 1.0)
+            && updateTerms(roots.poles, snapshot.poles, logPoles.data(), -1.0))
+        {
+            roots = snapshot;
+            sinceFull++;
+            incrementalUpdates++;
+            return true;
+        }
+    }
+
+    evaluateFull(snapshot, pool);
+    return false;
+}
+
+void IncrementalResponse::getResponse(double* logMagnitudes, double* phasesOut, double* groupDelaysOut) const
+{
+    jassert(isValid);
+    const double logEps = std::log(std::numeric_limits<double>::epsilon());
+    for (size_t i = 0; i < size(); i++)
+    {
+        logMagnitudes[i] = logZeros[i] - std::max(logPoles[i], logEps);
+        phasesOut[i] = phases[i];
+    }
+    if (groupDelaysOut != nullptr)
+        std::copy(groupDelays.begin(), groupDelays.end(), groupDelaysOut);
+}
+
+void IncrementalResponse::evaluateFull(const RootSnapshot& snapshot, WorkerPool* pool)
+{
+    const size_t factors = snapshot.zeros.countFactors() + snapshot.poles.countFactors();
+    PhaseFrequencyResponseCalculator::forEachChunk(size(), factors, pool, 0, [&](size_t begin, size_t end)
+    {
+        PhaseFrequencyResponseCalculator::evaluateParts(
+            snapshot, cosines.data() + begin, sines.data() + begin, end - begin,
+            logZeros.data() + begin, logPoles.data() + begin, phases.data() + begin, groupDelays.data() + begin);
+    });
+    roots = snapshot;
+    isValid = true;
+    sinceFull = 0;
+    fullUpdates++;
+}
+
+bool IncrementalResponse::updateTerms(const RootSnapshot::Roots& from, const RootSnapshot::Roots& to, double* logs, double phaseSign)
+{
+    for (size_t k = 0; k < to.size(); k++)
+    {
+        if (isSameRoot(from, to, k))
+            continue;
+
+        const double oldOrder = from.order[k];
+        const double newOrder = to.order[k];
+        bool isRegular = true;
+        for (size_t i = 0; i < size(); i++)
+        {
+            const c128 before = term(from, k, i);
+            const c128 after = term(to, k, i);
+            const double beforeNorm = std::norm(before);
+            isRegular = isRegular && beforeNorm > 0.0;
+
+            double logDelta, phaseDelta;
+            if (from.order[k] == to.order[k])
+            {
+                // only moved: one log and one atan2 of the ratio of the terms
+                const c128 ratio = after * std::conj(before);
+                logDelta = 0.5 * newOrder * std::log(std::norm(after) / beforeNorm);
+                phaseDelta = newOrder * std::atan2(ratio.imag(), ratio.real());
+            }
+            else
+            {
+                logDelta = 0.5 * (newOrder * std::log(std::norm(after)) - oldOrder * std::log(beforeNorm));
+                phaseDelta = newOrder * std::arg(after) - oldOrder * std::arg(before);
+            }
+            logs[i] += logDelta;
+            phases[i] = std::remainder(phases[i] + phaseSign * phaseDelta, 2.0 * pi);
+            // a zero takes its delay term away as a pole adds it
+            groupDelays[i] -= phaseSign * (newOrder * delayTerms(to, k, i) - oldOrder * delayTerms(from, k, i));
+        }
+
+        if (!isRegular)
+            return false;
+    }
+    return true;
+}
+
+c128 IncrementalResponse::term(const RootSnapshot::Roots& rootSet, size_t k, size_t i) const
+{
+    const double dx = cosines[i] - rootSet.re[k];
+    if (rootSet.isReal[k])
+        return c128(dx, sines[i]);
+    // (x - root)(x - conj(root)) as in PhaseFrequencyResponseCalculator::accumulate
+    return c128(dx * dx - sines[i] * sines[i] + rootSet.im[k] * rootSet.im[k], 2.0 * dx * sines[i]);
+}
+
+double IncrementalResponse::delayTerms(const RootSnapshot::Roots& rootSet, size_t k, size_t i) const
+{
+    const double rootRe = rootSet.re[k];
+    const double rootIm = rootSet.im[k];
+    if (rootSet.isReal[k])
+        return PhaseFrequencyResponseCalculator::delayTerm(cosines[i], sines[i], rootRe, 0.0);
+    return PhaseFrequencyResponseCalculator::delayTerm(cosines[i], sines[i], rootRe, rootIm)
+        + PhaseFrequencyResponseCalculator::delayTerm(cosines[i], sines[i], rootRe, -rootIm);
+}
+
+bool IncrementalResponse::isSameRoot(const RootSnapshot::Roots& a, const RootSnapshot::Roots& b, size_t k)
+{
+    return juce::exactlyEqual(a.re[k], b.re[k])
+        && juce::exactlyEqual(a.im[k], b.im[k])
+        && a.order[k] == b.order[k]
+        && a.isReal[k] == b.isReal[k];
 }
 
 void PhaseFrequencyResponseCalculator::calculateCoefficients(
@@ -1,9 +1,48 @@
 #pragma once
 #include "FilterState.h"
+#include "WorkerPool.h"
+#include <functional>
+
+/** The roots of a FilterState copied into plain arrays, so a response can be
+ * evaluated over a whole grid without reading CachedValues for every point.
+ * One root of each conjugate pair is kept, isReal tells which ones stand for
+ * a pair. Orders are positive for poles too.
+ */
+struct RootSnapshot
+{
+    struct Roots
+    {
+        std::vector<double> re, im;
+        std::vector<int> order;
+        std::vector<char> isReal;
+
+        void capture(const juce::OwnedArray<FilterRoot>& roots);
+        size_t size() const { return re.size(); }
+        /** factors multiplied per point, a conjugate pair counting once */
+        size_t countFactors() const;
+    };
+
+    void capture(const FilterState& state);
+
+    Roots zeros, poles;
+};
+
+/** A response sampled at increasing positions of a band, fractions of it in
+ * [0, 1), with the group delay in samples */
+struct ResponseSamples
+{
+    std::vector<double> positions, angles, amplitudes, phases, groupDelays;
+
+    size_t size() const { return positions.size(); }
+};
 
 class PhaseFrequencyResponseCalculator
 {
 public:
+    /** Given a pool, grids with enough points and roots are split between its
+     * workers; the result is the same either way.
+     * bandBegin and bandEnd pick the part of the axis the width points span,
+     * as fractions of the whole axis, minFreq to Nyquist, linear or log. */
     static void calculate(
         FilterState* filterState,
         float minFreq,
@@ -13,7 +52,41 @@ public:
         int intWidth,
         std::vector<double>& angles,
         std::vector<double>& amplitudes,
-        std::vector<double>& phases);
+        std::vector<double>& phases,
+        WorkerPool* pool = nullptr,
+        int maxWorkers = 0,
+        double bandBegin = 0.0,
+        double bandEnd = 1.0);
+    /** The band at budget points put where the response needs them: half of
+     * them uniformly, the rest by refine. Same units as calculate. */
+    static void calculateAdaptive(
+        FilterState* filterState,
+        float minFreq,
+        double sampleRate,
+        bool isLogScale,
+        bool isDegrees,
+        size_t budget,
+        ResponseSamples& samples,
+        double bandBegin = 0.0,
+        double bandEnd = 1.0);
+    /** Adds up to budget points to samples of the band, in the units of
+     * calculate. Up to half go around the angles of roots within
+     * resonanceRadius of the unit circle, closest first: peaks and notches
+     * narrower than the samples' spacing would be missed otherwise. The rest
+     * go in refinePasses passes to the middle of the intervals whose ends are
+     * furthest in dB from the line through their neighbours.
+     */
+    static void refine(
+        const RootSnapshot& snapshot,
+        float minFreq,
+        double sampleRate,
+        bool isLogScale,
+        bool isDegrees,
+        size_t budget,
+        ResponseSamples& samples,
+        double bandBegin = 0.0,
+        double bandEnd = 1.0);
+    /** Point by point reference for the grid evaluation, same units as calculate */
     static void calculateForAngle(
         FilterState* filterState,
         double phaseUnitCoeff,
@@ -21,6 +94,104 @@ public:
         double angle,
         double& amplitude,
         double& phase);
+
+    /** ln|H| and arg H, in (-pi, pi], at the points (cosines[i], sines[i]) of
+     * the unit circle, without the gain. The poles' product is clamped to eps
+     * as in calculateForAngle.
+     * Given groupDelays, the group delay -d arg H / d angle in samples goes
+     * there, the sum of the roots' delayTerm taken in the same pass.
+     * Goes over the grid in blocks, one root at a time for the whole block, so
+     * the inner loops are plain arithmetic over arrays that vectorise: the
+     * factors are multiplied into one complex product for the zeros and one
+     * for the poles (a conjugate pair as one real quadratic), kept in range by
+     * powers of 2. That leaves one log and one atan2 per point instead of
+     * std::pow, std::abs and std::arg per root per point.
+     */
+    static void evaluate(
+        const RootSnapshot& snapshot,
+        const double* cosines,
+        const double* sines,
+        size_t count,
+        double* logMagnitudes,
+        double* phases,
+        double* groupDelays = nullptr);
+    /** evaluate with ln of the zeros' product and of the poles' product kept
+     * apart, and the poles' not clamped yet */
+    static void evaluateParts(
+        const RootSnapshot& snapshot,
+        const double* cosines,
+        const double* sines,
+        size_t count,
+        double* logZeros,
+        double* logPoles,
+        double* phases,
+        double* groupDelays = nullptr);
+
+    /** d arg(x - root) / d angle at x = (c, s) on the unit circle, what a pole
+     * adds to the group delay and a zero takes away: Re(x / (x - root)), which
+     * is (1 - Re(x conj(root))) / |x - root|^2. 1/2 for a root on the circle,
+     * where the 0 / 0 at the root itself is taken as 0. */
+    static double delayTerm(double c, double s, double rootRe, double rootIm)
+    {
+        const double dx = c - rootRe;
+        const double dy = s - rootIm;
+        return (1.0 - c * rootRe - s * rootIm) / std::max(dx * dx + dy * dy, std::numeric_limits<double>::min());
+    }
+    /** arg H at angle continued from angle 0, where it's in (-pi, pi], as the
+     * sum of the roots' arg(x - root) each continued on its own, O(roots) */
+    static double unwrappedPhase(const RootSnapshot& snapshot, double angle);
+    /** The phase delay -arg H / angle in samples, with arg H unwrapped: exactly
+     * at the first point by unwrappedPhase, then the branch of each phase, in
+     * (-pi, pi], nearest to the one the group delay leads to from the point
+     * before. The group delay at angle 0, the limit there. Angles increasing. */
+    static void phaseDelays(
+        const RootSnapshot& snapshot,
+        const double* angles,
+        const double* phases,
+        const double* groupDelays,
+        size_t count,
+        double* delays);
+
+    /** evaluate on the linear grid of calculate, angle i = pi i / count, from
+     * coefficients rather than roots: the roots are expanded into polynomials
+     * of up to about 20 roots each, interleaved by angle, whose values on the
+     * whole grid come from zero padded FFTs of size 2 count, pruned to the
+     * nonzero inputs and two real polynomials per complex transform. That's
+     * O(count log degree) per polynomial instead of O(count) per root. Values
+     * near roots, where the expanded coefficients aren't accurate enough, are
+     * taken directly from the roots.
+     * Only for count a power of 2, returns false otherwise.
+     */
+    static bool evaluateUniform(
+        const RootSnapshot& snapshot,
+        size_t count,
+        double* logMagnitudes,
+        double* phases);
+
+    /** The angles calculate uses for a plot intWidth points wide */
+    static void calculateAngles(
+        float minFreq,
+        double sampleRate,
+        bool isLogScale,
+        int intWidth,
+        std::vector<double>& angles,
+        double bandBegin = 0.0,
+        double bandEnd = 1.0);
+    /** ln|H| to dB and arg H to the units of calculate, in place */
+    static void toDisplayUnits(size_t count, double* amplitudes, double* phases, bool isDegrees);
+
+    /** Calls body(begin, end) over [0, count) in chunks of whole blocks, on the
+     * pool's workers when the points times the factors per point make it worth
+     * it, on the calling thread otherwise. */
+    static void forEachChunk(
+        size_t count,
+        size_t factorsPerPoint,
+        WorkerPool* pool,
+        int maxWorkers,
+        const std::function<void(size_t begin, size_t end)>& body);
+
+    /** Maps a phase in radians to [-phaseAmplitude, phaseAmplitude) in the units of phaseUnitCoeff */
+    static double wrapPhase(double phase, double phaseUnitCoeff, double phaseAmplitude);
 private:
     inline static void calculateCoefficients(
         double angle,
@@ -28,6 +199,141 @@ private:
         double& ampCoeff,
         double& phaseCoeff);
 
+    /** Product of the factors (x - root) over x = (cosines[i], sines[i]) as
+     * (re[i] + i im[i]) 2^exponent[i], with re and im below 2 in magnitude;
+     * the roots' delayTerm times their order and delaySign added to delays if given */
+    static void accumulate(
+        const RootSnapshot::Roots& roots,
+        const double* cosines,
+        const double* sines,
+        size_t count,
+        double* re,
+        double* im,
+        int* exponent,
+        double* delays,
+        double delaySign);
+    static void renormalise(size_t count, double* re, double* im, int* exponent);
+    /** evaluateParts for at most blockSize points */
+    static void evaluateBlock(
+        const RootSnapshot& snapshot,
+        const double* cosines,
+        const double* sines,
+        size_t count,
+        double* logZeros,
+        double* logPoles,
+        double* phases,
+        double* groupDelays);
+    static void fillAngles(
+        size_t begin,
+        size_t end,
+        double minAngle,
+        bool isLogScale,
+        size_t width,
+        double bandBegin,
+        double bandEnd,
+        double* angles);
+    /** evaluates the points at the given positions and angles, positions
+     * increasing, and merges them into samples, leaving out existing positions */
+    static void addSamples(
+        const RootSnapshot& snapshot,
+        const std::vector<double>& positions,
+        const std::vector<double>& angles,
+        bool isDegrees,
+        ResponseSamples& samples);
+
+    /** points evaluated together, the accumulators of a block stay in L1 */
+    static constexpr size_t blockSize = 256;
+    /** factors multiplied in between renormalisations: 8 can't leave the
+     * range of a double for roots within 1e8 of the unit circle */
+    static constexpr int renormaliseEvery = 8;
+    /** points times factors below which calculate stays on the calling thread;
+     * pointCost stands for the per point log, atan2, exp and so on */
+    static constexpr size_t parallelMinWork = 1 << 17;
+    static constexpr size_t pointCost = 16;
+    static constexpr size_t chunksPerWorker = 4;
+    /** calculate evaluates linear grids of at least fftMinWidth points and
+     * fftMinFactors factors with evaluateUniform */
+    static constexpr size_t fftMinWidth = 4096;
+    static constexpr size_t fftMinFactors = 48;
+    /** the degree the roots are dealt out to groups for, before splitting */
+    static constexpr size_t fftGroupDegree = 64;
+    /** The rounding error of a group's values is about eps times the product
+     * of 1 + |root| over its roots, whatever the values. The groups are kept
+     * below this, about 20 roots near the unit circle, and values below
+     * fftTrustRatio times it are evaluated directly from the roots, which
+     * keeps the relative error of every value within about 1e-8. */
+    static constexpr double fftMaxRootProduct = 1 << 20;
+    static constexpr double fftTrustRatio = 4e-7;
+    /** pairs of groups multiplied in between renormalisations */
+    static constexpr int fftRenormaliseEvery = 4;
+    /** refine puts points around the roots closer than resonanceRadius to the
+     * unit circle, at these offsets in units of the distance, which is about
+     * the half power width of the peak or notch; the distance is taken as at
+     * least minResonanceWidth for roots on the circle */
+    static constexpr double resonanceRadius = 0.1;
+    static constexpr double minResonanceWidth = 1e-9;
+    static constexpr double resonanceOffsets[] = { 0.0, -0.5, 0.5, -2.0, 2.0 };
+    /** refine's passes over the curvature, and the narrowest interval it splits
+     * as a fraction of the band */
+    static constexpr int refinePasses = 4;
+    static constexpr double refineMinSpacing = 1e-9;
+
     static constexpr double eps = std::numeric_limits<double>::epsilon();
     static constexpr double pi = juce::MathConstants<double>::pi;
+};
+
+/** The response over a fixed grid, brought up to date with each new snapshot
+ * of the roots.
+ * It's kept as sums of the terms of the roots: ln|zeros|, ln|poles| and the
+ * phase at every point. When a snapshot has the same roots as the last one,
+ * only moved or with other orders, as while a root is dragged, the terms of
+ * those roots are taken out and put back in with their new values: O(width)
+ * per root rather than O(width x roots). The old term is calculated again
+ * from the last snapshot instead of being stored for every root, the same
+ * numbers for a fraction of the memory.
+ * A full evaluation happens when roots were added or removed, when too many
+ * moved, when a root was exactly on a grid point, and every fullEvery updates
+ * to bound the rounding drift of the sums.
+ */
+class IncrementalResponse
+{
+public:
+    /** Sets the points of the unit circle, which invalidates the response */
+    void setGrid(const std::vector<double>& angles);
+
+    /** Returns true if the update was incremental */
+    bool update(const RootSnapshot& snapshot, WorkerPool* pool = nullptr);
+
+    /** ln|H| without the gain, arg H in (-pi, pi] and, if asked, the group
+     * delay, as evaluate */
+    void getResponse(double* logMagnitudes, double* phases, double* groupDelays = nullptr) const;
+
+    size_t size() const { return cosines.size(); }
+    u32 getFullUpdates() const { return fullUpdates; }
+    u32 getIncrementalUpdates() const { return incrementalUpdates; }
+
+private:
+    void evaluateFull(const RootSnapshot& snapshot, WorkerPool* pool);
+    /** moves the terms of the roots that differ between from and to, false if
+     * a term was singular on the grid */
+    bool updateTerms(const RootSnapshot::Roots& from, const RootSnapshot::Roots& to, double* logs, double phaseSign);
+    /** the delayTerm of root k, both of a pair's, at point i */
+    double delayTerms(const RootSnapshot::Roots& rootSet, size_t k, size_t i) const;
+    /** x - root or, for a pair, (x - root)(x - conj(root)) at point i */
+    c128 term(const RootSnapshot::Roots& rootSet, size_t k, size_t i) const;
+    static bool isSameRoot(const RootSnapshot::Roots& a, const RootSnapshot::Roots& b, size_t k);
+
+    std::vector<double> cosines, sines;
+    std::vector<double> logZeros, logPoles, phases, groupDelays;
+    RootSnapshot roots;
+    bool isValid = false;
+    int sinceFull = 0;
+    u32 fullUpdates = 0, incrementalUpdates = 0;
+
+    /** incremental updates in between full evaluations */
+    static constexpr int fullEvery = 64;
+    /** a moved root costs about this many factors of a full evaluation: a
+     * log and an atan2 per point against a complex multiply */
+    static constexpr size_t movedRootCost = 4;
+    static constexpr double pi = juce::MathConstants<double>::pi;
 };
\ No newline at end of file
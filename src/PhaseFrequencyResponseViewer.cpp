@@ -11,10 +11,15 @@ PhaseFrequencyResponseViewer::PhaseFrequencyResponseViewer(AudioPluginAudioProce
     logScaleButton("Log"),
 	freqButton("Freq."),
     phaseButton("Phase"),
-    bothButton("Both")
+    bothButton("Both"),
+    argButton("Arg"),
+    groupDelayButton("Grp. d."),
+    phaseDelayButton("Ph. d."),
+    spectrumButton("Spectrum")
 {
     this->processor->addChangeListener(this);
     this->processor->filterState->um->addChangeListener(this);
+    responseWorker.addChangeListener(this);
 
     freqButton.onClick = [this] { changePlotsSet(); };
     freqButton.setClickingTogglesState(true);
@@ -32,6 +37,22 @@ PhaseFrequencyResponseViewer::PhaseFrequencyResponseViewer(AudioPluginAudioProce
     bothButton.setToggleState(true, juce::dontSendNotification);
     bothButton.setTooltip("Show frequency and phase response plots");
 
+    argButton.onClick = [this] { repaint(); };
+    argButton.setClickingTogglesState(true);
+    argButton.setRadioGroupId(3);
+    argButton.setToggleState(true, juce::dontSendNotification);
+    argButton.setTooltip("Show the phase in the phase response plot");
+
+    groupDelayButton.onClick = [this] { repaint(); };
+    groupDelayButton.setClickingTogglesState(true);
+    groupDelayButton.setRadioGroupId(3);
+    groupDelayButton.setTooltip("Show the group delay in samples in the phase response plot");
+
+    phaseDelayButton.onClick = [this] { repaint(); };
+    phaseDelayButton.setClickingTogglesState(true);
+    phaseDelayButton.setRadioGroupId(3);
+    phaseDelayButton.setTooltip("Show the phase delay in samples in the phase response plot");
+
     zoomInButton.onClick = [this]
         {
             if (ampDb > minAmpDb)
@@ -52,37 +73,50 @@ PhaseFrequencyResponseViewer::PhaseFrequencyResponseViewer(AudioPluginAudioProce
         };
     zoomOutButton.setTooltip("Zoom out");
 
-    logScaleButton.onClick = [this] { repaint(); };
+    // NOTE: the band is a part of the axis, which is another range of frequencies on the other scale
+    logScaleButton.onClick = [this] { setBand(0.0, 1.0); };
     logScaleButton.setClickingTogglesState(true);
     logScaleButton.setRadioGroupId(2);
     logScaleButton.setEnabled(sampleRate > 0);
     logScaleButton.setTooltip("Logarithmic X scale");
 
-    linearScaleButton.onClick = [this] { repaint(); };
+    linearScaleButton.onClick = [this] { setBand(0.0, 1.0); };
     linearScaleButton.setClickingTogglesState(true);
     linearScaleButton.setRadioGroupId(2);
     linearScaleButton.setEnabled(sampleRate > 0);
     linearScaleButton.setTooltip("Linear X scale");
     linearScaleButton.setToggleState(true, juce::sendNotificationSync);
 
+    spectrumButton.onClick = [this] { toggleSpectrum(); };
+    spectrumButton.setClickingTogglesState(true);
+    spectrumButton.setTooltip("Overlay the measured output spectrum and show input/output levels");
+
     addAndMakeVisible(freqButton);
     addAndMakeVisible(phaseButton);
     addAndMakeVisible(bothButton);
+    addAndMakeVisible(argButton);
+    addAndMakeVisible(groupDelayButton);
+    addAndMakeVisible(phaseDelayButton);
     addAndMakeVisible(zoomInButton);
     addAndMakeVisible(zoomOutButton);
     addAndMakeVisible(linearScaleButton);
     addAndMakeVisible(logScaleButton);
+    addAndMakeVisible(spectrumButton);
 }
 
 PhaseFrequencyResponseViewer::~PhaseFrequencyResponseViewer()
 {
+    stopTimer();
+    responseWorker.removeChangeListener(this);
+    if (spectrumButton.getToggleState())
+        processor->analysisTap.stopAnalysis();
     processor->filterState->um->removeChangeListener(this);
     processor->removeChangeListener(this);
 }
 
 void PhaseFrequencyResponseViewer::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
-    if (source == processor->filterState->um)
+    if (source == processor->filterState->um || source == &responseWorker)
         repaint();
     else if (source == processor)
     {
@@ -98,16 +132,90 @@ void PhaseFrequencyResponseViewer::resized()
     freqButton.setBounds(padding, padding, plotButtonsWidth, zoomButtonsSize);
     phaseButton.setBounds(freqButton.getRight() + padding, padding, plotButtonsWidth, zoomButtonsSize);
     bothButton.setBounds(phaseButton.getRight() + padding, padding, plotButtonsWidth, zoomButtonsSize);
+    argButton.setBounds(bothButton.getRight() + 3 * padding, padding, plotButtonsWidth, zoomButtonsSize);
+    groupDelayButton.setBounds(argButton.getRight() + padding, padding, plotButtonsWidth, zoomButtonsSize);
+    phaseDelayButton.setBounds(groupDelayButton.getRight() + padding, padding, plotButtonsWidth, zoomButtonsSize);
 
     logScaleButton.setBounds(getWidth() - padding - scaleButtonsWidth, padding, scaleButtonsWidth, zoomButtonsSize);
     linearScaleButton.setBounds(logScaleButton.getX() - padding - scaleButtonsWidth, padding, scaleButtonsWidth, zoomButtonsSize);
 
     zoomOutButton.setBounds(padding, logScaleButton.getBottom() + padding, zoomButtonsSize, zoomButtonsSize);
     zoomInButton.setBounds(2 * padding + zoomButtonsSize, logScaleButton.getBottom() + padding, zoomButtonsSize, zoomButtonsSize);
+    spectrumButton.setBounds(getWidth() - padding - spectrumButtonWidth, logScaleButton.getBottom() + padding, spectrumButtonWidth, zoomButtonsSize);
 
     repaint();
 }
 
+void PhaseFrequencyResponseViewer::mouseWheelMove(const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel)
+{
+    const auto width = getWidth() - plotPaddingLeft - plotPaddingRight;
+    if (width <= 0)
+        return;
+
+    // the frequency under the mouse stays where it is
+    const double at = juce::jlimit(0.0, 1.0, (e.position.x - plotPaddingLeft) / width);
+    const double anchor = bandBegin + at * (bandEnd - bandBegin);
+    const double bandWidth = (bandEnd - bandBegin) / std::pow(wheelZoomBase, wheel.deltaY);
+    setBand(anchor - at * bandWidth, anchor + (1.0 - at) * bandWidth);
+}
+
+void PhaseFrequencyResponseViewer::mouseDown(const juce::MouseEvent&)
+{
+    dragBandBegin = bandBegin;
+}
+
+void PhaseFrequencyResponseViewer::mouseDrag(const juce::MouseEvent& e)
+{
+    const auto width = getWidth() - plotPaddingLeft - plotPaddingRight;
+    if (width <= 0)
+        return;
+
+    const double bandWidth = bandEnd - bandBegin;
+    const double begin = dragBandBegin - bandWidth * e.getDistanceFromDragStartX() / width;
+    setBand(begin, begin + bandWidth);
+}
+
+void PhaseFrequencyResponseViewer::mouseDoubleClick(const juce::MouseEvent&)
+{
+    setBand(0.0, 1.0);
+}
+
+void PhaseFrequencyResponseViewer::setBand(double begin, double end)
+{
+    const double bandWidth = juce::jlimit(minBandWidth, 1.0, end - begin);
+    bandBegin = juce::jlimit(0.0, 1.0 - bandWidth, begin);
+    bandEnd = bandBegin + bandWidth;
+    repaint();
+}
+
+double PhaseFrequencyResponseViewer::frequencyAt(double position, bool isLogScale) const
+{
+    if (juce::exactlyEqual(sampleRate, 0.0))
+        return position;
+    if (!isLogScale)
+        return position * sampleRate / 2;
+
+    const double logMinFreq = std::log10(static_cast<double>(minFreq));
+    const double logMaxFreq = std::log10(sampleRate / 2);
+    return std::pow(10., logMinFreq + (logMaxFreq - logMinFreq) * position);
+}
+
+juce::String PhaseFrequencyResponseViewer::frequencyText(double freq, double resolution) const
+{
+    const int decimals = juce::jlimit(0, 4, static_cast<int>(std::ceil(-std::log10(resolution))));
+    if (juce::exactlyEqual(sampleRate, 0.0))
+    {
+        if (juce::exactlyEqual(freq, 0.0))
+            return "0";
+        if (juce::exactlyEqual(freq, 0.5))
+            return "pi/2";
+        if (juce::exactlyEqual(freq, 1.0))
+            return "pi";
+        return juce::String(freq, decimals) + "pi";
+    }
+    return decimals == 0 ? juce::String(juce::roundToInt(freq)) : juce::String(freq, decimals);
+}
+
 void PhaseFrequencyResponseViewer::paint(juce::Graphics& g)
 {
     //PROFILE_FUNCTION();
@@ -132,30 +240,169 @@ void PhaseFrequencyResponseViewer::paint(juce::Graphics& g)
         return;
 
     // angles, amplitudes & phases
+    // NOTE: until the worker catches up this is the response for the last
+    // request it finished, a drag shows the root a step behind
     const bool isLogScale = logScaleButton.getToggleState();
-    std::vector<double> angles, amplitudes, phases;
-    PhaseFrequencyResponseCalculator::calculate(
-        processor->filterState.get(),
-        minFreq,
-        sampleRate,
-        isLogScale, true, width, angles, amplitudes, phases);
+    const auto response = updateResponse(width, isLogScale);
+    if (response == nullptr)
+        return;
 
     if (!phaseButton.getToggleState())
-        paintPlot(g, amplitudes, isLogScale, ampDb, " dB", topFreq, bottomFreq);
+    {
+        paintPlot(g, response->samples.positions, response->samples.amplitudes, isLogScale, ampDb, " dB", topFreq, bottomFreq);
+        if (spectrumButton.getToggleState())
+            paintSpectrumOverlay(g, isLogScale, topFreq, bottomFreq);
+    }
     if (!freqButton.getToggleState())
-        paintPlot(g, phases, isLogScale, 180., " deg.", topPhase, bottomPhase);
+    {
+        const auto& samples = response->samples;
+        if (groupDelayButton.getToggleState())
+            paintPlot(g, samples.positions, samples.groupDelays, isLogScale, delayAmplitude(samples.groupDelays), " smp.", topPhase, bottomPhase);
+        else if (phaseDelayButton.getToggleState())
+            paintPlot(g, samples.positions, response->phaseDelays, isLogScale, delayAmplitude(response->phaseDelays), " smp.", topPhase, bottomPhase);
+        else
+            paintPlot(g, samples.positions, samples.phases, isLogScale, 180., " deg.", topPhase, bottomPhase);
+    }
+
+    if (spectrumButton.getToggleState())
+        paintLevels(g);
+}
+
+std::shared_ptr<const PhaseFrequencyResponseWorker::Result> PhaseFrequencyResponseViewer::updateResponse(int width, bool isLogScale)
+{
+    PhaseFrequencyResponseWorker::Request request;
+    request.revision = processor->filterState->revision;
+    request.minFreq = minFreq;
+    request.sampleRate = sampleRate;
+    request.isLogScale = isLogScale;
+    request.bandBegin = bandBegin;
+    request.bandEnd = bandEnd;
+    request.gridSize = static_cast<size_t>(std::max(2, width / gridSpacing));
+    request.refineBudget = static_cast<size_t>(width / refinedSpacing);
+
+    if (hasRequested && request.revision == requested.revision && request.hasSameGrid(requested)
+        && request.refineBudget == requested.refineBudget)
+    {
+        cacheHits++;
+        return responseWorker.getResult();
+    }
+
+    // NOTE: the roots are read here, on the message thread; the worker only
+    // ever sees the snapshot
+    cacheMisses++;
+    request.snapshot.capture(*processor->filterState);
+    requested = request;
+    hasRequested = true;
+    responseWorker.request(std::move(request));
+    return responseWorker.getResult();
+}
+
+float PhaseFrequencyResponseViewer::delayAmplitude(const std::vector<double>& delays) const
+{
+    double largest = 0.0;
+    for (double delay : delays)
+    {
+        if (std::isfinite(delay))
+            largest = std::max(largest, std::abs(delay));
+    }
+
+    float amplitude = minDelayAmplitude;
+    while (amplitude < largest && amplitude < maxDelayAmplitude)
+        amplitude *= 2.f;
+    return amplitude;
+}
+
+void PhaseFrequencyResponseViewer::timerCallback()
+{
+    repaint();
+}
+
+void PhaseFrequencyResponseViewer::toggleSpectrum()
+{
+    if (spectrumButton.getToggleState())
+    {
+        processor->analysisTap.startAnalysis();
+        startTimerHz(spectrumRefreshHz);
+    }
+    else
+    {
+        stopTimer();
+        processor->analysisTap.stopAnalysis();
+    }
+    repaint();
+}
+
+void PhaseFrequencyResponseViewer::paintSpectrumOverlay(
+    juce::Graphics& g,
+    bool isLogScale,
+    int top,
+    int bottom)
+{
+    // NOTE: the measured spectrum is in dBFS, drawn against the same dB axis
+    // as the analytic response
+    double binWidth = 0;
+    if (sampleRate <= 0 || !processor->analysisTap.getOutputSpectrum(spectrumDb, binWidth) || binWidth <= 0)
+        return;
+
+    const auto width = getWidth() - plotPaddingLeft - plotPaddingRight;
+    juce::Rectangle<int> rect(plotPaddingLeft, top, width, bottom - top);
+    const juce::Graphics::ScopedSaveState state(g);
+    g.reduceClipRegion(rect);
+
+    const auto lastBin = static_cast<double>(spectrumDb.size() - 1);
+    juce::Path path;
+    for (int i = 0; i < width; i++)
+    {
+        const double freq = frequencyAt(bandBegin + (bandEnd - bandBegin) * i / width, isLogScale);
+        const double bin = juce::jlimit(0.0, lastBin, freq / binWidth);
+        const auto bin0 = static_cast<size_t>(bin);
+        const auto bin1 = std::min(bin0 + 1, spectrumDb.size() - 1);
+        const float frac = static_cast<float>(bin - static_cast<double>(bin0));
+        const float db = spectrumDb[bin0] + frac * (spectrumDb[bin1] - spectrumDb[bin0]);
+
+        const float x = static_cast<float>(plotPaddingLeft + i);
+        const float y = juce::jmap(db, -ampDb, ampDb, static_cast<float>(bottom), static_cast<float>(top));
+        if (i == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    g.setColour(spectrumColour);
+    g.strokePath(path, juce::PathStrokeType(1.5f));
+}
+
+void PhaseFrequencyResponseViewer::paintLevels(juce::Graphics& g)
+{
+    const auto toDb = [](float gain) { return juce::String(juce::Decibels::gainToDecibels(gain), 1); };
+    const auto in = processor->analysisTap.getInputLevels();
+    const auto out = processor->analysisTap.getOutputLevels();
+
+    const int left = zoomInButton.getRight() + padding;
+    g.setColour(spectrumColour);
+    g.drawText(
+        "in " + toDb(in.rms) + " (" + toDb(in.peak) + ")  out " + toDb(out.rms) + " (" + toDb(out.peak) + ") dBFS",
+        left,
+        spectrumButton.getY(),
+        spectrumButton.getX() - padding - left,
+        zoomButtonsSize,
+        juce::Justification::centred);
 }
 
 void PhaseFrequencyResponseViewer::changePlotsSet()
 {
     zoomInButton.setVisible(!phaseButton.getToggleState());
     zoomOutButton.setVisible(!phaseButton.getToggleState());
+    argButton.setVisible(!freqButton.getToggleState());
+    groupDelayButton.setVisible(!freqButton.getToggleState());
+    phaseDelayButton.setVisible(!freqButton.getToggleState());
     repaint();
 }
 
 void PhaseFrequencyResponseViewer::paintPlot(
     juce::Graphics& g,
-    std::vector<double>& yValues,
+    const std::vector<double>& positions,
+    const std::vector<double>& yValues,
     bool isLogScale,
     float yAmplitude,
     juce::String unitText,
@@ -198,25 +445,29 @@ void PhaseFrequencyResponseViewer::paintPlot(
         textHeight,
         juce::Justification::centredRight);
 
-    // X grid
+    // X grid, over the visible band of the axis
     const int hzTextY = static_cast<int>(yBottom) + padding;
-    if (isLogScale)
-    {
-        g.setColour(lineColour);
-        g.drawText(
-            juce::String(static_cast<int>(minFreq)),
-            plotPaddingLeft - textWidth / 2,
-            hzTextY,
-            textWidth,
-            textHeight,
-            juce::Justification::centred);
-        g.drawText(
-            juce::String(static_cast<int>(sampleRate / 2)),
-            static_cast<int>(xRight) - textWidth / 2,
-            hzTextY,
-            textWidth,
-            textHeight,
-            juce::Justification::centred);
+    const double bandWidth = bandEnd - bandBegin;
+    const double freqBegin = frequencyAt(bandBegin, isLogScale);
+    const double freqEnd = frequencyAt(bandEnd, isLogScale);
+    const double resolution = (freqEnd - freqBegin) / 100;
+
+    g.setColour(lineColour);
+    g.drawText(
+        frequencyText(freqBegin, resolution),
+        plotPaddingLeft - textWidth / 2,
+        hzTextY,
+        textWidth,
+        textHeight,
+        juce::Justification::centred);
+    g.drawText(
+        frequencyText(freqEnd, resolution),
+        static_cast<int>(xRight) - textWidth / 2,
+        hzTextY,
+        textWidth,
+        textHeight,
+        juce::Justification::centred);
+    if (!juce::exactlyEqual(sampleRate, 0.0))
         g.drawText(
             " Hz",
             static_cast<int>(xRight) + textWidth / 2,
@@ -225,63 +476,43 @@ void PhaseFrequencyResponseViewer::paintPlot(
             textHeight,
             juce::Justification::centredLeft);
 
-        const float maxFreq = static_cast<float>(sampleRate / 2.0);
-        const float logMaxFreq = std::log10(maxFreq);
-        const float logMinFreq = std::log10(minFreq);
-        const float freqCoeff = width / (logMaxFreq - logMinFreq);
+    if (isLogScale)
+    {
+        const double maxFreq = sampleRate / 2.0;
+        const double logMaxFreq = std::log10(maxFreq);
+        const double logMinFreq = std::log10(static_cast<double>(minFreq));
 
-        int freq = static_cast<int>(minFreq * 10);
-        while (freq < maxFreq)
+        for (double freq = minFreq * 10.0; freq < maxFreq; freq *= 10)
         {
-            int x = static_cast<int>(freqCoeff * (std::log10(freq) - logMinFreq) + plotPaddingLeft);
+            const double position = (std::log10(freq) - logMinFreq) / (logMaxFreq - logMinFreq);
+            if (position <= bandBegin || position >= bandEnd)
+                continue;
+
+            int x = static_cast<int>(width * (position - bandBegin) / bandWidth + plotPaddingLeft);
             g.setColour(gridColour);
             g.drawLine(x, yTop, x, yBottom);
-            if (xRight - x > textWidth)
+            if (xRight - x > textWidth && x - xLeft > textWidth)
             {
                 g.setColour(lineColour);
                 g.drawText(
-                    juce::String(freq),
+                    frequencyText(freq, resolution),
                     x - textWidth / 2,
                     hzTextY,
                     textWidth,
                     textHeight,
                     juce::Justification::centred);
             }
-            freq *= 10;
         }
     }
     else
     {
-        g.setColour(lineColour);
-        g.drawText(
-            "0",
-            plotPaddingLeft - textWidth / 2,
-            hzTextY,
-            textWidth,
-            textHeight,
-            juce::Justification::centred);
         g.drawText(
-            juce::exactlyEqual(sampleRate, 0.0) ? "pi/2" : juce::String(static_cast<int>(sampleRate / 4)),
+            frequencyText(frequencyAt(bandBegin + bandWidth / 2, isLogScale), resolution),
             plotPaddingLeft + (width - textWidth) / 2,
             hzTextY,
             textWidth,
             textHeight,
             juce::Justification::centred);
-        g.drawText(
-            juce::exactlyEqual(sampleRate, 0.0) ? "pi" : juce::String(static_cast<int>(sampleRate / 2)),
-            static_cast<int>(xRight) - textWidth / 2,
-            hzTextY,
-            textWidth,
-            textHeight,
-            juce::Justification::centred);
-        if (!juce::exactlyEqual(sampleRate, 0.0))
-            g.drawText(
-                " Hz",
-                static_cast<int>(xRight) + textWidth / 2,
-                hzTextY,
-                textWidth,
-                textHeight,
-                juce::Justification::centredLeft);
 
         g.setColour(gridColour);
         int x = plotPaddingLeft + width / 2;
@@ -301,18 +532,26 @@ void PhaseFrequencyResponseViewer::paintPlot(
         gradient.addColour(0.5, juce::Colours::yellow.withAlpha(0.75f));
         g.setGradientFill(gradient);
 
-        juce::Path path;
-        auto x = xLeft;
-        auto y = juce::jmap(static_cast<float>(yValues[0]), -yAmplitude, yAmplitude, yBottom, yTop);
-        g.drawLine(x, rect.getCentreY(), x, y);
-        path.startNewSubPath(x, y);
-        for (int i = 1; i < width; i++)
+        // NOTE: the samples aren't evenly spaced, so the area down to the centre is
+        // filled as one path rather than a line per pixel
+        const float yCentre = static_cast<float>(rect.getCentreY());
+        juce::Path path, area;
+        for (size_t i = 0; i < positions.size(); i++)
         {
-            x++;
-            y = juce::jmap(static_cast<float>(yValues[static_cast<size_t>(i)]), -yAmplitude, yAmplitude, yBottom, yTop);
-            g.drawLine(x, rect.getCentreY(), x, y);
-            path.lineTo(x, y);
+            const auto x = xLeft + static_cast<float>(positions[i] * width);
+            const auto y = juce::jmap(static_cast<float>(yValues[i]), -yAmplitude, yAmplitude, yBottom, yTop);
+            if (i == 0)
+            {
+                path.startNewSubPath(x, y);
+                area.startNewSubPath(x, yCentre);
+            }
+            else
+                path.lineTo(x, y);
+            area.lineTo(x, y);
         }
+        area.lineTo(area.getCurrentPosition().x, yCentre);
+        area.closeSubPath();
+        g.fillPath(area);
 
         g.setColour(lineColour);
         g.strokePath(path, strokeType);
@@ -1,8 +1,10 @@
 #pragma once
+#include "PhaseFrequencyResponseWorker.h"
 
 class PhaseFrequencyResponseViewer final :
     public juce::Component,
-    juce::ChangeListener
+    juce::ChangeListener,
+    juce::Timer
 {
 public:
     PhaseFrequencyResponseViewer(AudioPluginAudioProcessor* p);
@@ -12,11 +14,50 @@ public:
     void resized() override;
     void paint(juce::Graphics& g) override;
 
+    /** the wheel zooms the X axis around the mouse, dragging pans it and a
+     * double click shows the whole axis again */
+    void mouseWheelMove(const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel) override;
+    void mouseDown(const juce::MouseEvent& e) override;
+    void mouseDrag(const juce::MouseEvent& e) override;
+    void mouseDoubleClick(const juce::MouseEvent& e) override;
+
+    /** how often paint found the response it needed already asked for, and
+     * how often it had to ask the worker for it */
+    u32 getCacheHits() const { return cacheHits; }
+    u32 getCacheMisses() const { return cacheMisses; }
+
 private:
+    /** Asks the worker for the response if any of its keys changed since the
+     * last request, and returns the last one it published, nullptr if none.
+     * The dB zoom, the plots set and the spectrum overlay only change how
+     * it's drawn. */
+    std::shared_ptr<const PhaseFrequencyResponseWorker::Result> updateResponse(int width, bool isLogScale);
+
+    /** shows the part of the X axis from begin to end, fractions of the whole
+     * axis, kept inside it and no narrower than minBandWidth */
+    void setBand(double begin, double end);
+    /** the frequency at a position on the whole X axis, in Hz, or in units of
+     * pi without a sample rate */
+    double frequencyAt(double position, bool isLogScale) const;
+    /** a frequency of the X axis with as many decimals as resolution needs */
+    juce::String frequencyText(double freq, double resolution) const;
+
+    /** the Y range of a delay plot, a power of 2 samples above its largest delay */
+    float delayAmplitude(const std::vector<double>& delays) const;
+
+    void timerCallback() override;
     void changePlotsSet();
+    void toggleSpectrum();
+    void paintSpectrumOverlay(
+        juce::Graphics& g,
+        bool isLogScale,
+        int top,
+        int bottom);
+    void paintLevels(juce::Graphics& g);
     void paintPlot(
         juce::Graphics& g,
-        std::vector<double>& yValues,
+        const std::vector<double>& positions,
+        const std::vector<double>& yValues,
         bool isLogScale,
         float yAmplitude,
         juce::String unitText,
@@ -26,7 +67,8 @@ private:
     const juce::Colour
         backgroundColor = juce::Colour(0x08, 0x0C, 0x1C),
         lineColour = juce::Colours::white,
-        gridColour = juce::Colours::darkgrey;
+        gridColour = juce::Colours::darkgrey,
+        spectrumColour = juce::Colours::cyan.withAlpha(0.8f);
     const juce::PathStrokeType strokeType{ 3.f };
     const int
         padding = 5,
@@ -39,22 +81,46 @@ private:
         zoomButtonsSize = 20,
         plotButtonsWidth = 45,
         scaleButtonsWidth = 45,
+        spectrumButtonWidth = 70,
+        spectrumRefreshHz = 15,
         textWidth = 40,
         textHeight = 10;
+    /** the uniform grid has a point every gridSpacing pixels, and refine adds
+     * one more per refinedSpacing pixels where the response needs it */
+    const int
+        gridSpacing = 2,
+        refinedSpacing = 4;
     const float
         minAmpDb = 6.f,
         maxAmpDb = 96.f,
-        minFreq = 20.f;
+        minFreq = 20.f,
+        minDelayAmplitude = 4.f,
+        maxDelayAmplitude = 65536.f;
+    /** the narrowest band, a few mHz of the linear axis at 48 kHz, and the
+     * zoom per unit of wheel movement */
+    const double
+        minBandWidth = 1e-7,
+        wheelZoomBase = 8.0;
 
 	AudioPluginAudioProcessor* processor;
 
     float ampDb;
     double sampleRate;
+    /** the visible part of the X axis, fractions of the whole axis */
+    double bandBegin = 0.0, bandEnd = 1.0, dragBandBegin = 0.0;
 
     juce::TextButton
         zoomInButton, zoomOutButton,
         linearScaleButton, logScaleButton,
-        freqButton, phaseButton, bothButton;
+        freqButton, phaseButton, bothButton,
+        argButton, groupDelayButton, phaseDelayButton,
+        spectrumButton;
+    std::vector<float> spectrumDb;
+    PhaseFrequencyResponseWorker responseWorker;
+    /** the last request, to tell if the next one differs */
+    PhaseFrequencyResponseWorker::Request requested;
+    bool hasRequested = false;
+    u32 cacheHits = 0, cacheMisses = 0;
 };
 
 // NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
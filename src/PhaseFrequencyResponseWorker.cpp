@@ -0,0 +1,135 @@
+#include "PhaseFrequencyResponseWorker.h"
+
+bool PhaseFrequencyResponseWorker::Request::hasSameGrid(const Request& other) const
+{
+    return gridSize == other.gridSize
+        && isLogScale == other.isLogScale
+        && juce::exactlyEqual(minFreq, other.minFreq)
+        && juce::exactlyEqual(sampleRate, other.sampleRate)
+        && juce::exactlyEqual(bandBegin, other.bandBegin)
+        && juce::exactlyEqual(bandEnd, other.bandEnd);
+}
+
+PhaseFrequencyResponseWorker::PhaseFrequencyResponseWorker()
+    : juce::Thread("Response worker")
+{
+    startThread();
+}
+
+PhaseFrequencyResponseWorker::~PhaseFrequencyResponseWorker()
+{
+    stopThread(1000);
+}
+
+void PhaseFrequencyResponseWorker::request(Request newRequest)
+{
+    {
+        const juce::ScopedLock lock(requestLock);
+        pending = std::move(newRequest);
+        hasPending = true;
+    }
+    notify();
+}
+
+std::shared_ptr<const PhaseFrequencyResponseWorker::Result> PhaseFrequencyResponseWorker::getResult() const
+{
+    const juce::SpinLock::ScopedLockType lock(resultLock);
+    return front;
+}
+
+void PhaseFrequencyResponseWorker::run()
+{
+    while (!threadShouldExit())
+    {
+        Request next;
+        bool hasNext = false;
+        {
+            const juce::ScopedLock lock(requestLock);
+            std::swap(hasNext, hasPending);
+            if (hasNext)
+                next = std::move(pending);
+        }
+
+        if (!hasNext)
+        {
+            wait(-1);
+            continue;
+        }
+
+        // NOTE: the back buffer is the front one of the last swap, unless a
+        // reader still holds that; then it's left to the reader
+        if (back == nullptr || back.use_count() > 1)
+            back = std::make_shared<Result>();
+        calculate(next, *back);
+
+        {
+            const juce::SpinLock::ScopedLockType lock(resultLock);
+            std::swap(front, back);
+        }
+        sendChangeMessage();
+    }
+}
+
+void PhaseFrequencyResponseWorker::calculate(const Request& request, Result& result)
+{
+    const auto gridSize = request.gridSize;
+    if (!hasGrid || !request.hasSameGrid(gridRequest))
+    {
+        // NOTE: a zoomed band is evaluated at as many points as the whole axis, so
+        // panning costs a full evaluation and dragging a root an incremental one, at any zoom
+        PhaseFrequencyResponseCalculator::calculateAngles(
+            request.minFreq, request.sampleRate, request.isLogScale, static_cast<int>(gridSize), angles, request.bandBegin, request.bandEnd);
+        engine.setGrid(angles);
+        gridRequest = request;
+        hasGrid = true;
+    }
+
+    // NOTE: only the roots changed since the last time, while one is dragged that's
+    // an incremental update of the engine
+    engine.update(request.snapshot, &pool.get());
+
+    amplitudes.resize(gridSize);
+    phases.resize(gridSize);
+    groupDelays.resize(gridSize);
+    engine.getResponse(amplitudes.data(), phases.data(), groupDelays.data());
+    PhaseFrequencyResponseCalculator::toDisplayUnits(gridSize, amplitudes.data(), phases.data(), true);
+
+    // the grid resolves the smooth parts, the refined points the peaks and notches in between
+    auto& samples = result.samples;
+    samples.positions.resize(gridSize);
+    for (size_t i = 0; i < gridSize; i++)
+        samples.positions[i] = static_cast<double>(i) / gridSize;
+    samples.angles = angles;
+    samples.amplitudes = amplitudes;
+    samples.phases = phases;
+    samples.groupDelays = groupDelays;
+    PhaseFrequencyResponseCalculator::refine(
+        request.snapshot,
+        request.minFreq,
+        request.sampleRate,
+        request.isLogScale,
+        true,
+        request.refineBudget,
+        samples,
+        request.bandBegin,
+        request.bandEnd);
+
+    // the phases are in degrees by now
+    std::vector<double> radians(samples.size());
+    for (size_t i = 0; i < samples.size(); i++)
+        radians[i] = juce::degreesToRadians(samples.phases[i]);
+    result.phaseDelays.resize(samples.size());
+    PhaseFrequencyResponseCalculator::phaseDelays(
+        request.snapshot, samples.angles.data(), radians.data(), samples.groupDelays.data(), samples.size(), result.phaseDelays.data());
+
+    result.request = request;
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,83 @@
+#pragma once
+#include "PhaseFrequencyResponseCalculator.h"
+
+/** Calculates the response PhaseFrequencyResponseViewer draws on a background
+ * thread, so paint only ever reads a finished one.
+ * A request replaces any request still waiting: the latest wins, and a drag
+ * never queues up work for positions the root has already left. Each result
+ * is calculated into a back buffer that is then swapped with the front one
+ * under a spin lock, so a reader gets the whole of one result or the whole of
+ * the next. A change message is sent for every result published.
+ */
+class PhaseFrequencyResponseWorker final :
+    public juce::ChangeBroadcaster,
+    private juce::Thread
+{
+public:
+    /** what a response is calculated for */
+    struct Request
+    {
+        RootSnapshot snapshot;
+        u64 revision = 0;
+        float minFreq = 20.f;
+        double sampleRate = 0;
+        bool isLogScale = false;
+        double bandBegin = 0, bandEnd = 1;
+        /** points of the uniform grid, and points refine may add to it */
+        size_t gridSize = 0, refineBudget = 0;
+
+        /** true if both give the same grid of angles */
+        bool hasSameGrid(const Request& other) const;
+    };
+
+    struct Result
+    {
+        Request request;
+        /** the grid with the refined points, in display units, and their
+         * phase delays */
+        ResponseSamples samples;
+        std::vector<double> phaseDelays;
+    };
+
+    PhaseFrequencyResponseWorker();
+    ~PhaseFrequencyResponseWorker() override;
+
+    /** Queues a response to calculate, replacing the one waiting if any */
+    void request(Request newRequest);
+
+    /** The last result published, nullptr before the first. It stays valid
+     * for as long as it's held, whatever the worker publishes meanwhile. */
+    std::shared_ptr<const Result> getResult() const;
+
+private:
+    void run() override;
+    void calculate(const Request& request, Result& result);
+
+    // message thread -> worker
+    juce::CriticalSection requestLock;
+    Request pending;
+    bool hasPending = false;
+
+    // worker state: the uniform grid the engine keeps up to date
+    Request gridRequest;
+    bool hasGrid = false;
+    std::vector<double> angles, amplitudes, phases, groupDelays;
+    IncrementalResponse engine;
+    juce::SharedResourcePointer<WorkerPool> pool; // the editor's one set of threads, shared with the heat map
+    std::shared_ptr<Result> back;
+
+    // worker -> UI
+    mutable juce::SpinLock resultLock;
+    std::shared_ptr<Result> front;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PhaseFrequencyResponseWorker)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -28,6 +28,8 @@ PlayerComponent::PlayerComponent(AudioPluginAudioProcessor& p)
     loopButton.setClickingTogglesState(true);
     loopButton.onClick = [this] { updateLoopStatus(); };
 
+    addChildComponent(&loadProgressBar);
+
     this->processor.playerState.addChangeListener(this);
     changeListenerCallback(&this->processor.playerState);
 }
@@ -35,6 +37,7 @@ PlayerComponent::PlayerComponent(AudioPluginAudioProcessor& p)
 PlayerComponent::~PlayerComponent()
 {
     this->processor.playerState.removeChangeListener(this);
+    stopTimer();
 }
 
 void PlayerComponent::resized()
@@ -46,15 +49,35 @@ void PlayerComponent::resized()
     playButton.setBounds(distance, 0, buttonSize, buttonSize);
     stopButton.setBounds(2 * distance, 0, buttonSize, buttonSize);
     loopButton.setBounds(3 * distance, 0, buttonSize, buttonSize);
+    loadProgressBar.setBounds(distance, 0, getWidth() - distance, buttonSize);
 }
 
 void PlayerComponent::updateButtons(PlayerState playerState)
 {
-    openButton.setEnabled(playerState == PlayerState::Empty || playerState == PlayerState::Stopped);
-    playButton.setEnabled(playerState != PlayerState::Empty);
+    const bool isLoading = playerState == PlayerState::Loading;
+    openButton.setEnabled(playerState == PlayerState::Empty || playerState == PlayerState::Stopped || isLoading);
+    playButton.setEnabled(playerState != PlayerState::Empty && !isLoading);
     stopButton.setEnabled(playerState == PlayerState::Playing || playerState == PlayerState::Paused);
     loopButton.setEnabled(true);
     Utilities::setButtonImage(&playButton, playerState == PlayerState::Playing ? pauseImage : playImage);
+
+    for (auto* button : { &playButton, &stopButton, &loopButton })
+        button->setVisible(!isLoading);
+    loadProgressBar.setVisible(isLoading);
+    if (isLoading)
+    {
+        loadProgress = 0.0;
+        startTimerHz(30);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void PlayerComponent::timerCallback()
+{
+    loadProgress = processor.playerLoader.getProgress();
 }
 
 void PlayerComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
@@ -104,7 +127,5 @@ void PlayerComponent::stop()
 
 void PlayerComponent::updateLoopStatus()
 {
-    auto* src = processor.readerSource.get();
-    if (src != nullptr)
-        src->setLooping(loopButton.getToggleState());
+    processor.setPlayerLooping(loopButton.getToggleState());
 }
@@ -6,6 +6,7 @@
 class PlayerComponent 
 	: public juce::Component
 	, public juce::ChangeListener
+	, private juce::Timer
 {
 public:
 	PlayerComponent(AudioPluginAudioProcessor& p);
@@ -30,10 +31,14 @@ private:
 	void playPause();
 	void stop();
 	void updateLoopStatus();
+	void timerCallback() override;
 
 	juce::ImageButton openButton, playButton, stopButton, loopButton;
 	juce::Image openImage, playImage, pauseImage, stopImage, loopImage;
 
+	double loadProgress = 0.0;
+	juce::ProgressBar loadProgressBar{ loadProgress };   // covers the transport buttons while a file is preloading
+
 	AudioPluginAudioProcessor& processor;
 	std::unique_ptr<juce::FileChooser> chooser;
 
@@ -0,0 +1,180 @@
+#include "PlayerFileLoader.h"
+#include "SincResampler.h"
+
+class PlayerFileLoader::Job final : public juce::ThreadPoolJob
+{
+public:
+    Job(PlayerFileLoader& ownerToNotify, const juce::File& fileToLoad, double targetSampleRateToUse, int numChannelsToUse)
+        : juce::ThreadPoolJob("Player preload"), owner(ownerToNotify), file(fileToLoad), targetSampleRate(targetSampleRateToUse), numChannels(numChannelsToUse)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto reader = createReader();
+        // NOTE: AudioBuffer is indexed with ints, anything longer has to be streamed
+        if (reader != nullptr && reader->lengthInSamples <= std::numeric_limits<int>::max())
+        {
+            const bool needsResampling = SincResampler::isNeeded(reader->sampleRate, targetSampleRate);
+            // NOTE: when resampling, decoding counts as the first half of the progress
+            const double decodeShare = needsResampling ? 0.5 : 1.0;
+
+            const auto length = (int)reader->lengthInSamples;
+            buffer.setSize((int)reader->numChannels, length);
+
+            for (int position = 0; position < length; position += chunkSize)
+            {
+                if (shouldExit())
+                    return jobHasFinished;
+
+                const int numSamples = std::min(chunkSize, length - position);
+                reader->read(&buffer, position, numSamples, position, true, true);
+                progress.store(decodeShare * (double)(position + numSamples) / (double)length);
+            }
+
+            sampleRate = reader->sampleRate;
+            succeeded = !needsResampling || resample();
+            if (succeeded)
+                widen();
+        }
+
+        finished.store(true);
+        owner.sendChangeMessage();
+        return jobHasFinished;
+    }
+
+    bool resample()
+    {
+        SincResampler resampler(sampleRate, targetSampleRate);
+        const auto outputLength = resampler.getOutputLength(buffer.getNumSamples());
+        if (outputLength > std::numeric_limits<int>::max())
+            return false;
+
+        const auto length = (int)outputLength;
+        const int numChannels = buffer.getNumChannels();
+        juce::AudioBuffer<float> resampled(numChannels, length);
+        const juce::int64 total = (juce::int64)length * numChannels;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int position = 0; position < length; position += chunkSize)
+            {
+                if (shouldExit())
+                    return false;
+
+                const int numSamples = std::min(chunkSize, length - position);
+                resampler.process(buffer.getReadPointer(ch), buffer.getNumSamples(), position * resampler.getRatio(),
+                                  resampled.getWritePointer(ch, position), numSamples);
+
+                const auto done = (juce::int64)ch * length + position + numSamples;
+                progress.store(0.5 + 0.5 * (double)done / (double)total);
+            }
+        }
+
+        buffer = std::move(resampled);
+        sampleRate = targetSampleRate;
+        return true;
+    }
+
+    void widen()
+    {
+        // NOTE: after resampling, so the copies aren't converted as well
+        const int fileChannels = buffer.getNumChannels();
+        if (fileChannels == 0 || fileChannels >= numChannels)
+            return;
+
+        buffer.setSize(numChannels, buffer.getNumSamples(), true);
+        for (int ch = fileChannels; ch < numChannels; ++ch)
+            buffer.copyFrom(ch, 0, buffer, 0, 0, buffer.getNumSamples());
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> createReader()
+    {
+        // WAV and AIFF can be mapped straight into memory, the other
+        // formats return no memory-mapped reader and are decoded normally
+        if (auto* format = owner.formatManager.findFormatForFileExtension(file.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader>(owner.formatManager.createReaderFor(file));
+    }
+
+    PlayerFileLoader& owner;
+    const juce::File file;
+    const double targetSampleRate;
+    const int numChannels;
+
+    juce::AudioBuffer<float> buffer;
+    double sampleRate = 0.0;
+    bool succeeded = false;
+
+    std::atomic<double> progress{ 0.0 };
+    std::atomic<bool> finished{ false };
+};
+
+PlayerFileLoader::PlayerFileLoader(juce::AudioFormatManager& formatManagerToUse)
+    : formatManager(formatManagerToUse)
+{
+}
+
+PlayerFileLoader::~PlayerFileLoader()
+{
+    cancel();
+}
+
+void PlayerFileLoader::start(const juce::File& file, double targetSampleRate, int numChannels)
+{
+    cancel();
+
+    job = std::make_unique<Job>(*this, file, targetSampleRate, numChannels);
+    pool.addJobToPool(job.get(), false);
+}
+
+void PlayerFileLoader::cancel()
+{
+    if (job != nullptr)
+    {
+        pool.removeJob(job.get(), true, -1);
+        job.reset();
+    }
+}
+
+bool PlayerFileLoader::isLoading() const
+{
+    return job != nullptr && !job->finished.load();
+}
+
+double PlayerFileLoader::getProgress() const
+{
+    return job != nullptr ? job->progress.load() : 0.0;
+}
+
+bool PlayerFileLoader::takeResult(juce::AudioBuffer<float>& destination, double& sampleRate)
+{
+    if (job == nullptr || !job->finished.load())
+        return false;
+
+    // the pool still touches the job for a moment after runJob() returns
+    pool.waitForJobToFinish(job.get(), -1);
+
+    const bool succeeded = job->succeeded;
+    if (succeeded)
+    {
+        destination = std::move(job->buffer);
+        sampleRate = job->sampleRate;
+    }
+
+    job.reset();
+    return succeeded;
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
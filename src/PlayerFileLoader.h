@@ -0,0 +1,55 @@
+#pragma once
+#include <juce_audio_formats/juce_audio_formats.h>
+
+/** Decodes a whole audio file into memory on a background thread, so the
+ * standalone player can serve it from RAM without any I/O in the audio
+ * callback. WAV and AIFF files are read through a memory-mapped reader.
+ * If the file's rate differs from the target rate it is resampled as part
+ * of the load, so playback never has to convert.
+ * A change message is sent when a load finishes (successfully or not).
+ */
+class PlayerFileLoader final : public juce::ChangeBroadcaster
+{
+public:
+    explicit PlayerFileLoader(juce::AudioFormatManager& formatManagerToUse);
+    ~PlayerFileLoader() override;
+
+    /** Starts decoding the given file, cancelling any load already running.
+     * A targetSampleRate of 0 keeps the file's own rate. A file with fewer
+     * channels than numChannels has its first channel copied into the
+     * missing ones, as AudioFormatReader::read does for a mono file.
+     */
+    void start(const juce::File& file, double targetSampleRate, int numChannels);
+
+    /** Cancels the running load, if any. Blocks until the job has stopped. */
+    void cancel();
+
+    bool isLoading() const;
+
+    /** Progress of the current load, from 0 to 1. */
+    double getProgress() const;
+
+    /** Moves the decoded audio, and the rate it is now at, out of the loader.
+     * Returns false if no load has finished or the last one failed.
+     */
+    bool takeResult(juce::AudioBuffer<float>& destination, double& sampleRate);
+
+private:
+    class Job;
+
+    juce::AudioFormatManager& formatManager;
+    juce::ThreadPool pool{ 1 };
+    std::unique_ptr<Job> job;
+
+    static constexpr int chunkSize = 1 << 16;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlayerFileLoader)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -2,7 +2,11 @@
 
 #include "ComplexPlaneEditor.cpp"
 #include "PhaseFrequencyResponseCalculator.cpp"
+#include "TransferFunctionMap.cpp"
+#include "PhaseFrequencyResponseWorker.cpp"
 #include "PhaseFrequencyResponseViewer.cpp"
+#include "TimeResponseCalculator.cpp"
+#include "TimeResponseViewer.cpp"
 #include "CoeffComponents.cpp"
 #include "StateSerializer.cpp"
 #include "PlayerComponent.cpp"
@@ -14,6 +18,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
   :AudioProcessorEditor (&p)
   ,complexPlaneEditor(&p)
   ,phaseFrequencyResponseViewer(&p)
+  ,timeResponseViewer(&p)
   ,coefficients(&p)
   ,buttonPanel(p)
   ,equationViewer(&p)
@@ -22,10 +27,11 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
   addAndMakeVisible(complexPlaneEditor);
   addAndMakeVisible(coefficients);
   addAndMakeVisible(phaseFrequencyResponseViewer);
+  addAndMakeVisible(timeResponseViewer);
   addAndMakeVisible(buttonPanel);
   addAndMakeVisible(equationViewer);
 
-  setSize(960, 520);
+  setSize(960, 680);
   setResizable(true, true);
 }
 
@@ -55,10 +61,12 @@ resized()
     auto buttonPanelBounds = bounds.removeFromTop(40);
     auto equationViewerBounds = bounds.removeFromTop(120);
     auto phaseFrequencyResponseViewerBounds = bounds.removeFromRight(bounds.getWidth() / 3);
+    auto timeResponseViewerBounds = phaseFrequencyResponseViewerBounds.removeFromBottom(phaseFrequencyResponseViewerBounds.getHeight() / 3);
     auto complexPlaneEditorBounds = bounds.removeFromRight(bounds.getWidth() / 2);
     buttonPanel.setBounds(buttonPanelBounds);
     equationViewer.setBounds(equationViewerBounds.reduced(padding));
     phaseFrequencyResponseViewer.setBounds(phaseFrequencyResponseViewerBounds.reduced(padding));
+    timeResponseViewer.setBounds(timeResponseViewerBounds.reduced(padding));
     complexPlaneEditor.setBounds(complexPlaneEditorBounds.reduced(padding));
     coefficients.setBounds(bounds.reduced(padding));
 }
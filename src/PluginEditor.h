@@ -7,6 +7,7 @@
 
 #include "ComplexPlaneEditor.h"
 #include "PhaseFrequencyResponseViewer.h"
+#include "TimeResponseViewer.h"
 #include "CoeffComponents.h"
 #include "ButtonPanel.h"
 #include "EquationViewer.h"
@@ -26,6 +27,7 @@ public:
 private:
   ComplexPlaneEditor complexPlaneEditor;
   PhaseFrequencyResponseViewer phaseFrequencyResponseViewer;
+  TimeResponseViewer timeResponseViewer;
   CoefficientsComponent coefficients;
   ButtonPanel buttonPanel;
   EquationViewer equationViewer;
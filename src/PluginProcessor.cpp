@@ -5,6 +5,13 @@
 #include "FilterState.cpp"
 #include "RootsToCoefficients.cpp"
 #include "ProcessorChainModifier.cpp"
+#include "CompiledChainCache.cpp"
+#include "MinCostAssignment.cpp"
+#include "PlayerFileLoader.cpp"
+#include "SincResampler.cpp"
+#include "ReadAheadAudioSource.cpp"
+#include "AnalysisTap.cpp"
+#include "WorkerPool.cpp"
 
 //==============================================================================
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
@@ -29,13 +36,30 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
     filterState = std::make_unique<FilterState>(apvts.state, &um);
     um.addChangeListener(this);
     transportSource.addChangeListener(this);
+    playerLoader.addChangeListener(this);
     formatManager.registerBasicFormats();
+    readAheadThread.startThread();
 }
 
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
     um.removeChangeListener(this);
+    playerLoader.removeChangeListener(this);
+    playerLoader.cancel();
+
+    // NOTE: the transport source and the read-ahead buffer must be detached
+    // before the background thread goes away
+    transportSource.setSource(nullptr);
+    if (readAheadSource != nullptr)
+    {
+        DBG("player read-ahead underruns: " << (int)readAheadSource->getUnderruns() << "/" << (int)readAheadSource->getBlocks() << " blocks");
+    }
+    memorySource.reset();
+    readAheadSource.reset();
+    resamplingSource.reset();
+    readAheadThread.stopThread(1000);
+    DBG("compiled chain cache: " << (juce::int64)chainCache.getHits() << " hits, " << (juce::int64)chainCache.getMisses() << " misses");
 
     if (auto* activePtr = activeState.exchange(nullptr))
     {
@@ -138,6 +162,7 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     };
     spec = newSpec;
     auto numChannels = getTotalNumOutputChannels();
+    analysisTap.prepare(sampleRate, samplesPerBlock);
 
     if (auto activeProc = activeState.load())
         if (pendingState != nullptr)
@@ -155,17 +180,40 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
                 pendingState->add(pendingItem);
             }
 
-            ProcessorChainModifier::rootsToJuceCoeffs(filterState.get(), activeState.load(), spec);
+            ProcessorChainModifier::apply(*chainCache.getOrCompile(filterState.get(), chainCompileOptions), activeState.load(), spec);
         }
 
-    transportSource.prepareToPlay(samplesPerBlock, sampleRate);
-    if (resamplerSource != nullptr && readerSource != nullptr)
+    // NOTE: the player's file was converted to the old device rate, so a
+    // rate change means loading it again
+    bool shouldResumePlayer = false;
+    if (playerFile != juce::File() && !juce::approximatelyEqual(playerSampleRate, sampleRate))
+    {
+        // the position in seconds survives the conversion, it's picked up
+        // again once the file is ready at the new rate
+        const auto position = transportSource.getCurrentPosition();
+        const auto state = playerState.get();
+        setTransportSourceFromFile(playerFile, playerLoadMode);
+        playerResumePosition = position;
+        playerResumeState = state;
+        shouldResumePlayer = !playerLoader.isLoading();
+    }
+    // the read-ahead buffer is sized from the block size, so it has to grow
+    // with it
+    else if (readAheadSource != nullptr && getReadAheadSize() != readAheadSize)
     {
-        double ratio = readerSource->getAudioFormatReader()->sampleRate / sampleRate;
-        resamplerSource->setResamplingRatio(ratio);
-        resamplerSource->prepareToPlay(samplesPerBlock, sampleRate);
+        const auto position = readAheadSource->getNextReadPosition();
+        const bool wasPlaying = transportSource.isPlaying();
+        setReadAheadSource();
+        readAheadSource->setNextReadPosition(position);
+        if (wasPlaying)
+            transportSource.start();
     }
 
+    transportSource.prepareToPlay(samplesPerBlock, sampleRate);
+    // NOTE: after the transport has the new rate, it converts the position with it
+    if (shouldResumePlayer)
+        resumePlayer();
+
     isPrepared = true;
     sendChangeMessage();
 }
@@ -173,8 +221,6 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
 void AudioPluginAudioProcessor::releaseResources()
 {
   transportSource.releaseResources();
-  if (resamplerSource != nullptr)
-    resamplerSource->releaseResources();
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -214,10 +260,11 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<SampleType>& buf
         juce::AudioSourceChannelInfo info(buffer);
         if (transportSource.isPlaying())
         {
-            if (juce::approximatelyEqual(resamplerSource->getResamplingRatio(), 1.0))
-                transportSource.getNextAudioBlock(info);
-            else
-                resamplerSource->getNextAudioBlock(info);
+            // NOTE: only through the transport, which holds its lock while its
+            // source renders; the message thread may be swapping that source
+            // for another. Both the preloaded and the streamed file are already
+            // at the device rate.
+            transportSource.getNextAudioBlock(info);
         }
     }
 
@@ -236,6 +283,8 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<SampleType>& buf
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(static_cast<int>(i), 0, numSamples);
 
+    analysisTap.captureInput(buffer, totalNumInputChannels);
+
     if (isPendingStateReady.load())
     {
 		PROFILE_SCOPE("new state is ready");
@@ -279,6 +328,7 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<SampleType>& buf
         }
     }
 
+    analysisTap.pushOutput(buffer, totalNumOutputChannels);
     lastProcessTime.store(juce::Time::getApproximateMillisecondCounter());
 }
 
@@ -336,31 +386,119 @@ void AudioPluginAudioProcessor::changeListenerCallback(juce::ChangeBroadcaster*
             playerState.set(PlayerState::Stopped);
         }
     }
+    else if (source == &playerLoader)
+    {
+        double bufferSampleRate = 0.0;
+        if (playerLoader.takeResult(playerBuffer, bufferSampleRate))
+        {
+            jassert(!SincResampler::isNeeded(bufferSampleRate, playerSampleRate));
+            setPreloadedSource();
+            playerState.set(PlayerState::Stopped);
+            resumePlayer();
+        }
+        else if (!playerLoader.isLoading() && playerState.get() == PlayerState::Loading)
+        {
+            playerState.set(PlayerState::Empty);
+        }
+    }
 }
 
-void AudioPluginAudioProcessor::setTransportSourceFromFile(juce::File file)
+void AudioPluginAudioProcessor::setTransportSourceFromFile(juce::File file, PlayerLoadMode loadMode)
 {
+    playerResumePosition = 0.0;
+    playerResumeState = PlayerState::Stopped;
+
     auto* reader = formatManager.createReaderFor(file);
     if (reader != nullptr)
     {
         transportSource.stop();
         transportSource.setSource(nullptr);
-        resamplerSource.reset();
+        playerLoader.cancel();
+        readAheadSource.reset();
+        memorySource.reset();
+        resamplingSource.reset();
+        readerSource.reset();
+        playerBuffer.setSize(0, 0);
+
+        playerFile = file;
+        playerLoadMode = loadMode;
+        playerSampleRate = getSampleRate();
+
+        const bool shouldPreload = loadMode == PlayerLoadMode::Preload
+            || (loadMode == PlayerLoadMode::Automatic
+                && reader->lengthInSamples <= (juce::int64)(maxAutomaticPreloadSeconds * reader->sampleRate));
+
+        if (shouldPreload)
+        {
+            // the loader opens its own (memory-mapped, where possible) reader
+            delete reader;
+            playerLoader.start(file, playerSampleRate, getTotalNumOutputChannels());
+            playerState.set(PlayerState::Loading);
+            return;
+        }
 
         readerSource.reset(new juce::AudioFormatReaderSource(reader, true));
-        readerSource->prepareToPlay(getBlockSize(), getSampleRate());
-
-        transportSource.setSource(readerSource.get(), 0, nullptr, reader->sampleRate);
-
-        double ratio = reader->sampleRate / getSampleRate();
-        resamplerSource.reset(new juce::ResamplingAudioSource(&transportSource, false, getTotalNumOutputChannels()));
-        resamplerSource->setResamplingRatio(ratio);
-        resamplerSource->prepareToPlay(getBlockSize(), getSampleRate());
+        readerSource->setLooping(playerLooping);
+        if (SincResampler::isNeeded(reader->sampleRate, playerSampleRate))
+            resamplingSource.reset(new SincResamplingAudioSource(
+                readerSource.get(), reader->sampleRate, playerSampleRate, getTotalNumOutputChannels()));
+        setReadAheadSource();
 
         playerState.set(PlayerState::Stopped);
     }
 }
 
+void AudioPluginAudioProcessor::resumePlayer()
+{
+    // NOTE: only a file that was playing or paused picks up where it was
+    if (playerResumeState == PlayerState::Playing || playerResumeState == PlayerState::Paused)
+    {
+        transportSource.setPosition(playerResumePosition);
+        if (playerResumeState == PlayerState::Playing)
+            transportSource.start();
+        playerState.set(playerResumeState);
+    }
+
+    playerResumePosition = 0.0;
+    playerResumeState = PlayerState::Stopped;
+}
+
+void AudioPluginAudioProcessor::setPlayerLooping(bool shouldLoop)
+{
+    playerLooping = shouldLoop;
+    if (readerSource != nullptr)
+        readerSource->setLooping(shouldLoop);
+    if (memorySource != nullptr)
+        memorySource->setLooping(shouldLoop);
+}
+
+int AudioPluginAudioProcessor::getReadAheadSize() const
+{
+    return std::max(minReadAheadSamples, readAheadBlockCount * std::max(1, getBlockSize()));
+}
+
+void AudioPluginAudioProcessor::setReadAheadSource()
+{
+    jassert(readerSource != nullptr);
+
+    // The transport must let go of the old buffer before it is destroyed.
+    transportSource.setSource(nullptr);
+
+    readAheadSize = getReadAheadSize();
+    auto* source = resamplingSource != nullptr ? static_cast<juce::PositionableAudioSource*>(resamplingSource.get())
+                                               : readerSource.get();
+    readAheadSource.reset(new ReadAheadAudioSource(source, readAheadThread, readAheadSize, getTotalNumOutputChannels()));
+    // NOTE: no rate to correct for, the transport's own resampler stays out of the chain
+    transportSource.setSource(readAheadSource.get(), 0, nullptr, 0.0);
+}
+
+void AudioPluginAudioProcessor::setPreloadedSource()
+{
+    // NOTE: the memory source refers to playerBuffer instead of copying it
+    memorySource.reset(new juce::MemoryAudioSource(playerBuffer, false, playerLooping));
+    transportSource.setSource(memorySource.get(), 0, nullptr, 0.0);
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
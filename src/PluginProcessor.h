@@ -7,20 +7,34 @@
 
 #include "FilterState.h"
 #include "ValueChangeBroadcaster.h"
+#include "PlayerFileLoader.h"
+#include "SincResampler.h"
+#include "ReadAheadAudioSource.h"
+#include "AnalysisTap.h"
 
 #include "RootsToCoefficients.h"
 #include "ProcessorChain.h"
 #include "ProcessorChainModifier.h"
+#include "CompiledChainCache.h"
 
 //==============================================================================
 enum class PlayerState
 {
 	Empty,
+	Loading,
 	Stopped,
 	Playing,
 	Paused
 };
 
+/** How the standalone player gets a file's samples to the audio thread */
+enum class PlayerLoadMode
+{
+	Stream,     // decoded on the read-ahead thread while playing
+	Preload,    // decoded into memory up front, so seeking and looping never touch the disk
+	Automatic   // preload short files, stream long ones
+};
+
 class AudioPluginAudioProcessor final :
 	public juce::AudioProcessor,
 	public juce::ChangeBroadcaster,
@@ -68,7 +82,8 @@ public:
 
   //==============================================================================
   void changeListenerCallback(juce::ChangeBroadcaster* source) override;
-  void setTransportSourceFromFile(juce::File file);
+  void setTransportSourceFromFile(juce::File file, PlayerLoadMode loadMode = PlayerLoadMode::Automatic);
+  void setPlayerLooping(bool shouldLoop);
 
   juce::UndoManager um;
   juce::AudioProcessorValueTreeState apvts;
@@ -82,16 +97,44 @@ public:
 
   bool isPrepared = false;
   juce::dsp::ProcessSpec spec;
+  ChainCompileOptions chainCompileOptions = ChainCompileOptions::optimised();
+  /** chains compiled for recent states, so undo/redo doesn't recompile */
+  CompiledChainCache chainCache;
+
+  /** input/output taps for the meters and the measured spectrum */
+  AnalysisTap analysisTap;
 
   // for standalone version
   juce::AudioFormatManager formatManager;
+  juce::TimeSliceThread readAheadThread{ "Player read-ahead" };
   std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
-  std::unique_ptr<juce::ResamplingAudioSource> resamplerSource;   // for the case when DAW or audio card sampling rate doesn't match file sampling rate
+  std::unique_ptr<SincResamplingAudioSource> resamplingSource;    // converts a streamed file to the device rate, on readAheadThread
+  std::unique_ptr<ReadAheadAudioSource> readAheadSource;          // decodes the file on readAheadThread so processBlock never touches the disk
+  std::unique_ptr<juce::MemoryAudioSource> memorySource;          // plays a preloaded file straight from playerBuffer
+  PlayerFileLoader playerLoader{ formatManager };
   juce::AudioTransportSource transportSource;
   ValueChangeBroadcaster<PlayerState> playerState;
 
 private:
+	int getReadAheadSize() const;
+	void setReadAheadSource();
+	void setPreloadedSource();
+	/** puts the player back where it was before its file was loaded again at another rate */
+	void resumePlayer();
+
 	juce::AudioBuffer<SampleType> crossFadeBuffer;
+	int readAheadSize = 0;
+	juce::AudioBuffer<float> playerBuffer;
+	juce::File playerFile;
+	PlayerLoadMode playerLoadMode = PlayerLoadMode::Automatic;
+	double playerSampleRate = 0.0;      // device rate the current file was converted to
+	bool playerLooping = false;
+	double playerResumePosition = 0.0;                  // seconds
+	PlayerState playerResumeState = PlayerState::Stopped;
+
+	static constexpr int readAheadBlockCount = 16;
+	static constexpr int minReadAheadSamples = 32768;
+	static constexpr double maxAutomaticPreloadSeconds = 5.0 * 60.0;
   //==============================================================================
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
 };
@@ -1,10 +1,31 @@
 #include "ProcessorChainModifier.h"
 #include "RootsToCoefficients.h"
+#include "MinCostAssignment.h"
+
+ChainCompileOptions ChainCompileOptions::optimised()
+{
+	ChainCompileOptions options;
+	options.pairing = Pairing::MinCost;
+	options.ordering = Ordering::MinPartialNorm;
+	options.scaling = Scaling::LInf;
+	return options;
+}
 
 void ProcessorChainModifier::rootsToJuceCoeffs(
 	FilterState* state,
 	FullState<float>* processorState,
-	juce::dsp::ProcessSpec& spec)
+	juce::dsp::ProcessSpec& spec,
+	const ChainCompileOptions& options)
+{
+	if (processorState->size() == 0)
+		return;
+
+	apply(*compile(state, options), processorState, spec);
+}
+
+CompiledChain::Ptr ProcessorChainModifier::compile(
+	FilterState* state,
+	const ChainCompileOptions& options)
 {
 	// It is proposed that the invariant "total zero order <= total pole order" is maintained
 	// and there cannot be zeros at zero and poles at zero simultaneously
@@ -17,10 +38,6 @@ void ProcessorChainModifier::rootsToJuceCoeffs(
 		double key;
 	};
 
-	const int channelSize = processorState->size();
-	if (channelSize == 0)
-		return;
-
 	const auto polesSize = static_cast<std::size_t>(state->poles.size());
 	const auto zerosSize = static_cast<std::size_t>(state->zeros.size());
 
@@ -54,103 +71,87 @@ void ProcessorChainModifier::rootsToJuceCoeffs(
 		{
 			return a.key > b.key;
 		});
-	const auto nonNullPolesSize = polesIndexesWithKeys.size();
 
-	// 2. Find the best zero pair for each pole
-	// and calculate IIR coefficients
-	std::vector<int> usedZeros(zerosSize, false);
-	std::vector<juce::dsp::IIR::Coefficients<float>*> iirCoeffs;
+	std::vector<FilterRoot*> sortedPoles;
+	sortedPoles.reserve(polesIndexesWithKeys.size());
+	for (auto& item : polesIndexesWithKeys)
+		sortedPoles.push_back(state->poles[static_cast<int>(item.index)]);
 
-	int bestZeroIndex = -1;
-	for (std::size_t i = 0; i < nonNullPolesSize; i++)
+	// 2. Pair poles with zeros into sections
+	// and calculate IIR coefficients
+	std::vector<int> usedZeros(zerosSize, 0);
+	std::vector<SectionPlan> sections;
+	if (options.pairing == ChainCompileOptions::Pairing::MinCost)
+		planMinCostSections(sortedPoles, state->zeros, usedZeros, sections);
+	else
+		planGreedySections(sortedPoles, state->zeros, usedZeros, sections);
+
+	std::vector<std::size_t> sectionOrder;
+	std::vector<double> sectionScales;
+	orderAndScaleSections(sections, state->zeros, options, sectionOrder, sectionScales);
+
+	CompiledChain::Ptr chain = new CompiledChain;
+	std::vector<juce::dsp::IIR::Coefficients<float>::Ptr> iirCoeffs;
+	iirCoeffs.reserve(sections.size());
+	double totalScale = 1.0;
+	for (std::size_t i = 0; i < sections.size(); i++)
 	{
-		auto* pole = state->poles[static_cast<int>(polesIndexesWithKeys[i].index)];
-		const int poleOrder = std::abs(pole->order.get());
-
-		for (int j = 0; j < poleOrder; j++)
-		{
-			bestZeroIndex = findBestZeroIndexPairForPole(
-				pole,
-				state->zeros,
-				usedZeros,
-				poleOrder - j > 1);
-
-			const auto* zero = bestZeroIndex == -1 ? nullptr : state->zeros[bestZeroIndex];
-			const int unusedZeroOrder =
-				zero == nullptr ?
-				0 :
-				zero->order.get() - usedZeros[static_cast<std::size_t>(bestZeroIndex)];
-			const bool shouldEqualPoleBeTaken =
-				pole->isReal() &&
-				poleOrder - j > 1 &&
-				(zero == nullptr ||
-					!state->zeros[bestZeroIndex]->isReal() ||
-					unusedZeroOrder > 1);
-			const bool shouldEqualZeroBeTaken =
-				zero != nullptr &&
-				zero->isReal() &&
-				pole->isReal() &&
-				poleOrder - j > 1 &&
-				unusedZeroOrder > 1;
-
-			iirCoeffs.push_back(calculateIirCoefficients(
-				pole,
-				state->zeros,
-				bestZeroIndex,
-				shouldEqualPoleBeTaken,
-				shouldEqualZeroBeTaken));
-
-			if (shouldEqualPoleBeTaken)
-				j++;
-			if (zero != nullptr)
-			{
-				//const int effectivePoleOrder = pole->isReal() && !shouldEqualPoleBeTaken ? 1 : 2;
-				const int zeroOrder = shouldEqualZeroBeTaken ? 2 : 1;
-				usedZeros[static_cast<std::size_t>(bestZeroIndex)] += zeroOrder;
-			}
-		}
+		iirCoeffs.push_back(calculateIirCoefficients(sections[i], state->zeros, sectionScales[i]));
+		totalScale *= sectionScales[i];
 	}
-	const auto iirFiltersSize = iirCoeffs.size();
+	chain->iirCascade.reserve(iirCoeffs.size());
+	for (auto index : sectionOrder)
+		chain->iirCascade.push_back(iirCoeffs[index]);
 
-	// 3. Calculate FIR coefficients for non-paired zeros.
+	// 3. Calculate FIR coefficients for non-paired zeros,
+	// undoing the sections' scaling.
 	std::vector<double> firCoeffsDblArray =
 		RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->zeros, 1, &usedZeros);
 	std::size_t firCoeffArraySize = firCoeffsDblArray.size();
 	std::vector<float> firCoeffsArray(firCoeffArraySize);
 	for (std::size_t i = 0; i < firCoeffArraySize; i++)
-		firCoeffsArray[i] = static_cast<float>(firCoeffsDblArray[i]);
+		firCoeffsArray[i] = static_cast<float>(firCoeffsDblArray[i] / totalScale);
 	//delayCount = std::max(0, delayCount - static_cast<int>(firCoeffArraySize - 1));
 
+	chain->delayCount = delayCount;
+	chain->firCoefficients = new juce::dsp::FIR::Coefficients<float>{ firCoeffsArray.data(), firCoeffsArray.size() };
+	chain->gain = static_cast<float>(state->gain.get());
+	return chain;
+}
+
+void ProcessorChainModifier::apply(
+	const CompiledChain& chain,
+	FullState<float>* processorState,
+	juce::dsp::ProcessSpec& spec)
+{
 	// 4. Set processors parameters
-	for (int ch = 0; ch < channelSize; ch++)
+	// (coefficients are shared between the channels, filters keep their own state)
+	for (auto* proc : *processorState)
 	{
-		auto* proc = (*processorState)[ch];
-
 		// 4a. Delay
 		auto& delay = proc->delay;
-		if (delay.getMaximumDelayInSamples() < delayCount)
-			delay.setMaximumDelayInSamples(delayCount);
-		delay.setDelay(delayCount);
+		if (delay.getMaximumDelayInSamples() < chain.delayCount)
+			delay.setMaximumDelayInSamples(chain.delayCount);
+		delay.setDelay(chain.delayCount);
 		delay.prepare(spec);
 
 		// 4b. IIR cascade
 		auto& iirCascade = proc->iirCascade;
 		iirCascade.clear();
-		for (std::size_t i = 0; i < iirFiltersSize; i++)
+		for (auto& coefficients : chain.iirCascade)
 		{
-			const std::size_t iirCoeffsIndex = iirFiltersSize - 1 - i; // reverse order
-			auto* newFilter = new juce::dsp::IIR::Filter<float>{ iirCoeffs[iirCoeffsIndex] };
+			auto* newFilter = new juce::dsp::IIR::Filter<float>{ coefficients };
 			newFilter->prepare(spec);
 			iirCascade.add(newFilter);
 		}
 
 		// 4c. FIR filter
 		// FIR filter should be recreated each time as filter reset() method does not reset pos field.
-		proc->firFilter.reset(new juce::dsp::FIR::Filter<float>{ new juce::dsp::FIR::Coefficients<float>{ firCoeffsArray.data(), firCoeffsArray.size() } });
+		proc->firFilter.reset(new juce::dsp::FIR::Filter<float>{ chain.firCoefficients });
 		proc->firFilter->prepare(spec);
 
 		//4d. Gain
-		proc->gain.setGainLinear(static_cast<float>(state->gain.get()));
+		proc->gain.setGainLinear(chain.gain);
 		proc->gain.prepare(spec);
 	}
 }
@@ -174,7 +175,7 @@ void ProcessorChainModifier::process(AudioPluginAudioProcessor& processor)
 		juce::Time::getApproximateMillisecondCounter() - processor.lastProcessTime.load() > processBlockMaxPause)
 	{
 		processor.isPendingStateReady.store(false);
-		rootsToJuceCoeffs(processor.filterState.get(), processor.pendingState, processor.spec);
+		apply(*processor.chainCache.getOrCompile(processor.filterState.get(), processor.chainCompileOptions), processor.pendingState, processor.spec);
 		auto* old = processor.activeState.exchange(processor.pendingState);
 		processor.pendingState = old;
 	}
@@ -183,11 +184,310 @@ void ProcessorChainModifier::process(AudioPluginAudioProcessor& processor)
 	// then another update should be cancelled.
 	else if (!processor.isPendingStateReady.load())
 	{
-		rootsToJuceCoeffs(processor.filterState.get(), processor.pendingState, processor.spec);
+		apply(*processor.chainCache.getOrCompile(processor.filterState.get(), processor.chainCompileOptions), processor.pendingState, processor.spec);
 		processor.isPendingStateReady.store(true);
 	}
 }
 
+void ProcessorChainModifier::planGreedySections(
+	const std::vector<FilterRoot*>& sortedPoles,
+	juce::OwnedArray<FilterRoot>& zeros,
+	std::vector<int>& usedZeros,
+	std::vector<SectionPlan>& sections)
+{
+	// Find the best zero pair for each pole
+	int bestZeroIndex = -1;
+	for (auto* pole : sortedPoles)
+	{
+		const int poleOrder = std::abs(pole->order.get());
+
+		for (int j = 0; j < poleOrder; j++)
+		{
+			bestZeroIndex = findBestZeroIndexPairForPole(
+				pole,
+				zeros,
+				usedZeros,
+				poleOrder - j > 1);
+
+			const auto* zero = bestZeroIndex == -1 ? nullptr : zeros[bestZeroIndex];
+			const int unusedZeroOrder =
+				zero == nullptr ?
+				0 :
+				zero->order.get() - usedZeros[static_cast<std::size_t>(bestZeroIndex)];
+			const bool shouldEqualPoleBeTaken =
+				pole->isReal() &&
+				poleOrder - j > 1 &&
+				(zero == nullptr ||
+					!zeros[bestZeroIndex]->isReal() ||
+					unusedZeroOrder > 1);
+			const bool shouldEqualZeroBeTaken =
+				zero != nullptr &&
+				zero->isReal() &&
+				pole->isReal() &&
+				poleOrder - j > 1 &&
+				unusedZeroOrder > 1;
+
+			sections.push_back({
+				pole,
+				shouldEqualPoleBeTaken,
+				{ bestZeroIndex, shouldEqualZeroBeTaken ? bestZeroIndex : -1 } });
+
+			if (shouldEqualPoleBeTaken)
+				j++;
+			if (zero != nullptr)
+			{
+				const int zeroOrder = shouldEqualZeroBeTaken ? 2 : 1;
+				usedZeros[static_cast<std::size_t>(bestZeroIndex)] += zeroOrder;
+			}
+		}
+	}
+}
+
+void ProcessorChainModifier::planMinCostSections(
+	const std::vector<FilterRoot*>& sortedPoles,
+	juce::OwnedArray<FilterRoot>& zeros,
+	std::vector<int>& usedZeros,
+	std::vector<SectionPlan>& sections)
+{
+	// Poles are split into sections up front: a complex pole gives one
+	// 2-order section per order, a real pole is doubled as often as it can be.
+	for (auto* pole : sortedPoles)
+	{
+		const int poleOrder = std::abs(pole->order.get());
+		if (pole->isReal())
+		{
+			for (int j = 0; j < poleOrder / 2; j++)
+				sections.push_back({ pole, true, { -1, -1 } });
+			if (poleOrder % 2 == 1)
+				sections.push_back({ pole, false, { -1, -1 } });
+		}
+		else
+		{
+			for (int j = 0; j < poleOrder; j++)
+				sections.push_back({ pole, false, { -1, -1 } });
+		}
+	}
+
+	// Each order of a zero is a unit that can go to one section.
+	std::vector<int> units;
+	for (int i = 0; i < zeros.size(); i++)
+		for (int j = 0; j < zeros[i]->order.get(); j++)
+			units.push_back(i);
+
+	// Two rounds of assignment: the first gives every section at most one unit,
+	// the second gives 2-order sections holding at most one real zero a second one.
+	// In both, sections may fall back to a dummy column (no zero) at a cost
+	// that only wins once the units run out.
+	std::vector<char> isUnitUsed(units.size(), false);
+	for (int round = 0; round < 2; round++)
+	{
+		std::vector<std::size_t> rows;
+		for (std::size_t i = 0; i < sections.size(); i++)
+		{
+			const auto& section = sections[i];
+			const bool isSecondOrder = !section.pole->isReal() || section.isPoleDoubled;
+			const bool canTakeAnother =
+				round == 0 ||
+				(isSecondOrder &&
+					section.zeroIndex[1] == -1 &&
+					(section.zeroIndex[0] == -1 || zeros[section.zeroIndex[0]]->isReal()));
+			if (canTakeAnother)
+				rows.push_back(i);
+		}
+
+		std::vector<std::size_t> columns;
+		for (std::size_t j = 0; j < units.size(); j++)
+			if (!isUnitUsed[j] && (round == 0 || zeros[units[j]]->isReal()))
+				columns.push_back(j);
+
+		if (rows.empty() || columns.empty())
+			continue;
+
+		const int rowCount = static_cast<int>(rows.size());
+		const int columnCount = static_cast<int>(columns.size()) + rowCount;
+		std::vector<double> cost(static_cast<std::size_t>(rowCount) * static_cast<std::size_t>(columnCount));
+		for (std::size_t r = 0; r < rows.size(); r++)
+		{
+			auto section = sections[rows[r]];
+			const int slot = section.zeroIndex[0] == -1 ? 0 : 1;
+			const bool isFirstOrder = section.pole->isReal() && !section.isPoleDoubled;
+			double* costRow = cost.data() + r * static_cast<std::size_t>(columnCount);
+
+			for (std::size_t c = 0; c < columns.size(); c++)
+			{
+				const int zeroIndex = units[columns[c]];
+				if (isFirstOrder && !zeros[zeroIndex]->isReal())
+				{
+					costRow[c] = incompatibleCost;
+					continue;
+				}
+				section.zeroIndex[slot] = zeroIndex;
+				costRow[c] = logPeakSectionGain(section, zeros);
+			}
+
+			section.zeroIndex[slot] = -1;
+			const double unpaired = unpairedCost + logPeakSectionGain(section, zeros);
+			for (std::size_t c = columns.size(); c < static_cast<std::size_t>(columnCount); c++)
+				costRow[c] = unpaired;
+		}
+
+		const auto assignment = MinCostAssignment::solve(cost, rowCount, columnCount);
+		for (std::size_t r = 0; r < rows.size(); r++)
+		{
+			const auto c = static_cast<std::size_t>(assignment[r]);
+			if (c >= columns.size())
+				continue;
+
+			auto& section = sections[rows[r]];
+			const int zeroIndex = units[columns[c]];
+			section.zeroIndex[section.zeroIndex[0] == -1 ? 0 : 1] = zeroIndex;
+			isUnitUsed[columns[c]] = true;
+			usedZeros[static_cast<std::size_t>(zeroIndex)]++;
+		}
+	}
+}
+
+double ProcessorChainModifier::logPeakSectionGain(
+	const SectionPlan& section,
+	juce::OwnedArray<FilterRoot>& zeros)
+{
+	// searched on a uniform grid over [0, pi] and at the pole's own angle,
+	// where a resonance peaks
+	const auto pole = section.pole->value.get();
+	double peak = sectionGainAt(section, zeros, std::abs(std::arg(pole)));
+	for (int i = 0; i <= gainGridSize; i++)
+		peak = std::max(peak, sectionGainAt(section, zeros, pi * i / gainGridSize));
+
+	return juce::jlimit(-maxLogGain, maxLogGain, std::log(std::max(peak, 1e-300)));
+}
+
+double ProcessorChainModifier::sectionGainAt(
+	const SectionPlan& section,
+	juce::OwnedArray<FilterRoot>& zeros,
+	double angle)
+{
+	// |H(e^jw)| = prod |e^jw - zero| / prod |e^jw - pole| over the section's roots
+	c128 poleRoots[2];
+	int poleCount = 0;
+	const auto pole = section.pole->value.get();
+	poleRoots[poleCount++] = pole;
+	if (!section.pole->isReal() || section.isPoleDoubled)
+		poleRoots[poleCount++] = std::conj(pole);
+
+	c128 zeroRoots[2];
+	int zeroCount = 0;
+	for (int zeroIndex : section.zeroIndex)
+	{
+		if (zeroIndex == -1)
+			continue;
+		const auto* zero = zeros[zeroIndex];
+		const auto value = zero->value.get();
+		zeroRoots[zeroCount++] = value;
+		if (!zero->isReal())
+			zeroRoots[zeroCount++] = std::conj(value);
+	}
+
+	const c128 point(std::cos(angle), std::sin(angle));
+	double gain = 1.0;
+	for (int i = 0; i < zeroCount; i++)
+		gain *= std::abs(point - zeroRoots[i]);
+	for (int i = 0; i < poleCount; i++)
+		gain /= std::max(std::abs(point - poleRoots[i]), magnitudeThreshold);
+	return gain;
+}
+
+void ProcessorChainModifier::orderAndScaleSections(
+	const std::vector<SectionPlan>& sections,
+	juce::OwnedArray<FilterRoot>& zeros,
+	const ChainCompileOptions& options,
+	std::vector<std::size_t>& order,
+	std::vector<double>& scales)
+{
+	using Ordering = ChainCompileOptions::Ordering;
+	using Scaling = ChainCompileOptions::Scaling;
+
+	const std::size_t sectionCount = sections.size();
+	order.clear();
+	scales.assign(sectionCount, 1.0);
+	if (options.ordering == Ordering::Reverse && options.scaling == Scaling::None)
+	{
+		for (std::size_t i = 0; i < sectionCount; i++)
+			order.push_back(sectionCount - 1 - i);
+		return;
+	}
+
+	// Magnitudes of every section on the uniform grid, then at the pole angles
+	// so that no resonance falls between grid points.
+	const auto uniformCount = static_cast<std::size_t>(normGridSize + 1);
+	std::vector<double> angles;
+	angles.reserve(uniformCount + sectionCount);
+	for (int i = 0; i <= normGridSize; i++)
+		angles.push_back(pi * i / normGridSize);
+	for (auto& section : sections)
+		angles.push_back(std::abs(std::arg(section.pole->value.get())));
+
+	const std::size_t angleCount = angles.size();
+	std::vector<double> magnitudes(sectionCount * angleCount);
+	for (std::size_t i = 0; i < sectionCount; i++)
+		for (std::size_t k = 0; k < angleCount; k++)
+			magnitudes[i * angleCount + k] = sectionGainAt(sections[i], zeros, angles[k]);
+
+	// NOTE: by Parseval the L2 norm of the impulse response is the RMS of |H| over [0, pi],
+	// taken here with the trapezoidal rule on the uniform part of the grid.
+	// Ordering needs some norm even when nothing is scaled, that's L-inf then.
+	const bool isL2 = options.scaling == Scaling::L2;
+	const auto norm = [&](const std::vector<double>& m)
+	{
+		double result = 0.0;
+		if (isL2)
+		{
+			for (std::size_t k = 0; k < uniformCount; k++)
+				result += (k == 0 || k == uniformCount - 1 ? 0.5 : 1.0) * m[k] * m[k];
+			return std::sqrt(result / normGridSize);
+		}
+		for (double value : m)
+			result = std::max(result, value);
+		return result;
+	};
+
+	// The partial product is kept normalised, whatever the scaling,
+	// so that long cascades don't overflow it.
+	std::vector<double> partial(angleCount, 1.0), candidate(angleCount), best(angleCount);
+	std::vector<char> isPlaced(sectionCount, false);
+	for (std::size_t step = 0; step < sectionCount; step++)
+	{
+		std::size_t bestIndex = sectionCount;
+		double bestNorm = std::numeric_limits<double>::max();
+		for (std::size_t i = 0; i < sectionCount; i++)
+		{
+			if (isPlaced[i] || (options.ordering == Ordering::Reverse && i != sectionCount - 1 - step))
+				continue;
+
+			const double* m = magnitudes.data() + i * angleCount;
+			for (std::size_t k = 0; k < angleCount; k++)
+				candidate[k] = partial[k] * m[k];
+
+			const double candidateNorm = norm(candidate);
+			if (candidateNorm < bestNorm)
+			{
+				bestIndex = i;
+				bestNorm = candidateNorm;
+				best.swap(candidate);
+			}
+		}
+
+		jassert(bestIndex < sectionCount);
+		const double normalisation = bestNorm > 0.0 ? 1.0 / bestNorm : 1.0;
+		for (std::size_t k = 0; k < angleCount; k++)
+			partial[k] = best[k] * normalisation;
+
+		isPlaced[bestIndex] = true;
+		order.push_back(bestIndex);
+		if (options.scaling != Scaling::None)
+			scales[bestIndex] = normalisation;
+	}
+}
+
 double ProcessorChainModifier::evaluatePole(const FilterRoot* pole)
 {
 	const auto value = pole->value.get();
@@ -236,50 +536,53 @@ int ProcessorChainModifier::findBestZeroIndexPairForPole(
 }
 
 juce::dsp::IIR::Coefficients<float>* ProcessorChainModifier::calculateIirCoefficients(
-	FilterRoot* pole,
+	const SectionPlan& section,
 	juce::OwnedArray<FilterRoot>& zeros,
-	int zeroIndex,
-	bool shouldEqualPoleBeTaken,
-	bool shouldEqualZeroBeTaken)
+	double numeratorScale)
 {
-	const bool isPoleReal = pole->isReal();
-	jassert(isPoleReal || !shouldEqualPoleBeTaken);
-	float b0, b1, b2, a0, a1, a2;
-
-	calculatePolynomialCoefficients(pole, shouldEqualPoleBeTaken, a0, a1, a2);
-
-	if (zeroIndex != -1)
-	{
-		//auto* zero = zeros[zeroIndex];
-		//const int poleOrder = pole->isReal() && !shouldEqualPoleBeTaken ? 1 : 2;
-		calculatePolynomialCoefficients(zeros[zeroIndex], shouldEqualZeroBeTaken, b0, b1, b2);
-	}
-	else if (juce::exactlyEqual(a0, 0.f)) // no zeros, 1-order pole
+	jassert(section.pole->isReal() || !section.isPoleDoubled);
+	float a0, a1, a2;
+	calculatePolynomialCoefficients(section.pole, section.isPoleDoubled, a0, a1, a2);
+
+	// Numerator in powers of z^-1 with a leading 1, so it never decrements the delay.
+	double b[3] = { 1.0, 0.0, 0.0 };
+	int numeratorOrder = 0;
+	for (int zeroIndex : section.zeroIndex)
 	{
-		b1 = 1.0;
-		b0 = b2 = 0;
-	}
-	else // no zeros, 2-order pole
-	{
-		b0 = 1.0;
-		b1 = b2 = 0;
+		if (zeroIndex == -1)
+			continue;
+
+		const auto* zero = zeros[zeroIndex];
+		const double re = zero->value.re.get();
+		const double im = zero->value.im.get();
+		if (!zero->isReal())
+		{
+			jassert(numeratorOrder == 0);
+			b[1] = -2.0 * re;
+			b[2] = re * re + im * im;
+			numeratorOrder = 2;
+		}
+		else
+		{
+			// multiply by (1 - re * z^-1)
+			for (int k = numeratorOrder + 1; k > 0; k--)
+				b[k] -= re * b[k - 1];
+			numeratorOrder++;
+		}
 	}
 
+	for (auto& c : b)
+		c *= numeratorScale;
+
 	if (juce::exactlyEqual(a0, 0.f)) // 1-order filter
 	{
-		jassert(juce::exactlyEqual(b0, 0.f) && !juce::exactlyEqual(a1, 0.f));
-		return new juce::dsp::IIR::Coefficients<float>{ b1, b2, a1, a2 };
+		jassert(numeratorOrder <= 1 && !juce::exactlyEqual(a1, 0.f));
+		return new juce::dsp::IIR::Coefficients<float>{ static_cast<float>(b[0]), static_cast<float>(b[1]), a1, a2 };
 	}
 	else // 2-order filter
 	{
-		// Coefficients should be shifted in order not to decrement delay.
-		if (juce::exactlyEqual(b0, 0.f))
-		{
-			b0 = b1;
-			b1 = b2;
-			b2 = 0;
-		}
-		return new juce::dsp::IIR::Coefficients<float>{ b0, b1, b2, a0, a1, a2 };
+		jassert(numeratorOrder <= 2);
+		return new juce::dsp::IIR::Coefficients<float>{ static_cast<float>(b[0]), static_cast<float>(b[1]), static_cast<float>(b[2]), a0, a1, a2 };
 	}
 }
 
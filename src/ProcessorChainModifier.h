@@ -1,7 +1,58 @@
 #pragma once
 #include "FilterState.h"
 #include "ProcessorChain.h"
-#include "PluginProcessor.h"
+
+class AudioPluginAudioProcessor;
+
+/** Options for ProcessorChainModifier::rootsToJuceCoeffs.
+ * The defaults reproduce the original greedy compiler.
+ */
+struct ChainCompileOptions
+{
+	enum class Pairing
+	{
+		Greedy,  // each pole, by evaluatePole priority, takes the nearest unused zero
+		MinCost  // assignment of zeros to sections that minimises the summed log peak section gain
+	};
+
+	/** order of the sections in the cascade */
+	enum class Ordering
+	{
+		Reverse,        // reverse of the pairing priority
+		MinPartialNorm  // each next section is the one that keeps the partial product's norm lowest
+	};
+
+	/** numerator scaling of each section, so that the transfer function from
+	 * the input to every section's output has unit norm; the FIR makes up for it
+	 */
+	enum class Scaling
+	{
+		None,
+		L2,   // unit energy of the partial impulse responses
+		LInf  // unit peak of the partial magnitude responses, no sinusoid can clip inside the cascade
+	};
+
+	Pairing pairing = Pairing::Greedy;
+	Ordering ordering = Ordering::Reverse;
+	Scaling scaling = Scaling::None;
+
+	/** what the plugin itself compiles with */
+	static ChainCompileOptions optimised();
+};
+
+/** Everything rootsToJuceCoeffs works out from a FilterState before any of it
+ * goes into a ProcessorChain. Never changed once compiled, so it can be kept
+ * and shared between chains.
+ */
+struct CompiledChain : public juce::ReferenceCountedObject
+{
+	using Ptr = juce::ReferenceCountedObjectPtr<CompiledChain>;
+
+	int delayCount = 0;
+	std::vector<juce::dsp::IIR::Coefficients<float>::Ptr> iirCascade;   // in processing order
+	juce::dsp::FIR::Coefficients<float>::Ptr firCoefficients;
+	float gain = 1.f;
+};
 
 class ProcessorChainModifier
 {
@@ -9,10 +60,54 @@ public:
 	static void rootsToJuceCoeffs(
 		FilterState* state,
 		FullState<float>* processorState,
-		juce::dsp::ProcessSpec& spec);
+		juce::dsp::ProcessSpec& spec,
+		const ChainCompileOptions& options = {});
 	static void process(class AudioPluginAudioProcessor& processor);
 
+	/** the two halves of rootsToJuceCoeffs */
+	static CompiledChain::Ptr compile(
+		FilterState* state,
+		const ChainCompileOptions& options = {});
+	static void apply(
+		const CompiledChain& chain,
+		FullState<float>* processorState,
+		juce::dsp::ProcessSpec& spec);
+
 private:
+	/** one IIR section: a pole (taken twice if it is real and doubled)
+	 * over up to two real zeros or one complex zero (index -1 if absent)
+	 */
+	struct SectionPlan
+	{
+		FilterRoot* pole;
+		bool isPoleDoubled;
+		int zeroIndex[2];
+	};
+
+	static void planGreedySections(
+		const std::vector<FilterRoot*>& sortedPoles,
+		juce::OwnedArray<FilterRoot>& zeros,
+		std::vector<int>& usedZeros,
+		std::vector<SectionPlan>& sections);
+	static void planMinCostSections(
+		const std::vector<FilterRoot*>& sortedPoles,
+		juce::OwnedArray<FilterRoot>& zeros,
+		std::vector<int>& usedZeros,
+		std::vector<SectionPlan>& sections);
+	static double logPeakSectionGain(
+		const SectionPlan& section,
+		juce::OwnedArray<FilterRoot>& zeros);
+	static double sectionGainAt(
+		const SectionPlan& section,
+		juce::OwnedArray<FilterRoot>& zeros,
+		double angle);
+	static void orderAndScaleSections(
+		const std::vector<SectionPlan>& sections,
+		juce::OwnedArray<FilterRoot>& zeros,
+		const ChainCompileOptions& options,
+		std::vector<std::size_t>& order,
+		std::vector<double>& scales);
+
 	static inline double evaluatePole(const FilterRoot* pole);
 	static int findBestZeroIndexPairForPole(
 		const FilterRoot* pole,
@@ -20,11 +115,9 @@ private:
 		std::vector<int>& usedZeros,
 		bool doesEqualPoleExist);
 	static juce::dsp::IIR::Coefficients<float>* calculateIirCoefficients(
-		FilterRoot* pole,
+		const SectionPlan& section,
 		juce::OwnedArray<FilterRoot>& zeros,
-		int zeroIndex,
-		bool shouldEqualPoleBeTaken,
-		bool shouldEqualZeroBeTaken);
+		double numeratorScale);
 	static inline void calculatePolynomialCoefficients(
 		FilterRoot* root,
 		bool shouldBeTakenTwice,
@@ -38,6 +131,12 @@ private:
 	static constexpr double magCoeff = 0.3;
 	static constexpr double angleCoeff = 0.1;
 	static constexpr juce::uint32 processBlockMaxPause = 100;
+
+	static constexpr int gainGridSize = 64;             // frequencies the peak section gain is searched at, besides the pole angle
+	static constexpr double unpairedCost = 1e6;         // dominates any sum of log gains, so as many zeros as possible get paired
+	static constexpr double incompatibleCost = 1e9;     // e.g. a complex zero over a first order pole
+	static constexpr double maxLogGain = 50.0;
+	static constexpr int normGridSize = 512;            // uniform frequencies the partial norms are taken over, besides the pole angles
 };
 
 // NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
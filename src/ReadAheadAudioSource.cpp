@@ -0,0 +1,64 @@
+#include "ReadAheadAudioSource.h"
+
+ReadAheadAudioSource::ReadAheadAudioSource(
+    juce::PositionableAudioSource* source,
+    juce::TimeSliceThread& thread,
+    int numberOfSamplesToBuffer,
+    int numberOfChannels)
+    : buffering(source, thread, false, numberOfSamplesToBuffer, numberOfChannels)
+{
+}
+
+void ReadAheadAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    buffering.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void ReadAheadAudioSource::releaseResources()
+{
+    buffering.releaseResources();
+}
+
+void ReadAheadAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& info)
+{
+    // NOTE: zero timeout, this only asks whether the read-ahead thread kept
+    // up; a miss plays silence instead of waiting on the disk
+    blocks.fetch_add(1, std::memory_order_relaxed);
+    if (!buffering.waitForNextAudioBlockReady(info, 0))
+        underruns.fetch_add(1, std::memory_order_relaxed);
+
+    buffering.getNextAudioBlock(info);
+}
+
+void ReadAheadAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    buffering.setNextReadPosition(newPosition);
+}
+
+juce::int64 ReadAheadAudioSource::getNextReadPosition() const
+{
+    return buffering.getNextReadPosition();
+}
+
+juce::int64 ReadAheadAudioSource::getTotalLength() const
+{
+    return buffering.getTotalLength();
+}
+
+bool ReadAheadAudioSource::isLooping() const
+{
+    return buffering.isLooping();
+}
+
+void ReadAheadAudioSource::setLooping(bool shouldLoop)
+{
+    buffering.setLooping(shouldLoop);
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
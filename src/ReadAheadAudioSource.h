@@ -0,0 +1,47 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/** A juce::BufferingAudioSource that counts how often its read-ahead thread
+ * didn't keep up. The transport source owns the only reference the audio
+ * thread uses, so the count is taken under the transport's lock and the
+ * source can be detached and destroyed like any other.
+ */
+class ReadAheadAudioSource final : public juce::PositionableAudioSource
+{
+public:
+    ReadAheadAudioSource(
+        juce::PositionableAudioSource* source,
+        juce::TimeSliceThread& thread,
+        int numberOfSamplesToBuffer,
+        int numberOfChannels);
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& info) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+    /** blocks rendered since the source was made */
+    juce::uint32 getBlocks() const { return blocks.load(std::memory_order_relaxed); }
+    /** those of them for which the read-ahead buffer was not ready in time */
+    juce::uint32 getUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+
+private:
+    juce::BufferingAudioSource buffering;
+    std::atomic<juce::uint32> blocks{ 0 };
+    std::atomic<juce::uint32> underruns{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadAudioSource)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -3,7 +3,8 @@
 std::vector<double> RootsToCoefficients::CalculatePolynomialCoefficientsFrom(
 	juce::OwnedArray<FilterRoot>& roots,
 	int minimalLength,
-	std::vector<int>* usedRootsPtr)
+	std::vector<int>* usedRootsPtr,
+	Expansion expansion)
 {
 	std::vector<int> usedRoots;
 	if (usedRootsPtr == nullptr)
@@ -52,6 +53,42 @@ std::vector<double> RootsToCoefficients::CalculatePolynomialCoefficientsFrom(
 			return a.magnitude < b.magnitude;
 		});
 
+	if (expansion == Expansion::productTree
+		|| (expansion == Expansion::automatic && order >= ProductTreeMinOrder))
+	{
+		// Leaves in order of magnitude, so neighbours, which are multiplied together first,
+		// have similar magnitudes; the same reason as for the order of the loop below.
+		std::vector<std::vector<double>> products;
+		products.reserve(static_cast<size_t>(order));
+		for (auto& rootIndex : rootIndexes)
+		{
+			auto* root = roots[rootIndex.index];
+			const double re = root->value.re.get();
+			const double im = root->value.im.get();
+			const int rootOrder = std::abs(root->order.get()) - usedRoots[static_cast<size_t>(rootIndex.index)];
+			for (int j = 0; j < rootOrder; j++)
+			{
+				if (root->isReal())
+					products.push_back({ 1.0, -re });
+				else
+					products.push_back({ 1.0, -2.0 * re, re * re + im * im });
+			}
+		}
+
+		while (products.size() > 1)
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < products.size(); i += 2)
+				products[count++] = i + 1 < products.size() ? multiply(products[i], products[i + 1]) : std::move(products[i]);
+			products.resize(count);
+		}
+
+		const auto& product = products.front();
+		jassert(product.size() == static_cast<size_t>(order) + 1);
+		std::copy(product.begin(), product.end(), res.end() - static_cast<std::ptrdiff_t>(product.size()));
+		return res;
+	}
+
 	// Calculate coefficients
 
 	size_t nonZeroCoeffCount = 1;
@@ -105,6 +142,113 @@ std::vector<double> RootsToCoefficients::CalculatePolynomialCoefficientsFrom(
 	return res;
 }
 
+std::vector<double> RootsToCoefficients::multiply(
+	const std::vector<double>& a,
+	const std::vector<double>& b,
+	size_t fftMinLength)
+{
+	jassert(!a.empty() && !b.empty());
+	const size_t length = a.size() + b.size() - 1;
+	std::vector<double> product(length, 0.0);
+
+	if (std::min(a.size(), b.size()) < fftMinLength)
+	{
+		for (size_t i = 0; i < a.size(); i++)
+			for (size_t j = 0; j < b.size(); j++)
+				product[i + j] += a[i] * b[j];
+		return product;
+	}
+
+	// The FFT's error is relative to the largest coefficient, so substitute z = s w first, with s
+	// the power of 2 nearest the geometric mean of the magnitudes of the product's roots; this
+	// brings the coefficients, p[j] s^-j, as close to the same size as one scale can.
+	const double constant = std::abs(a.back() * b.back());
+	const int exponent = constant > 0.0 && std::isfinite(constant)
+		? static_cast<int>(std::lround(std::log2(constant) / static_cast<double>(length - 1)))
+		: 0;
+	const auto scaled = [&](const std::vector<double>& p, size_t j) { return j < p.size() ? std::ldexp(p[j], -exponent * static_cast<int>(j)) : 0.0; };
+
+	// Both are real, so one transform of z = a + ib carries the two spectra:
+	// A[k] = (Z[k] + conj(Z[-k])) / 2 and B[k] = (Z[k] - conj(Z[-k])) / 2i
+	size_t size = 1;
+	while (size < length)
+		size <<= 1;
+	std::vector<c128> z(size);
+	for (size_t i = 0; i < size; i++)
+		z[i] = c128(scaled(a, i), scaled(b, i));
+	fft(z, false);
+
+	std::vector<c128> spectrum(size);
+	for (size_t k = 0; k < size; k++)
+	{
+		const c128 zk = z[k];
+		const c128 mirror = std::conj(z[(size - k) & (size - 1)]);
+		spectrum[k] = (zk + mirror) * (zk - mirror) * c128(0.0, -0.25);
+	}
+	fft(spectrum, true);
+
+	for (size_t i = 0; i < length; i++)
+		product[i] = std::ldexp(spectrum[i].real() / static_cast<double>(size), exponent * static_cast<int>(i));
+	// NOTE: exact for monic factors; CoefficientsToRoots looks for an exact 1.0
+	product[0] = a[0] * b[0];
+	return product;
+}
+
+void RootsToCoefficients::fft(std::vector<c128>& data, bool isInverse)
+{
+	fft(data, fftTwiddles(data.size(), isInverse));
+}
+
+std::vector<c128> RootsToCoefficients::fftTwiddles(size_t size, bool isInverse)
+{
+	// NOTE: twiddles straight from polar rather than by repeated multiplication, which would
+	// accumulate error along each stage
+	const double sign = isInverse ? 1.0 : -1.0;
+	std::vector<c128> twiddles(size / 2);
+	for (size_t k = 0; k < size / 2; k++)
+		twiddles[k] = std::polar(1.0, sign * juce::MathConstants<double>::twoPi * static_cast<double>(k) / static_cast<double>(size));
+	return twiddles;
+}
+
+void RootsToCoefficients::fft(std::vector<c128>& data, const std::vector<c128>& twiddles)
+{
+	const size_t size = data.size();
+	jassert(size > 0 && (size & (size - 1)) == 0);
+	jassert(twiddles.size() == size / 2);
+
+	for (size_t i = 1, j = 0; i < size; i++)
+	{
+		size_t bit = size >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j)
+			std::swap(data[i], data[j]);
+	}
+
+	for (size_t length = 2; length <= size; length <<= 1)
+	{
+		const size_t half = length / 2;
+		const size_t stride = size / length;
+		for (size_t start = 0; start < size; start += length)
+			for (size_t k = 0; k < half; k++)
+			{
+				// NOTE: written out on the parts, std::complex's operators check for infinities
+				// and NaNs and don't vectorise
+				const double wRe = twiddles[k * stride].real();
+				const double wIm = twiddles[k * stride].imag();
+				const double xRe = data[start + k + half].real();
+				const double xIm = data[start + k + half].imag();
+				const double oddRe = xRe * wRe - xIm * wIm;
+				const double oddIm = xRe * wIm + xIm * wRe;
+				const double evenRe = data[start + k].real();
+				const double evenIm = data[start + k].imag();
+				data[start + k + half] = c128(evenRe - oddRe, evenIm - oddIm);
+				data[start + k] = c128(evenRe + oddRe, evenIm + oddIm);
+			}
+	}
+}
+
 // NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
 /* Local Variables: */
 /* mode: c++ */
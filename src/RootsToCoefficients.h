@@ -4,10 +4,41 @@
 class RootsToCoefficients
 {
 public:
+	/* How the factors of the roots are multiplied together */
+	enum class Expansion
+	{
+		automatic,	// oneAtATime below ProductTreeMinOrder, productTree from there on
+		oneAtATime,	// each factor into the running product, O(order^2)
+		productTree	// neighbouring products in pairs, level by level, big ones by FFT, O(order log^2 order)
+	};
+
 	static std::vector<double> CalculatePolynomialCoefficientsFrom(
 		juce::OwnedArray<FilterRoot>& roots,
 		int minimalLength = 1,
-		std::vector<int>* usedRootsPtr = nullptr);
+		std::vector<int>* usedRootsPtr = nullptr,
+		Expansion expansion = Expansion::automatic);
+
+	/* Product of two polynomials, highest power first. By FFT once both have at least fftMinLength
+	   coefficients, directly below that. */
+	static std::vector<double> multiply(
+		const std::vector<double>& a,
+		const std::vector<double>& b,
+		size_t fftMinLength = FftMinLength);
+
+	/* From about this order pairwise products are as fast as one at a time (RootsToCoefficientsBenchmark),
+	   and they lose less accuracy: each coefficient sums fewer, more alike terms. */
+	static constexpr int ProductTreeMinOrder = 256;
+
+	/* The FFT's error is relative to the largest coefficient rather than to each one, which wipes out
+	   the small coefficients of a product of many roots inside the unit circle. It is only used where
+	   doubles can't hold those coefficients anyway, orders in the thousands. */
+	static constexpr size_t FftMinLength = 1024;
+
+	/* In-place radix-2 transform, data.size() a power of 2. The inverse is not scaled. */
+	static void fft(std::vector<c128>& data, bool isInverse);
+	/* The same with twiddles from fftTwiddles(data.size(), isInverse), for many transforms of one size */
+	static void fft(std::vector<c128>& data, const std::vector<c128>& twiddles);
+	static std::vector<c128> fftTwiddles(size_t size, bool isInverse);
 };
 
 // NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
@@ -0,0 +1,229 @@
+#include "SincResampler.h"
+
+static double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    const double halfX = 0.5 * x;
+    for (int k = 1; k < 64 && term > 1e-12 * sum; ++k)
+    {
+        const double t = halfX / k;
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+SincResampler::SincResampler(double sourceSampleRate, double targetSampleRate)
+    : ratio(sourceSampleRate / targetSampleRate)
+{
+    jassert(sourceSampleRate > 0 && targetSampleRate > 0);
+
+    const double bandwidth = std::min(1.0, 1.0 / ratio);
+    const double cutoff = cutoffAtUnity * bandwidth;
+    halfLength = (int)std::ceil(halfLengthAtUnity / bandwidth);
+    numTaps = (2 * halfLength + tapBlock - 1) / tapBlock * tapBlock;
+
+    table.assign((size_t)((numPhases + 1) * numTaps), 0.0f);
+    const double windowNorm = 1.0 / besselI0(kaiserBeta);
+    for (int phase = 0; phase <= numPhases; ++phase)
+    {
+        float* row = table.data() + phase * numTaps;
+        for (int tap = 0; tap < 2 * halfLength; ++tap)
+        {
+            // distance from the output position to the source sample this tap multiplies
+            const double t = tap - (halfLength - 1) - (double)phase / numPhases;
+            const double u = t / halfLength;
+            if (std::abs(u) >= 1.0)
+                continue;
+
+            const double x = juce::MathConstants<double>::pi * cutoff * t;
+            const double sinc = juce::exactlyEqual(x, 0.0) ? 1.0 : std::sin(x) / x;
+            const double window = besselI0(kaiserBeta * std::sqrt(1.0 - u * u)) * windowNorm;
+            row[tap] = (float)(cutoff * sinc * window);
+        }
+    }
+}
+
+bool SincResampler::isNeeded(double sourceSampleRate, double targetSampleRate)
+{
+    return sourceSampleRate > 0 && targetSampleRate > 0
+        && !juce::approximatelyEqual(sourceSampleRate, targetSampleRate);
+}
+
+juce::int64 SincResampler::getOutputLength(juce::int64 inputLength) const
+{
+    return (juce::int64)std::ceil((double)inputLength / ratio);
+}
+
+float SincResampler::interpolate(const float* input, int inputLength, int first, int phase, float alpha) const
+{
+    const float* row0 = table.data() + phase * numTaps;
+    const float* row1 = row0 + numTaps;
+
+    float acc0[tapBlock] = {}, acc1[tapBlock] = {};
+    if (first >= 0 && first + numTaps <= inputLength)
+    {
+        const float* x = input + first;
+        for (int tap = 0; tap < numTaps; tap += tapBlock)
+            for (int lane = 0; lane < tapBlock; ++lane)
+            {
+                acc0[lane] += x[tap + lane] * row0[tap + lane];
+                acc1[lane] += x[tap + lane] * row1[tap + lane];
+            }
+    }
+    else
+    {
+        // near the edges of the input, zero-pad
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            const int index = first + tap;
+            if (index >= 0 && index < inputLength)
+            {
+                acc0[0] += input[index] * row0[tap];
+                acc1[0] += input[index] * row1[tap];
+            }
+        }
+    }
+
+    float sum0 = 0.0f, sum1 = 0.0f;
+    for (int lane = 0; lane < tapBlock; ++lane)
+    {
+        sum0 += acc0[lane];
+        sum1 += acc1[lane];
+    }
+    return sum0 + alpha * (sum1 - sum0);
+}
+
+void SincResampler::process(const float* input, int inputLength, double startPosition, float* output, int numOutputSamples) const
+{
+    for (int i = 0; i < numOutputSamples; ++i)
+    {
+        const double position = startPosition + i * ratio;
+        const double base = std::floor(position);
+        const double phasePosition = (position - base) * numPhases;
+        const int phase = std::min((int)phasePosition, numPhases - 1);
+        const float alpha = (float)(phasePosition - phase);
+
+        output[i] = interpolate(input, inputLength, (int)base - halfLength + 1, phase, alpha);
+    }
+}
+
+//==============================================================================
+SincResamplingAudioSource::SincResamplingAudioSource(juce::PositionableAudioSource* inputSource,
+                                                     double sourceSampleRate, double targetSampleRate, int numChannels)
+    : input(inputSource), resampler(sourceSampleRate, targetSampleRate), inputBuffer(std::max(1, numChannels), 0)
+{
+    jassert(input != nullptr);
+    setNextReadPosition(0);
+}
+
+void SincResamplingAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    const int inputBlock = (int)std::ceil(samplesPerBlockExpected * resampler.getRatio()) + 2 * resampler.getHalfLength() + 1;
+    inputBuffer.setSize(inputBuffer.getNumChannels(), std::max(inputBuffer.getNumSamples(), inputBlock), true, false, true);
+    input->prepareToPlay(inputBlock, sampleRate * resampler.getRatio());
+}
+
+void SincResamplingAudioSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void SincResamplingAudioSource::fillInput(juce::int64 end)
+{
+    const auto wanted = (int)(end - inputStart);
+    if (wanted <= numBuffered)
+        return;
+
+    if (wanted > inputBuffer.getNumSamples())
+        inputBuffer.setSize(inputBuffer.getNumChannels(), wanted, true, false, true);
+
+    // source indices before the start of the file are silence
+    if (inputStart + numBuffered < 0)
+    {
+        const int numZeros = (int)std::min<juce::int64>(-(inputStart + numBuffered), wanted - numBuffered);
+        inputBuffer.clear(numBuffered, numZeros);
+        numBuffered += numZeros;
+    }
+
+    if (wanted > numBuffered)
+    {
+        juce::AudioSourceChannelInfo info(&inputBuffer, numBuffered, wanted - numBuffered);
+        input->getNextAudioBlock(info);
+        numBuffered = wanted;
+    }
+}
+
+void SincResamplingAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& info)
+{
+    const int numSamples = info.numSamples;
+    if (numSamples <= 0)
+        return;
+
+    const double ratio = resampler.getRatio();
+    const int halfLength = resampler.getHalfLength();
+    const double startPosition = (double)outputPosition * ratio;
+    const auto needStart = (juce::int64)std::floor(startPosition) - halfLength + 1;
+    const auto needEnd = (juce::int64)std::floor(startPosition + (numSamples - 1) * ratio) + halfLength + 1;
+
+    // drop the samples no output position can reach any more
+    const auto drop = (int)std::min<juce::int64>(needStart - inputStart, numBuffered);
+    if (drop > 0)
+    {
+        for (int ch = 0; ch < inputBuffer.getNumChannels(); ++ch)
+        {
+            auto* data = inputBuffer.getWritePointer(ch);
+            std::memmove(data, data + drop, sizeof(float) * (size_t)(numBuffered - drop));
+        }
+        numBuffered -= drop;
+        inputStart += drop;
+    }
+
+    fillInput(needEnd);
+
+    for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+    {
+        const int inputChannel = std::min(ch, inputBuffer.getNumChannels() - 1);
+        resampler.process(inputBuffer.getReadPointer(inputChannel), numBuffered, startPosition - (double)inputStart,
+                          info.buffer->getWritePointer(ch, info.startSample), numSamples);
+    }
+
+    outputPosition += numSamples;
+}
+
+void SincResamplingAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    outputPosition = newPosition;
+    inputStart = (juce::int64)std::floor((double)newPosition * resampler.getRatio()) - resampler.getHalfLength() + 1;
+    numBuffered = 0;
+    input->setNextReadPosition(std::max<juce::int64>(0, inputStart));
+}
+
+juce::int64 SincResamplingAudioSource::getNextReadPosition() const
+{
+    const auto length = getTotalLength();
+    return isLooping() && length > 0 ? outputPosition % length : outputPosition;
+}
+
+juce::int64 SincResamplingAudioSource::getTotalLength() const
+{
+    return resampler.getOutputLength(input->getTotalLength());
+}
+
+bool SincResamplingAudioSource::isLooping() const
+{
+    return input->isLooping();
+}
+
+void SincResamplingAudioSource::setLooping(bool shouldLoop)
+{
+    input->setLooping(shouldLoop);
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,88 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/** Polyphase windowed-sinc sample rate converter.
+ * The Kaiser-windowed kernel is tabulated once per rate pair, at numPhases
+ * fractional offsets, and linearly interpolated between neighbouring phases.
+ * When downsampling, the cutoff (and with it the kernel length) is scaled
+ * down so the output doesn't alias.
+ */
+class SincResampler
+{
+public:
+    SincResampler(double sourceSampleRate, double targetSampleRate);
+
+    /** source samples per target sample */
+    double getRatio() const { return ratio; }
+
+    /** number of source samples the kernel reaches on either side of an output position */
+    int getHalfLength() const { return halfLength; }
+
+    /** number of target samples covering inputLength source samples */
+    juce::int64 getOutputLength(juce::int64 inputLength) const;
+
+    /** Writes numOutputSamples samples, the i-th one taken at source position
+     * startPosition + i * getRatio() (measured from input[0]).
+     * Source samples outside [0, inputLength) are treated as silence.
+     */
+    void process(const float* input, int inputLength, double startPosition, float* output, int numOutputSamples) const;
+
+    static bool isNeeded(double sourceSampleRate, double targetSampleRate);
+
+private:
+    float interpolate(const float* input, int inputLength, int first, int phase, float alpha) const;
+
+    double ratio;
+    int halfLength;
+    int numTaps;
+    std::vector<float> table;   // (numPhases + 1) rows of numTaps coefficients
+
+    static constexpr int numPhases = 256;
+    static constexpr int tapBlock = 8;                // rows are padded to a multiple of this so the dot products vectorise
+    static constexpr int halfLengthAtUnity = 64;
+    static constexpr double cutoffAtUnity = 0.92;     // fraction of the lower Nyquist frequency
+    static constexpr double kaiserBeta = 8.0;         // ~80 dB stopband
+};
+
+/** Streams a PositionableAudioSource through a SincResampler.
+ * The input is only ever read forwards, except after setNextReadPosition(),
+ * so it is cheap to put in front of a compressed file reader. Meant to sit
+ * behind a BufferingAudioSource so the filtering happens off the audio
+ * thread.
+ */
+class SincResamplingAudioSource final : public juce::PositionableAudioSource
+{
+public:
+    SincResamplingAudioSource(juce::PositionableAudioSource* inputSource,
+                              double sourceSampleRate, double targetSampleRate, int numChannels);
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& info) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+private:
+    void fillInput(juce::int64 end);
+
+    juce::PositionableAudioSource* input;
+    SincResampler resampler;
+    juce::AudioBuffer<float> inputBuffer;
+    juce::int64 inputStart = 0;     // source index of inputBuffer's first sample
+    int numBuffered = 0;
+    juce::int64 outputPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SincResamplingAudioSource)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,255 @@
+#include "TimeResponseCalculator.h"
+#include "RootsToCoefficients.h"
+
+class TimeResponseCalculator::Job final : public juce::ThreadPoolJob
+{
+public:
+    Job(TimeResponseCalculator& ownerToNotify, CompiledChain::Ptr chainToRender, const RootSnapshot& snapshotToCompare, double gainToCompare, u64 revisionToRender)
+        : juce::ThreadPoolJob("Time response"), owner(ownerToNotify), chain(std::move(chainToRender)),
+          snapshot(snapshotToCompare), gain(gainToCompare), revision(revisionToRender)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        Response rendered;
+        rendered.length = responseLength(snapshot.poles, *chain, rendered.isDecaying);
+        const int analysisLength = rendered.isDecaying
+            ? std::max(rendered.length, responseLength(snapshot.poles, *chain, rendered.isDecaying, analysisDecayDb))
+            : rendered.length;
+        if (!render(*chain, analysisLength, rendered.impulse, rendered.step, [this] { return shouldExit(); }))
+            return jobHasFinished;
+
+        // NOTE: an unstable chain's response tells nothing about its rounding
+        if (rendered.isDecaying)
+        {
+            if (shouldExit())
+                return jobHasFinished;
+            rendered.snrDb = realisationError(snapshot, gain, rendered.impulse, rendered.errorDb);
+            if (shouldExit())
+                return jobHasFinished;
+        }
+
+        rendered.revision = revision;
+        rendered.isValid = true;
+        {
+            const juce::ScopedLock scopedLock(owner.lock);
+            owner.response = std::move(rendered);
+        }
+
+        finished.store(true);
+        owner.sendChangeMessage();
+        return jobHasFinished;
+    }
+
+    TimeResponseCalculator& owner;
+    const CompiledChain::Ptr chain;
+    const RootSnapshot snapshot;
+    const double gain;
+    const u64 revision;
+
+    std::atomic<bool> finished{ false };
+};
+
+TimeResponseCalculator::TimeResponseCalculator()
+{
+}
+
+TimeResponseCalculator::~TimeResponseCalculator()
+{
+    cancel();
+}
+
+void TimeResponseCalculator::start(CompiledChain::Ptr chain, const RootSnapshot& snapshot, double gain, u64 revision)
+{
+    retire();
+
+    requestedRevision.store(revision);
+    job = std::make_unique<Job>(*this, std::move(chain), snapshot, gain, revision);
+    pool.addJobToPool(job.get(), false);
+}
+
+void TimeResponseCalculator::retire()
+{
+    // NOTE: the pool has one thread, so a render that is still stopping only
+    // delays the next one, and it publishes nothing once it has been told to stop
+    if (job != nullptr)
+    {
+        if (!pool.removeJob(job.get(), true, 0))
+            stopping.push_back(std::move(job));
+        job.reset();
+    }
+    stopping.erase(
+        std::remove_if(stopping.begin(), stopping.end(), [this](const std::unique_ptr<Job>& old) { return pool.removeJob(old.get(), true, 0); }),
+        stopping.end());
+}
+
+void TimeResponseCalculator::cancel()
+{
+    if (job != nullptr)
+        stopping.push_back(std::move(job));
+    for (auto& old : stopping)
+        pool.removeJob(old.get(), true, -1);
+    stopping.clear();
+}
+
+bool TimeResponseCalculator::isRendering() const
+{
+    return job != nullptr && !job->finished.load();
+}
+
+bool TimeResponseCalculator::getResponse(Response& destination) const
+{
+    const juce::ScopedLock scopedLock(lock);
+    if (!response.isValid)
+        return false;
+
+    destination = response;
+    return true;
+}
+
+int TimeResponseCalculator::responseLength(
+    const RootSnapshot::Roots& poles,
+    const CompiledChain& chain,
+    bool& isDecaying,
+    double decayDb)
+{
+    isDecaying = true;
+    const double logDecay = decayDb / 20.0 * std::log(10.0);
+    double decayLength = 0.0;
+
+    for (size_t i = 0; i < poles.size(); i++)
+    {
+        const double radius = std::hypot(poles.re[i], poles.im[i]);
+        if (radius >= 1.0)
+        {
+            isDecaying = false;
+            return maxLength;
+        }
+        // NOTE: poles at the origin are delays, the chain's delay count has them
+        if (juce::exactlyEqual(radius, 0.0))
+            continue;
+
+        // the envelope's log, (m - 1) ln n - a n, falls by logDecay from its peak
+        const double a = -std::log(radius);
+        const double m1 = static_cast<double>(poles.order[i] - 1);
+        const auto logEnvelope = [a, m1](double n) { return m1 * std::log(n) - a * n; };
+        const double peak = std::max(1.0, m1 / a);
+        const double target = logEnvelope(peak) - logDecay;
+
+        double low = peak, high = peak + logDecay / a;
+        while (logEnvelope(high) > target && high < maxLength)
+            high *= 2.0;
+        for (int iteration = 0; iteration < 40 && high - low > 0.5; iteration++)
+        {
+            const double middle = 0.5 * (low + high);
+            (logEnvelope(middle) > target ? low : high) = middle;
+        }
+        decayLength = std::max(decayLength, high);
+    }
+
+    const double firLength = chain.firCoefficients != nullptr ? static_cast<double>(chain.firCoefficients->getFilterOrder() + 1) : 1.0;
+    const double length = std::ceil(chain.delayCount + firLength + decayLength);
+    return static_cast<int>(juce::jlimit(static_cast<double>(minLength), static_cast<double>(maxLength), length));
+}
+
+bool TimeResponseCalculator::render(
+    const CompiledChain& chain,
+    int length,
+    std::vector<float>& impulse,
+    std::vector<float>& step,
+    const std::function<bool()>& shouldExit)
+{
+    impulse.assign(static_cast<size_t>(length), 0.f);
+    step.assign(static_cast<size_t>(length), 1.f);
+    if (length > 0)
+        impulse[0] = 1.f;
+
+    // NOTE: the chain works in samples, the rate only prepares the gain's
+    // smoothing, which the compiled chains leave off
+    juce::dsp::ProcessSpec spec{ 48000.0, static_cast<juce::uint32>(blockSize), 1 };
+    for (auto* signal : { &impulse, &step })
+    {
+        FullState<float> state;
+        state.add(new ProcessorChain<float>);
+        ProcessorChainModifier::apply(chain, &state, spec);
+
+        for (int position = 0; position < length; position += blockSize)
+        {
+            if (shouldExit != nullptr && shouldExit())
+                return false;
+
+            float* channels[] = { signal->data() + position };
+            juce::dsp::AudioBlock<float> block(channels, 1, static_cast<size_t>(std::min(blockSize, length - position)));
+            juce::dsp::ProcessContextReplacing<float> context(block);
+            state[0]->process(context);
+        }
+    }
+    return true;
+}
+
+double TimeResponseCalculator::realisationError(
+    const RootSnapshot& snapshot,
+    double gain,
+    const std::vector<float>& impulse,
+    std::vector<float>& errorDb)
+{
+    // bin i of a transform of size 2 count is at angle pi i / count, as in evaluateUniform
+    size_t count = 1;
+    while (2 * count < impulse.size())
+        count *= 2;
+
+    std::vector<c128> spectrum(2 * count, 0.0);
+    std::copy(impulse.begin(), impulse.end(), spectrum.begin());
+    RootsToCoefficients::fft(spectrum, false);
+
+    std::vector<double> logMagnitudes(count), phases(count);
+    PhaseFrequencyResponseCalculator::evaluateUniform(snapshot, count, logMagnitudes.data(), phases.data());
+
+    double signal = 0.0, noise = 0.0;
+    std::vector<double> errors(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const c128 expected = std::polar(gain * std::exp(logMagnitudes[i]), phases[i]);
+        errors[i] = std::norm(spectrum[i] - expected);
+        signal += std::norm(expected);
+        noise += errors[i];
+    }
+
+    errorDb.resize(count);
+    const double rms = std::sqrt(signal / static_cast<double>(count));
+    for (size_t i = 0; i < count; i++)
+        errorDb[i] = static_cast<float>(juce::Decibels::gainToDecibels(std::sqrt(errors[i]) / rms, minErrorDb));
+
+    // NOTE: a chain can be exact, e.g. a pure delay
+    if (!(noise > 0.0))
+        return -minErrorDb;
+    return std::min(-minErrorDb, juce::Decibels::gainToDecibels(std::sqrt(signal / noise), minErrorDb));
+}
+
+void TimeResponseCalculator::decimate(
+    const float* values,
+    int count,
+    int columns,
+    float* minima,
+    float* maxima)
+{
+    jassert(count >= columns && columns > 0);
+    for (int column = 0; column < columns; column++)
+    {
+        const auto begin = static_cast<int>(static_cast<juce::int64>(column) * count / columns);
+        const auto end = std::min(count, static_cast<int>(static_cast<juce::int64>(column + 1) * count / columns) + 1);
+        const auto [low, high] = std::minmax_element(values + begin, values + end);
+        minima[column] = *low;
+        maxima[column] = *high;
+    }
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,136 @@
+#pragma once
+#include "PhaseFrequencyResponseCalculator.h"
+#include "ProcessorChainModifier.h"
+
+/** Renders the impulse and step responses of the filter as the processor
+ * realises it: the compiled chain is run offline, in float, on a unit impulse
+ * and on a unit step, so rounding in the sections shows up as it would when
+ * playing. The spectrum of the impulse response is compared with the roots'
+ * response, which measures what the pairing, ordering and float precision of
+ * the chain cost. Renders run on a background thread, and a change message is
+ * sent when one finishes.
+ */
+class TimeResponseCalculator final : public juce::ChangeBroadcaster
+{
+public:
+    /** the responses rendered for one revision of the filter */
+    struct Response
+    {
+        u64 revision = 0;
+        bool isValid = false;
+        /** false when a pole is on or outside the unit circle and the
+         * responses were cut at maxLength */
+        bool isDecaying = true;
+        /** the samples worth showing, responseLength; the responses go on
+         * to the length the error was measured over */
+        int length = 0;
+        std::vector<float> impulse, step;
+        /** the realisation error at angle pi i / errorDb.size(), in dB below
+         * the RMS of the roots' response, and its signal to noise ratio over
+         * the whole band. Empty and 0 when not decaying. */
+        std::vector<float> errorDb;
+        double snrDb = 0.0;
+    };
+
+    TimeResponseCalculator();
+    ~TimeResponseCalculator() override;
+
+    /** Starts rendering the responses of the chain compiled from a revision
+     * of the filter, whose roots and gain are given for the error analysis.
+     * The latest start wins: a render already running is told to stop and
+     * publishes nothing, but isn't waited for, so a drag that restarts on
+     * every move never blocks the caller.
+     */
+    void start(CompiledChain::Ptr chain, const RootSnapshot& snapshot, double gain, u64 revision);
+
+    /** Cancels the running render, if any, and any still stopping. Blocks
+     * until they all have. */
+    void cancel();
+
+    bool isRendering() const;
+    /** the revision being rendered, or the last one finished; the largest u64
+     * before the first render */
+    u64 getRequestedRevision() const { return requestedRevision; }
+
+    /** Copies the last finished responses. Returns false if none has finished. */
+    bool getResponse(Response& destination) const;
+
+    /** Samples until the slowest pole's envelope has decayed by decayDb, after
+     * the chain's delay and FIR have passed, within minLength and maxLength.
+     * A pole of order m has an envelope n^(m-1) |p|^n, whose peak comes first.
+     * isDecaying is set to false, and maxLength returned, if a pole is on or
+     * outside the unit circle.
+     */
+    static int responseLength(
+        const RootSnapshot::Roots& poles,
+        const CompiledChain& chain,
+        bool& isDecaying,
+        double decayDb = defaultDecayDb);
+
+    /** Runs the chain on a unit impulse and on a unit step, blockSize samples
+     * at a time, stopping early once shouldExit returns true. Returns false
+     * if it stopped early.
+     */
+    static bool render(
+        const CompiledChain& chain,
+        int length,
+        std::vector<float>& impulse,
+        std::vector<float>& step,
+        const std::function<bool()>& shouldExit = nullptr);
+
+    /** The realisation error of an impulse response: its spectrum, by a
+     * transform of a power of 2 at least as long, against gain times the
+     * response of the roots at the same angles. Returns the SNR in dB, the
+     * energy of the roots' response over that of the difference.
+     */
+    static double realisationError(
+        const RootSnapshot& snapshot,
+        double gain,
+        const std::vector<float>& impulse,
+        std::vector<float>& errorDb);
+
+    /** The smallest and largest value in each of columns equal parts of
+     * values, each part reaching one sample into the next, so the vertical
+     * lines drawn from them join up. For count >= columns. */
+    static void decimate(
+        const float* values,
+        int count,
+        int columns,
+        float* minima,
+        float* maxima);
+
+    static constexpr double defaultDecayDb = 80.0;
+    /** the error is measured over the decay by this much, so the truncation
+     * stays below the noise of float sections */
+    static constexpr double analysisDecayDb = 160.0;
+    /** errorDb's floor, for bins where the chain is exact */
+    static constexpr double minErrorDb = -300.0;
+    static constexpr int minLength = 64;
+    static constexpr int maxLength = 1 << 18;
+    static constexpr int blockSize = 512;
+
+private:
+    class Job;
+
+    /** tells the running render to stop, and frees those that have */
+    void retire();
+
+    juce::ThreadPool pool{ 1 };
+    std::unique_ptr<Job> job;
+    std::vector<std::unique_ptr<Job>> stopping;
+    std::atomic<u64> requestedRevision{ std::numeric_limits<u64>::max() };
+
+    mutable juce::CriticalSection lock;
+    Response response;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeResponseCalculator)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,224 @@
+#include "TimeResponseViewer.h"
+
+TimeResponseViewer::TimeResponseViewer(AudioPluginAudioProcessor* p) :
+    processor(p),
+    impulseButton("Impulse"),
+    stepButton("Step"),
+    errorButton("Error")
+{
+    this->processor->addChangeListener(this);
+    this->processor->filterState->um->addChangeListener(this);
+    calculator.addChangeListener(this);
+
+    impulseButton.onClick = [this] { repaint(); };
+    impulseButton.setClickingTogglesState(true);
+    impulseButton.setRadioGroupId(1);
+    impulseButton.setToggleState(true, juce::dontSendNotification);
+    impulseButton.setTooltip("Show the impulse response of the chain as it is played");
+
+    stepButton.onClick = [this] { repaint(); };
+    stepButton.setClickingTogglesState(true);
+    stepButton.setRadioGroupId(1);
+    stepButton.setTooltip("Show the step response of the chain as it is played");
+
+    errorButton.onClick = [this] { repaint(); };
+    errorButton.setClickingTogglesState(true);
+    errorButton.setRadioGroupId(1);
+    errorButton.setTooltip("Show how far the response of the chain as it is played is from the response of the roots");
+
+    addAndMakeVisible(impulseButton);
+    addAndMakeVisible(stepButton);
+    addAndMakeVisible(errorButton);
+}
+
+TimeResponseViewer::~TimeResponseViewer()
+{
+    calculator.removeChangeListener(this);
+    calculator.cancel();
+    processor->filterState->um->removeChangeListener(this);
+    processor->removeChangeListener(this);
+}
+
+void TimeResponseViewer::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source == &calculator)
+        calculator.getResponse(response);
+    repaint();
+}
+
+void TimeResponseViewer::resized()
+{
+    impulseButton.setBounds(padding, padding, buttonsWidth, buttonsHeight);
+    stepButton.setBounds(impulseButton.getRight() + padding, padding, buttonsWidth, buttonsHeight);
+    errorButton.setBounds(stepButton.getRight() + padding, padding, errorButtonWidth, buttonsHeight);
+    repaint();
+}
+
+void TimeResponseViewer::paint(juce::Graphics& g)
+{
+    g.fillAll(backgroundColor);
+    updateResponse();
+
+    const juce::Rectangle<int> rect(
+        plotPaddingLeft,
+        plotPaddingTop,
+        getWidth() - plotPaddingLeft - plotPaddingRight,
+        getHeight() - plotPaddingTop - plotPaddingBottom);
+    if (rect.getWidth() <= 0 || rect.getHeight() <= 0 || !response.isValid)
+        return;
+
+    juce::String status;
+    if (errorButton.getToggleState())
+    {
+        const auto& errorDb = response.errorDb;
+        paintResponse(g, errorDb.data(), static_cast<int>(errorDb.size()), rect, minErrorDb, 0.f, 0, " dB", "0", nyquistText());
+        status = response.isDecaying ? "SNR " + juce::String(response.snrDb, 1) + " dB" : "not decaying";
+    }
+    else
+    {
+        const auto& values = stepButton.getToggleState() ? response.step : response.impulse;
+        const int count = std::min(response.length, static_cast<int>(values.size()));
+
+        // NOTE: a pole outside the unit circle overflows the floats in the end,
+        // the scale is taken from what is still finite
+        float largest = 0.f;
+        for (int i = 0; i < count; i++)
+        {
+            const float value = values[static_cast<size_t>(i)];
+            if (std::isfinite(value))
+                largest = std::max(largest, std::abs(value));
+        }
+        const float yAmplitude = largest > 0.f ? 1.1f * largest : 1.f;
+        paintResponse(g, values.data(), count, rect, -yAmplitude, yAmplitude, 2, "", timeText(0), timeText(count));
+
+        status = juce::String(count) + " samples";
+        if (!response.isDecaying)
+            status << ", not decaying";
+    }
+
+    g.setColour(lineColour);
+    const int textLeft = errorButton.getRight() + padding;
+    if (response.revision != processor->filterState->revision)
+        status << ", updating";
+    g.drawText(status, textLeft, padding, getWidth() - padding - textLeft, buttonsHeight, juce::Justification::centredRight);
+}
+
+void TimeResponseViewer::updateResponse()
+{
+    const auto* state = processor->filterState.get();
+    if (calculator.getRequestedRevision() == state->revision)
+        return;
+
+    // NOTE: the chain is the one the processor plays, so this is a lookup
+    // in its cache unless the filter has just changed
+    auto chain = processor->chainCache.getOrCompile(processor->filterState.get(), processor->chainCompileOptions);
+    RootSnapshot snapshot;
+    snapshot.capture(*state);
+    calculator.start(chain, snapshot, state->gain.get(), state->revision);
+}
+
+void TimeResponseViewer::paintResponse(
+    juce::Graphics& g,
+    const float* values,
+    int count,
+    juce::Rectangle<int> rect,
+    float yLow,
+    float yHigh,
+    int yDecimals,
+    juce::String unitText,
+    juce::String xBeginText,
+    juce::String xEndText)
+{
+    const int width = rect.getWidth();
+    const float yTop = static_cast<float>(rect.getY());
+    const float yBottom = static_cast<float>(rect.getBottom());
+    const auto toY = [=](float value) { return juce::jmap(juce::jlimit(yLow, yHigh, value), yLow, yHigh, yBottom, yTop); };
+
+    g.setColour(gridColour);
+    g.drawRect(rect, 1);
+    g.drawHorizontalLine(rect.getCentreY(), static_cast<float>(rect.getX()), static_cast<float>(rect.getRight()));
+
+    // Y grid
+    g.setColour(lineColour);
+    const int labelWidth = plotPaddingLeft - 3 * padding;
+    const float yMiddle = 0.5f * (yLow + yHigh);
+    g.drawText(juce::String(yHigh, yDecimals) + unitText, padding, rect.getY() - textHeight / 2, labelWidth, textHeight, juce::Justification::centredRight);
+    g.drawText(juce::exactlyEqual(yMiddle, 0.f) ? juce::String("0") : juce::String(yMiddle, yDecimals) + unitText,
+        padding, rect.getCentreY() - textHeight / 2, labelWidth, textHeight, juce::Justification::centredRight);
+    g.drawText(juce::String(yLow, yDecimals) + unitText, padding, rect.getBottom() - textHeight / 2, labelWidth, textHeight, juce::Justification::centredRight);
+
+    // X grid
+    const int xTextY = rect.getBottom() + padding;
+    g.drawText(xBeginText, rect.getX() - textWidth / 2, xTextY, textWidth, textHeight, juce::Justification::centred);
+    g.drawText(xEndText, rect.getRight() - textWidth / 2, xTextY, textWidth, textHeight, juce::Justification::centred);
+    if (count < 2)
+        return;
+
+    const juce::Graphics::ScopedSaveState saveState(g);
+    g.reduceClipRegion(rect);
+    g.setColour(traceColour);
+
+    if (count > width)
+    {
+        // min/max decimation, a vertical line per column
+        minima.resize(static_cast<size_t>(width));
+        maxima.resize(static_cast<size_t>(width));
+        TimeResponseCalculator::decimate(values, count, width, minima.data(), maxima.data());
+        for (int column = 0; column < width; column++)
+        {
+            const auto i = static_cast<size_t>(column);
+            if (!std::isfinite(minima[i]) || !std::isfinite(maxima[i]))
+                continue;
+
+            const float top = toY(maxima[i]);
+            g.drawVerticalLine(rect.getX() + column, top, std::max(toY(minima[i]), top + 1.f));
+        }
+    }
+    else
+    {
+        juce::Path path;
+        bool isNewSubPath = true;
+        for (int i = 0; i < count; i++)
+        {
+            const float value = values[i];
+            if (!std::isfinite(value))
+            {
+                isNewSubPath = true;
+                continue;
+            }
+
+            const float x = static_cast<float>(rect.getX()) + static_cast<float>(i) * width / (count - 1);
+            if (isNewSubPath)
+                path.startNewSubPath(x, toY(value));
+            else
+                path.lineTo(x, toY(value));
+            isNewSubPath = false;
+        }
+        g.strokePath(path, juce::PathStrokeType(1.5f));
+    }
+}
+
+juce::String TimeResponseViewer::timeText(int sample) const
+{
+    const double sampleRate = processor->getSampleRate();
+    if (sampleRate <= 0)
+        return juce::String(sample) + " smp.";
+    return juce::String(1e3 * sample / sampleRate, 1) + " ms";
+}
+
+juce::String TimeResponseViewer::nyquistText() const
+{
+    const double sampleRate = processor->getSampleRate();
+    if (sampleRate <= 0)
+        return "pi";
+    return juce::String(sampleRate / 2000, 1) + " kHz";
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,78 @@
+#pragma once
+#include "TimeResponseCalculator.h"
+
+/** Shows the impulse or the step response of the chain the processor plays,
+ * rendered by a TimeResponseCalculator, or how far the chain's response is
+ * from the roots' over frequency. With more samples than pixels every column
+ * shows the range of its samples, so no spike is lost.
+ */
+class TimeResponseViewer final :
+    public juce::Component,
+    juce::ChangeListener
+{
+public:
+    TimeResponseViewer(AudioPluginAudioProcessor* p);
+    ~TimeResponseViewer();
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    void resized() override;
+    void paint(juce::Graphics& g) override;
+
+private:
+    /** starts a render if the filter changed since the last one was asked for */
+    void updateResponse();
+
+    /** values from yLow at the bottom to yHigh at the top, labelled with
+     * yDecimals and the unit, and the X axis from xBeginText to xEndText */
+    void paintResponse(
+        juce::Graphics& g,
+        const float* values,
+        int count,
+        juce::Rectangle<int> rect,
+        float yLow,
+        float yHigh,
+        int yDecimals,
+        juce::String unitText,
+        juce::String xBeginText,
+        juce::String xEndText);
+    /** the time of a sample as text, in ms when the sample rate is known */
+    juce::String timeText(int sample) const;
+    /** Nyquist as text, in kHz when the sample rate is known */
+    juce::String nyquistText() const;
+
+    const juce::Colour
+        backgroundColor = juce::Colour(0x08, 0x0C, 0x1C),
+        lineColour = juce::Colours::white,
+        gridColour = juce::Colours::darkgrey,
+        traceColour = juce::Colours::yellow.withAlpha(0.85f);
+    const int
+        padding = 5,
+        plotPaddingLeft = 72,
+        plotPaddingRight = 45,
+        plotPaddingTop = 30,
+        plotPaddingBottom = 20,
+        buttonsHeight = 20,
+        buttonsWidth = 55,
+        errorButtonWidth = 45,
+        textWidth = 60,
+        textHeight = 10;
+
+    /** the error plot's range, dB below the RMS of the response */
+    const float minErrorDb = -180.f;
+
+    AudioPluginAudioProcessor* processor;
+
+    juce::TextButton impulseButton, stepButton, errorButton;
+    TimeResponseCalculator calculator;
+    TimeResponseCalculator::Response response;
+    std::vector<float> minima, maxima;
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
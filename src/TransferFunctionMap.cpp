@@ -0,0 +1,285 @@
+#include "TransferFunctionMap.h"
+
+TransferFunctionMap::TileKey TransferFunctionMap::keyOf(int column, int row)
+{
+    return (static_cast<u64>(static_cast<u32>(column)) << 32) | static_cast<u32>(row);
+}
+
+void TransferFunctionMap::update(
+    const RootSnapshot& snapshot,
+    double gain,
+    double newUnitsPerPixel,
+    double left,
+    double right,
+    double bottom,
+    double top,
+    WorkerPool* pool)
+{
+    if (!hasColourMap)
+    {
+        juce::ColourGradient gradient(
+            juce::Colours::royalblue.withAlpha(0.75f), 0.0f, 0.0f,
+            juce::Colours::orangered.withAlpha(0.75f), 1.0f, 0.0f,
+            false);
+        gradient.addColour(0.5, juce::Colours::transparentBlack);
+        for (size_t i = 0; i < colourMap.size(); i++)
+        {
+            auto argb = gradient.getColourAtPosition(static_cast<double>(i) / (colourMap.size() - 1)).getPixelARGB();
+            argb.premultiply();
+            colourMap[i] = argb;
+        }
+        hasColourMap = true;
+    }
+
+    if (!juce::exactlyEqual(unitsPerPixel, newUnitsPerPixel))
+    {
+        tiles.clear();
+        unitsPerPixel = newUnitsPerPixel;
+    }
+    else if (hasMapped && !accountForMoves(snapshot))
+    {
+        for (auto& [key, tile] : tiles)
+            tile.errorBound = std::numeric_limits<double>::infinity();
+    }
+    if (hasMapped && !juce::exactlyEqual(mappedGain, gain))
+    {
+        for (auto& [key, tile] : tiles)
+            tile.isColoured = false;
+    }
+    mapped = snapshot;
+    mappedGain = gain;
+    hasMapped = true;
+
+    // the tiles in view, new ones and those the moves may have changed too much
+    const double tileUnits = getTileUnits();
+    const auto firstColumn = static_cast<int>(std::floor(left / tileUnits));
+    const auto lastColumn = static_cast<int>(std::floor(right / tileUnits));
+    const auto firstRow = static_cast<int>(std::floor(-top / tileUnits));
+    const auto lastRow = static_cast<int>(std::floor(-bottom / tileUnits));
+    const double maxError = maxErrorDb / 20.0 * std::log(10.0);
+
+    visibleTiles.clear();
+    std::vector<Tile*> stale;
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            auto [it, isNew] = tiles.try_emplace(keyOf(column, row));
+            auto& tile = it->second;
+            if (isNew)
+            {
+                tile.column = column;
+                tile.row = row;
+                tile.errorBound = std::numeric_limits<double>::infinity();
+            }
+            if (tile.errorBound > maxError)
+                stale.push_back(&tile);
+            else
+                keptTiles++;
+            visibleTiles.push_back(&tile);
+        }
+    }
+    evaluate(stale, pool);
+
+    for (auto* tile : visibleTiles)
+    {
+        if (!tile->isColoured)
+            colour(*const_cast<Tile*>(tile));
+    }
+
+    if (tiles.size() > visibleTiles.size() + maxSpareTiles)
+    {
+        for (auto it = tiles.begin(); it != tiles.end();)
+        {
+            const auto& tile = it->second;
+            const bool isVisible = tile.column >= firstColumn && tile.column <= lastColumn && tile.row >= firstRow && tile.row <= lastRow;
+            it = isVisible ? std::next(it) : tiles.erase(it);
+        }
+    }
+}
+
+void TransferFunctionMap::evaluate(const std::vector<Tile*>& stale, WorkerPool* pool)
+{
+    const double tileUnits = getTileUnits();
+    const auto evaluateOne = [&](size_t item)
+    {
+        auto& tile = *stale[item];
+        tile.logMagnitudes.resize(static_cast<size_t>(tileSize * tileSize));
+        evaluateTile(mapped, tile.column * tileUnits, -tile.row * tileUnits, unitsPerPixel, tileSize, tile.logMagnitudes.data());
+        tile.errorBound = 0.0;
+        tile.isColoured = false;
+    };
+
+    // NOTE: images are made here, the workers only write their pixels
+    for (auto* tile : stale)
+    {
+        if (!tile->image.isValid())
+            tile->image = juce::Image(juce::Image::ARGB, tileSize, tileSize, false, juce::SoftwareImageType());
+    }
+
+    if (pool != nullptr && stale.size() > 1)
+        pool->parallelFor(stale.size(), [&](size_t item, int) { evaluateOne(item); colour(*stale[item]); });
+    else
+    {
+        for (size_t item = 0; item < stale.size(); item++)
+            evaluateOne(item);
+    }
+    evaluatedTiles += static_cast<u32>(stale.size());
+}
+
+void TransferFunctionMap::colour(Tile& tile)
+{
+    const double gainDb = juce::Decibels::gainToDecibels(std::abs(mappedGain), -300.0);
+    const double dbPerNeper = 20.0 / std::log(10.0);
+    const double lastIndex = static_cast<double>(colourMap.size() - 1);
+
+    const juce::Image::BitmapData pixels(tile.image, juce::Image::BitmapData::writeOnly);
+    for (int y = 0; y < tileSize; y++)
+    {
+        const float* logs = tile.logMagnitudes.data() + y * tileSize;
+        for (int x = 0; x < tileSize; x++)
+        {
+            // NOTE: -inf on a zero and +inf on a pole take the ends of the map,
+            // NaN where one sits on the other the middle
+            const double db = dbPerNeper * logs[x] + gainDb;
+            const double position = std::isnan(db) ? 0.5 : juce::jlimit(0.0, 1.0, (db + rangeDb) / (2.0 * rangeDb));
+            *reinterpret_cast<juce::PixelARGB*>(pixels.getPixelPointer(x, y)) = colourMap[static_cast<size_t>(position * lastIndex + 0.5)];
+        }
+    }
+    tile.isColoured = true;
+}
+
+bool TransferFunctionMap::isSameRootSet(const RootSnapshot::Roots& a, const RootSnapshot::Roots& b)
+{
+    return a.order == b.order && a.isReal == b.isReal;
+}
+
+bool TransferFunctionMap::accountForMoves(const RootSnapshot& snapshot)
+{
+    if (!isSameRootSet(mapped.zeros, snapshot.zeros) || !isSameRootSet(mapped.poles, snapshot.poles))
+        return false;
+
+    const double tileUnits = getTileUnits();
+    for (auto [from, to] : { std::pair{ &mapped.zeros, &snapshot.zeros }, std::pair{ &mapped.poles, &snapshot.poles } })
+    {
+        for (size_t k = 0; k < to->size(); k++)
+        {
+            const c128 a(from->re[k], from->im[k]), b(to->re[k], to->im[k]);
+            if (a == b)
+                continue;
+
+            // NOTE: a pair moves both of its roots, mirrored
+            for (auto& [key, tile] : tiles)
+            {
+                const double tileLeft = tile.column * tileUnits, tileTop = -tile.row * tileUnits;
+                double bound = moveBound(tileLeft, tileLeft + tileUnits, tileTop - tileUnits, tileTop, a, b);
+                if (!from->isReal[k])
+                    bound += moveBound(tileLeft, tileLeft + tileUnits, tileTop - tileUnits, tileTop, std::conj(a), std::conj(b));
+                tile.errorBound += from->order[k] * bound;
+            }
+        }
+    }
+    return true;
+}
+
+double TransferFunctionMap::moveBound(
+    double left,
+    double right,
+    double bottom,
+    double top,
+    c128 from,
+    c128 to)
+{
+    // d/dw ln|z - w| is at most 1 / |z - w| in any direction, and w stays in the box
+    const double dx = std::max({ 0.0, std::min(from.real(), to.real()) - right, left - std::max(from.real(), to.real()) });
+    const double dy = std::max({ 0.0, std::min(from.imag(), to.imag()) - top, bottom - std::max(from.imag(), to.imag()) });
+    const double distance = std::hypot(dx, dy);
+    if (juce::exactlyEqual(distance, 0.0))
+        return std::numeric_limits<double>::infinity();
+    return std::abs(to - from) / distance;
+}
+
+void TransferFunctionMap::evaluateTile(
+    const RootSnapshot& snapshot,
+    double left,
+    double top,
+    double step,
+    int size,
+    float* logMagnitudes)
+{
+    const auto count = static_cast<size_t>(size);
+    std::vector<double> xs(count), logs(count), zeroProducts(count), poleProducts(count);
+    for (size_t i = 0; i < count; i++)
+        xs[i] = left + (static_cast<double>(i) + 0.5) * step;
+
+    for (int row = 0; row < size; row++)
+    {
+        const double y = top - (row + 0.5) * step;
+        std::fill(logs.begin(), logs.end(), 0.0);
+
+        for (auto [roots, products, sign] : { std::tuple{ &snapshot.zeros, &zeroProducts, 1.0 }, std::tuple{ &snapshot.poles, &poleProducts, -1.0 } })
+        {
+            double* product = products->data();
+            std::fill(products->begin(), products->end(), 1.0);
+            int sinceLog = 0;
+            const auto takeLog = [&]
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    logs[i] += sign * std::log(product[i]);
+                    product[i] = 1.0;
+                }
+                sinceLog = 0;
+            };
+
+            for (size_t k = 0; k < roots->size(); k++)
+            {
+                const double re = roots->re[k];
+                const double dy = y - roots->im[k];
+                const double dy2 = dy * dy;
+                const double conjugateDy = y + roots->im[k];
+                const double conjugateDy2 = conjugateDy * conjugateDy;
+                const int factors = roots->isReal[k] ? 1 : 2;
+
+                for (int o = 0; o < roots->order[k]; o++)
+                {
+                    if (sinceLog + factors > factorsPerLog)
+                        takeLog();
+                    if (roots->isReal[k])
+                    {
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            const double dx = xs[i] - re;
+                            product[i] *= dx * dx + dy2;
+                        }
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            const double dx2 = (xs[i] - re) * (xs[i] - re);
+                            product[i] *= (dx2 + dy2) * (dx2 + conjugateDy2);
+                        }
+                    }
+                    sinceLog += factors;
+                }
+            }
+            if (sinceLog > 0)
+                takeLog();
+        }
+
+        // the products are of squared distances
+        float* out = logMagnitudes + row * size;
+        for (size_t i = 0; i < count; i++)
+            out[i] = static_cast<float>(0.5 * logs[i]);
+    }
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,120 @@
+#pragma once
+#include "PhaseFrequencyResponseCalculator.h"
+
+/** ln|H(z)| over the visible part of the z plane, coloured for the overlay of
+ * ComplexPlaneEditor.
+ * The plane is cut into square tiles of tileSize pixels anchored to the world
+ * origin, so panning reuses every tile still in view; a change of zoom clears
+ * them. When roots only move, a tile is kept as long as the change the moves
+ * can have made anywhere in it adds up to less than maxErrorDb, which while a
+ * root is dragged leaves all but the tiles near it as they are. Any other
+ * change of the roots evaluates every tile again, and a change of the gain
+ * only colours them again.
+ */
+class TransferFunctionMap
+{
+public:
+    struct Tile
+    {
+        /** the tile spans world x from column to column + 1 and world y from
+         * -row down to -(row + 1), in tiles */
+        int column = 0, row = 0;
+        /** ln|H| without the gain at the pixel centres, row by row from the top */
+        std::vector<float> logMagnitudes;
+        /** the most ln|H| may have changed anywhere in the tile since it was evaluated */
+        double errorBound = 0.0;
+        juce::Image image;
+        bool isColoured = false;
+    };
+
+    /** Brings the tiles over the visible rectangle of the world, left to
+     * right and bottom to top, up to date with the roots and the gain, and
+     * colours them. Tiles are evaluated by the pool's workers if given. */
+    void update(
+        const RootSnapshot& snapshot,
+        double gain,
+        double unitsPerPixel,
+        double left,
+        double right,
+        double bottom,
+        double top,
+        WorkerPool* pool = nullptr);
+
+    /** the tiles update brought up to date, in no particular order */
+    const std::vector<const Tile*>& getVisibleTiles() const { return visibleTiles; }
+    /** world units per tile side at the current zoom */
+    double getTileUnits() const { return tileSize * unitsPerPixel; }
+
+    /** tiles evaluated and tiles only moved roots were accounted for, since the start */
+    u32 getEvaluatedTiles() const { return evaluatedTiles; }
+    u32 getKeptTiles() const { return keptTiles; }
+
+    /** ln|H| without the gain at size x size points step apart, the first at
+     * (left, top), row by row downwards. Each root's factor goes into a
+     * running product, for a conjugate pair both, and the products are taken
+     * the log of every factorsPerLog factors, so the inner loops are plain
+     * arithmetic over a row that vectorises. A point on a zero is -inf, on a
+     * pole +inf. */
+    static void evaluateTile(
+        const RootSnapshot& snapshot,
+        double left,
+        double top,
+        double step,
+        int size,
+        float* logMagnitudes);
+
+    /** The most ln|z - root| can change for z anywhere in the rectangle when
+     * the root moves from one point to another: the distance moved over the
+     * distance from the rectangle to the box around the two points. Infinite
+     * if they overlap. */
+    static double moveBound(
+        double left,
+        double right,
+        double bottom,
+        double top,
+        c128 from,
+        c128 to);
+
+    static constexpr int tileSize = 64;
+    /** about two steps of the colour map over its 2 * rangeDb */
+    static constexpr double maxErrorDb = 1.0;
+    /** the colours span +-rangeDb around 0 dB, zeros' side blue, poles' side orange */
+    static constexpr double rangeDb = 60.0;
+
+private:
+    using TileKey = u64;
+    static TileKey keyOf(int column, int row);
+
+    void evaluate(const std::vector<Tile*>& tiles, WorkerPool* pool);
+    void colour(Tile& tile);
+    /** adds the change from mapped to snapshot's root positions to every tile's
+     * errorBound, false if more than the positions changed */
+    bool accountForMoves(const RootSnapshot& snapshot);
+    static bool isSameRootSet(const RootSnapshot::Roots& a, const RootSnapshot::Roots& b);
+
+    std::unordered_map<TileKey, Tile> tiles;
+    std::vector<const Tile*> visibleTiles;
+    RootSnapshot mapped;
+    double mappedGain = 1.0;
+    double unitsPerPixel = 0.0;
+    bool hasMapped = false;
+    std::array<juce::PixelARGB, 256> colourMap;
+    bool hasColourMap = false;
+    u32 evaluatedTiles = 0, keptTiles = 0;
+
+    /** squared distances multiplied between two logs, a conjugate pair's
+     * factor counting as two: distance^16 stays within a double for any
+     * distance from 1e-19 to 1e19 */
+    static constexpr int factorsPerLog = 8;
+    /** tiles kept beyond those in view, before all that are out of view are dropped */
+    static constexpr size_t maxSpareTiles = 256;
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* indent-tabs-mode: t */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,68 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int numWorkersToUse)
+    : numWorkers(numWorkersToUse > 0 ? numWorkersToUse : juce::SystemStats::getNumCpus())
+{
+    // NOTE: the calling thread is worker 0, a single worker needs no threads of its own
+    if (numWorkers > 1)
+        pool = std::make_unique<juce::ThreadPool>(numWorkers - 1);
+}
+
+class WorkerPool::Job final : public juce::ThreadPoolJob
+{
+public:
+    explicit Job(std::function<void()> workToDo)
+        : juce::ThreadPoolJob("WorkerPool"), work(std::move(workToDo))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        work();
+        return jobHasFinished;
+    }
+
+private:
+    const std::function<void()> work;
+};
+
+void WorkerPool::parallelFor(size_t numItems, const std::function<void(size_t item, int worker)>& body, int maxWorkers)
+{
+    const int allowed = maxWorkers > 0 ? std::min(maxWorkers, numWorkers) : numWorkers;
+    const int workers = (int)std::min((size_t)allowed, numItems);
+
+    std::atomic<size_t> next{ 0 };
+    const auto work = [&](int worker)
+    {
+        for (size_t item = next++; item < numItems; item = next++)
+            body(item, worker);
+    };
+
+    if (workers <= 1)
+    {
+        work(0);
+        return;
+    }
+
+    std::vector<std::unique_ptr<Job>> jobs;
+    for (int worker = 1; worker < workers; worker++)
+    {
+        jobs.push_back(std::make_unique<Job>([&, worker] { work(worker); }));
+        pool->addJobToPool(jobs.back().get(), false);
+    }
+
+    // NOTE: once work(0) returns every item has been taken, so the jobs still
+    // queued, e.g. behind another caller's, are taken back rather than waited for;
+    // only those already running an item are
+    work(0);
+    for (auto& job : jobs)
+        pool->removeJob(job.get(), false, -1);
+}
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
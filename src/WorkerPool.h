@@ -0,0 +1,51 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <functional>
+
+/** A fixed set of threads for loops over independent items, e.g. factoring a
+ * whole library of polynomials.
+ * Items are handed out one at a time, so uneven items balance out. The body is
+ * told which worker runs it, so callers can keep scratch memory per worker
+ * instead of per item and never lock it.
+ * The calling thread works through the items as well, as worker 0, and
+ * parallelFor() only returns once every item is done.
+ * Several threads may call parallelFor() at once, e.g. on a pool shared through
+ * a juce::SharedResourcePointer; their items share the threads, and the worker
+ * numbers are only unique within one call. A call never waits for another's
+ * items: what its own threads haven't started by the time the caller runs out
+ * of items is taken back, so a caller on the message thread is at worst as slow
+ * as doing the loop alone.
+ * A body may call parallelFor() on the same pool: the inner call waits only for
+ * jobs already running its items, never for a thread to come free, so nesting
+ * can't deadlock even with every thread inside a body.
+ */
+class WorkerPool final
+{
+public:
+    /** numWorkersToUse counts the calling thread, 0 means one per core */
+    explicit WorkerPool(int numWorkersToUse = 0);
+
+    int getNumWorkers() const { return numWorkers; }
+
+    /** Calls body(item, worker) for every item in [0, numItems), with worker in
+     * [0, getNumWorkers()). At most maxWorkers take part, 0 meaning all of them.
+     * The body must not throw.
+     */
+    void parallelFor(size_t numItems, const std::function<void(size_t item, int worker)>& body, int maxWorkers = 0);
+
+private:
+    class Job;
+
+    const int numWorkers;
+    std::unique_ptr<juce::ThreadPool> pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WorkerPool)
+};
+
+// NOTE(ry): I need to put this here so my editor doesn't screw with the style of this file
+/* Local Variables: */
+/* mode: c++ */
+/* tab-width: 4 */
+/* c-basic-offset: 4 */
+/* buffer-file-coding-system: undecided-unix */
+/* End: */
@@ -0,0 +1,189 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "CoefficientsToRootsDistanceTest.h"
+#include "../src/PluginProcessor.h"
+#include "../src/CoefficientsToRoots.h"
+#include "../src/RootsToCoefficients.h"
+
+class AberthTest : public juce::UnitTest
+{
+public:
+    AberthTest() : UnitTest("AberthTest", "Math")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        auto* state = processor.filterState.get();
+
+        beginTest("Clustered roots come out with their orders");
+        {
+            std::vector<TestRootSpecification> given{ { -5, -0.5, 0 }, { -3, 0.3, 0 }, { -2, 0.5, 0.5 } };
+            TestHelper::makeFilterState(state, given, 1);
+            const auto roots = CoefficientsToRoots::Aberth(RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->poles));
+
+            expectEquals((int)roots.size(), (int)given.size());
+            for (auto& g : given)
+            {
+                bool isFound = false;
+                for (auto& [value, order] : roots)
+                    isFound = isFound || (order == -g.order && std::abs(value - c128(g.valRe, g.valIm)) < 1e-6);
+                expect(isFound, "root " + juce::String(g.valRe) + " " + juce::String(g.valIm) + " of order " + juce::String(-g.order));
+            }
+        }
+
+        beginTest("Agrees with QR on the distance cases");
+        for (auto& testCase : CoefficientsToRootsDistanceTest::getCases())
+        {
+            TestHelper::makeFilterState(state, testCase.roots, 1);
+            auto& given = state->zeros.isEmpty() ? state->poles : state->zeros;
+            const auto coeffs = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(given);
+            const auto aberth = CoefficientsToRoots::Aberth(coeffs);
+            const auto qr = CoefficientsToRoots::QR(coeffs);
+
+            expectEquals((int)aberth.size(), (int)qr.size(), testCase.name);
+            expectEquals(totalOrder(aberth), totalOrder(qr), testCase.name);
+            for (auto& [value, order] : aberth)
+            {
+                bool isFound = false;
+                for (auto& [other, otherOrder] : qr)
+                    isFound = isFound || (order == otherOrder && std::abs(value - other) < 1e-6);
+                expect(isFound, testCase.name);
+            }
+        }
+
+        beginTest("Refine from the roots before a coefficient edit");
+        {
+            std::vector<TestRootSpecification> given{ { -4, -0.5, 0 }, { -3, 0.3, 0 }, { -1, 0.2, 0.3 }, { -1, 0.1, 0 } };
+            TestHelper::makeFilterState(state, given, 1);
+            std::vector<std::pair<c128, int>> guesses;
+            for (auto* pole : state->poles)
+                guesses.emplace_back(pole->value.get(), -pole->order.get());
+            const auto coeffs = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->poles);
+
+            for (size_t i = 1; i < coeffs.size(); i++)
+            {
+                auto edited = coeffs;
+                edited[i] += 0.01;
+                const auto refined = CoefficientsToRoots::refine(edited, guesses);
+                const auto solved = CoefficientsToRoots::solve(edited);
+
+                const juce::String name = "coefficient " + juce::String((int)i);
+                expectEquals(totalOrder(refined), (int)coeffs.size() - 1, name);
+                expectEquals((int)refined.size(), (int)solved.size(), name);
+                for (auto& [value, order] : refined)
+                {
+                    bool isFound = false;
+                    for (auto& [other, otherOrder] : solved)
+                        isFound = isFound || (order == otherOrder && std::abs(value - other) < 1e-9);
+                    expect(isFound, name);
+                }
+            }
+        }
+
+        beginTest("An edited leading coefficient divides the rest");
+        {
+            std::vector<TestRootSpecification> given{ { -2, -0.5, 0 }, { -1, 0.3, 0.4 }, { -1, 0.6, 0 } };
+            TestHelper::makeFilterState(state, given, 1);
+            std::vector<std::pair<c128, int>> guesses;
+            for (auto* pole : state->poles)
+                guesses.emplace_back(pole->value.get(), -pole->order.get());
+            const auto coeffs = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->poles);
+
+            auto scaled = coeffs;
+            for (auto& c : scaled)
+                c *= -2.5;
+            expect(isSameRoots(CoefficientsToRoots::solve(scaled), CoefficientsToRoots::solve(coeffs)), "solve");
+            expect(isSameRoots(CoefficientsToRoots::QR(scaled), CoefficientsToRoots::QR(coeffs)), "QR");
+            expect(isSameRoots(CoefficientsToRoots::Aberth(scaled), CoefficientsToRoots::Aberth(coeffs)), "Aberth");
+
+            for (double lead : { 2.0, 0.5, -1.0, 0.0 })
+            {
+                auto edited = coeffs;
+                edited[0] = lead;
+                const auto refined = CoefficientsToRoots::refine(edited, guesses);
+                const auto solved = CoefficientsToRoots::solve(edited);
+
+                const juce::String name = "leading coefficient " + juce::String(lead);
+                expectEquals(totalOrder(refined), (int)coeffs.size() - (lead == 0.0 ? 2 : 1), name);
+                expect(isSameRoots(refined, solved), name);
+            }
+
+            const auto root = CoefficientsToRoots::refine({ 2.0, -1.0 }, { { c128(0.3, 0.0), 1 } });
+            expect(root.size() == 1 && std::abs(root[0].first - c128(0.5, 0.0)) < 1e-12 && root[0].second == 1);
+
+            // nothing left to solve
+            for (const std::vector<double>& empty : { std::vector<double>{}, std::vector<double>{ 0.0 }, std::vector<double>{ 0.0, 0.0, 0.0 } })
+            {
+                expect(CoefficientsToRoots::refine(empty, guesses).empty());
+                expect(CoefficientsToRoots::solve(empty).empty());
+                expect(CoefficientsToRoots::QR(empty).empty());
+                expect(CoefficientsToRoots::Aberth(empty).empty());
+            }
+        }
+
+        beginTest("Long FIR design");
+        {
+            // Hamming windowed sinc lowpass; its zeros are all the way round the unit circle and in
+            // reciprocal pairs in the passband
+            constexpr int length = 513;
+            std::vector<double> coeffs(length);
+            for (int i = 0; i < length; i++)
+            {
+                const double m = i - (length - 1) / 2.0;
+                const double sinc = m == 0 ? 0.3 : std::sin(juce::MathConstants<double>::pi * 0.3 * m) / (juce::MathConstants<double>::pi * m);
+                coeffs[(size_t)i] = sinc * (0.54 - 0.46 * std::cos(juce::MathConstants<double>::twoPi * i / (length - 1)));
+            }
+            const double first = coeffs[0];
+            for (auto& c : coeffs)
+                c /= first;
+
+            const auto roots = CoefficientsToRoots::solve(coeffs);
+            expectEquals(totalOrder(roots), length - 1);
+            for (auto& [value, order] : roots)
+                expectLessThan(relativeResidual(coeffs, value), 1e-12);
+        }
+    }
+
+private:
+    static int totalOrder(const std::vector<std::pair<c128, int>>& roots)
+    {
+        int total = 0;
+        for (auto& [value, order] : roots)
+            total += juce::exactlyEqual(value.imag(), 0.0) ? order : 2 * order;
+        return total;
+    }
+
+    static bool isSameRoots(const std::vector<std::pair<c128, int>>& a, const std::vector<std::pair<c128, int>>& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (auto& [value, order] : a)
+        {
+            bool isFound = false;
+            for (auto& [other, otherOrder] : b)
+                isFound = isFound || (order == otherOrder && std::abs(value - other) < 1e-9);
+            if (!isFound)
+                return false;
+        }
+        return true;
+    }
+
+    // |p(z)| over the bound on its rounding error, sum |a_k| |z|^k
+    static double relativeResidual(const std::vector<double>& coeffs, c128 z)
+    {
+        c128 p(0.0, 0.0);
+        double bound = 0.0;
+        for (double c : coeffs)
+        {
+            p = p * z + c;
+            bound = bound * std::abs(z) + std::abs(c);
+        }
+        return std::abs(p) / bound;
+    }
+};
+
+static AberthTest aberthTest;
@@ -0,0 +1,58 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../src/AnalysisTap.h"
+
+class AnalysisTapBenchmark : public juce::UnitTest
+{
+public:
+    AnalysisTapBenchmark() : UnitTest("AnalysisTapBenchmark", "Benchmark")
+    { }
+
+    void runTest() override
+    {
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::Random random(1234);
+        for (int ch = 0; ch < numChannels; ch++)
+            for (int i = 0; i < blockSize; i++)
+                buffer.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+
+        AnalysisTap tap;
+        tap.prepare(sampleRate, blockSize);
+
+        beginTest("Inactive tap");
+        const double inactiveNs = measure(tap, buffer);
+        logMessage("per block: " + juce::String(inactiveNs, 1) + " ns");
+
+        beginTest("Active tap");
+        tap.startAnalysis();
+        const double activeNs = measure(tap, buffer);
+        tap.stopAnalysis();
+
+        const double blockNs = 1e9 * blockSize / sampleRate;
+        logMessage("per block: " + juce::String(activeNs, 1) + " ns ("
+            + juce::String(100.0 * activeNs / blockNs, 4) + "% of the block's real-time budget), "
+            + juce::String((int)tap.getDroppedBlocks()) + " blocks dropped while the analyser caught up");
+        expect(activeNs < blockNs, "the tap must be cheaper than real time");
+    }
+
+private:
+    static constexpr int numChannels = 2;
+    static constexpr int blockSize = 512;
+    static constexpr int numBlocks = 20000;
+    static constexpr double sampleRate = 48000;
+
+    double measure(AnalysisTap& tap, juce::AudioBuffer<float>& buffer)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < numBlocks; i++)
+        {
+            tap.captureInput(buffer, numChannels);
+            tap.pushOutput(buffer, numChannels);
+        }
+        const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+        return 1e9 * juce::Time::highResolutionTicksToSeconds(elapsed) / numBlocks;
+    }
+};
+
+static AnalysisTapBenchmark analysisTapBenchmark;
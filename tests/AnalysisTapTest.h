@@ -0,0 +1,182 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../src/AnalysisTap.h"
+
+class AnalysisTapTest : public juce::UnitTest
+{
+public:
+    AnalysisTapTest() : UnitTest("AnalysisTapTest", "Audio")
+    { }
+
+    void runTest() override
+    {
+        beginTest("A sine reads its level at its bin");
+        {
+            for (auto [order, overlap] : { std::pair{ 10, 4 }, std::pair{ 12, 1 }, std::pair{ 11, 8 } })
+            {
+                const int fftSize = 1 << order;
+                AnalysisTap tap;
+                tap.prepare(sampleRate, blockSize);
+                tap.setFftOrder(order);
+                tap.setOverlap(overlap);
+                tap.startAnalysis();
+
+                // on a bin, so the Hann window leaks into the two next to it only
+                Sine sine{ 0.5f, 2.0 * pi * sineBin / fftSize };
+                feed(tap, sine, fftSize + settlingHops * fftSize / overlap);
+                const auto spectrum = waitForSpectrum(tap);
+                tap.stopAnalysis();
+
+                const juce::String name = "order " + juce::String(order) + ", overlap " + juce::String(overlap);
+                expectEquals((int)tap.getDroppedBlocks(), 0, name);
+                expectEquals((int)spectrum.magnitudesDb.size(), fftSize / 2 + 1, name);
+                expectWithinAbsoluteError(spectrum.binWidthHz, sampleRate / fftSize, 1e-9, name);
+                expectEquals(loudestBin(spectrum.magnitudesDb), sineBin, name);
+                expectWithinAbsoluteError(spectrum.magnitudesDb[sineBin], juce::Decibels::gainToDecibels(0.5f), 0.05f, name);
+                expect(loudestOutside(spectrum.magnitudesDb, sineBin - 1, sineBin + 1) < -80.0f, name);
+            }
+        }
+
+        beginTest("RMS and peak of known signals");
+        {
+            AnalysisTap tap;
+            tap.prepare(sampleRate, blockSize);
+            tap.startAnalysis();
+
+            // input: a square wave of +-0.25 at Nyquist; output: a sine whose
+            // period divides the block, sampled at its crests
+            juce::AudioBuffer<float> input(2, blockSize), output(2, blockSize);
+            for (int i = 0; i < blockSize; i++)
+                for (int ch = 0; ch < 2; ch++)
+                {
+                    input.setSample(ch, i, i % 2 == 0 ? 0.25f : -0.25f);
+                    output.setSample(ch, i, 0.8f * (float)std::sin(2.0 * pi * i / 64));
+                }
+            for (int block = 0; block < 64; block++)
+                push(tap, input, output);
+            waitForSpectrum(tap);
+            tap.stopAnalysis();
+
+            const auto inputLevels = tap.getInputLevels();
+            const auto outputLevels = tap.getOutputLevels();
+            expectWithinAbsoluteError(inputLevels.rms, 0.25f, 1e-6f);
+            expectWithinAbsoluteError(inputLevels.peak, 0.25f, 1e-6f);
+            expectWithinAbsoluteError(outputLevels.rms, 0.8f / std::sqrt(2.0f), 1e-5f);
+            expectWithinAbsoluteError(outputLevels.peak, 0.8f, 1e-6f);
+        }
+
+        beginTest("A block the ring has no room for is dropped whole");
+        {
+            constexpr int order = 11, overlap = 4, fftSize = 1 << order;
+            AnalysisTap tap;
+            // room for a block larger than the ring
+            tap.prepare(sampleRate, hugeBlockSize);
+            tap.setFftOrder(order);
+            tap.setOverlap(overlap);
+            tap.startAnalysis();
+
+            Sine sine{ 0.5f, 2.0 * pi * sineBin / fftSize };
+            feed(tap, sine, fftSize + settlingHops * fftSize / overlap);
+
+            // full scale noise, if any of it got into the ring it would show
+            // across the whole spectrum for the next frames
+            juce::AudioBuffer<float> noise(2, hugeBlockSize);
+            auto random = getRandom();
+            for (int ch = 0; ch < 2; ch++)
+                for (int i = 0; i < hugeBlockSize; i++)
+                    noise.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+            push(tap, noise, noise);
+            expectEquals((int)tap.getDroppedBlocks(), 1);
+
+            // a few frames, the sine carrying on as if the block was never there
+            feed(tap, sine, 4 * fftSize / overlap);
+            const auto spectrum = waitForSpectrum(tap);
+            tap.stopAnalysis();
+
+            expectEquals((int)tap.getDroppedBlocks(), 1);
+            expectWithinAbsoluteError(spectrum.magnitudesDb[sineBin], juce::Decibels::gainToDecibels(0.5f), 0.05f);
+            expect(loudestOutside(spectrum.magnitudesDb, sineBin - 1, sineBin + 1) < -80.0f);
+        }
+    }
+
+private:
+    static constexpr double pi = juce::MathConstants<double>::pi;
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int hugeBlockSize = 70000;
+    static constexpr int sineBin = 37;
+    /** frames after the first full window, enough for the smoothing to forget the start */
+    static constexpr int settlingHops = 80;
+
+    struct Sine
+    {
+        float amplitude;
+        double phaseIncrement;
+        double phase = 0.0;
+    };
+
+    struct Spectrum
+    {
+        std::vector<float> magnitudesDb;
+        double binWidthHz = 0.0;
+    };
+
+    static void push(AnalysisTap& tap, const juce::AudioBuffer<float>& input, const juce::AudioBuffer<float>& output)
+    {
+        tap.captureInput(input, input.getNumChannels());
+        tap.pushOutput(output, output.getNumChannels());
+    }
+
+    /** Plays numSamples of the sine through the tap, unprocessed, pausing
+     * now and then so the analyser keeps up and nothing is dropped. */
+    static void feed(AnalysisTap& tap, Sine& sine, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int block = 0; block * blockSize < numSamples; block++)
+        {
+            for (int i = 0; i < blockSize; i++)
+            {
+                const float value = sine.amplitude * (float)std::sin(sine.phase);
+                sine.phase = std::fmod(sine.phase + sine.phaseIncrement, 2.0 * pi);
+                buffer.setSample(0, i, value);
+                buffer.setSample(1, i, value);
+            }
+            push(tap, buffer, buffer);
+
+            if (block % 32 == 31)
+                juce::Thread::sleep(20);
+        }
+    }
+
+    /** the spectrum once the analyser has caught up with what was pushed */
+    static Spectrum waitForSpectrum(AnalysisTap& tap)
+    {
+        Spectrum latest, previous;
+        for (int attempt = 0; attempt < 100; attempt++)
+        {
+            juce::Thread::sleep(50);
+            const bool isAvailable = tap.getOutputSpectrum(latest.magnitudesDb, latest.binWidthHz);
+            if (isAvailable && latest.magnitudesDb == previous.magnitudesDb)
+                break;
+            previous = latest;
+        }
+        return latest;
+    }
+
+    static int loudestBin(const std::vector<float>& magnitudesDb)
+    {
+        return (int)std::distance(magnitudesDb.begin(), std::max_element(magnitudesDb.begin(), magnitudesDb.end()));
+    }
+
+    static float loudestOutside(const std::vector<float>& magnitudesDb, int first, int last)
+    {
+        float loudest = -std::numeric_limits<float>::infinity();
+        for (int k = 0; k < (int)magnitudesDb.size(); k++)
+            if (k < first || k > last)
+                loudest = std::max(loudest, magnitudesDb[(size_t)k]);
+        return loudest;
+    }
+};
+
+static AnalysisTapTest analysisTapTest;
@@ -0,0 +1,93 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "../src/CoefficientsToRoots.h"
+#include "../src/WorkerPool.h"
+
+class CoefficientsToRootsBatchTest : public juce::UnitTest
+{
+public:
+    CoefficientsToRootsBatchTest() : UnitTest("CoefficientsToRootsBatchTest", "Math")
+    { }
+
+    void runTest() override
+    {
+        // random real and complex roots of mixed degrees, padded to the same length,
+        // scaled so they aren't monic; the last one is all zeros
+        constexpr size_t count = 200;
+        constexpr size_t length = 41;
+        juce::Random random(7);
+        std::vector<double> coeffs(count * length, 0.0);
+        for (size_t p = 0; p + 1 < count; p++)
+        {
+            const auto degree = (size_t)random.nextInt({ 1, (int)length });
+            std::vector<double> poly{ 1.0 };
+            while (poly.size() <= degree)
+            {
+                const auto root = std::polar(0.1 + 0.85 * random.nextDouble(), 3.1 * random.nextDouble());
+                if (poly.size() + 2 <= degree + 1 && random.nextBool())
+                    poly = multiply(poly, { 1.0, -2.0 * root.real(), std::norm(root) });
+                else
+                    poly = multiply(poly, { 1.0, -root.real() });
+            }
+            const double scale = 0.5 + 4.0 * random.nextDouble();
+            for (size_t k = 0; k < poly.size(); k++)
+                coeffs[p * length + length - poly.size() + k] = scale * poly[k];
+        }
+
+        WorkerPool pool(4);
+
+        beginTest("Same roots as solving one by one");
+        const auto batch = CoefficientsToRoots::solveBatch(coeffs.data(), count, length, pool);
+        expectEquals((int)batch.size(), (int)count);
+        for (size_t p = 0; p < count; p++)
+        {
+            std::vector<double> monic;
+            for (size_t k = 0; k < length; k++)
+                if (!monic.empty() || coeffs[p * length + k] != 0.0)
+                    monic.push_back(coeffs[p * length + k]);
+            if (monic.empty())
+            {
+                expect(batch[p].empty(), "all-zero polynomial");
+                continue;
+            }
+            const double lead = monic[0];
+            for (auto& c : monic)
+                c /= lead;
+            monic[0] = 1.0;
+
+            expect(batch[p] == CoefficientsToRoots::solve(monic), "polynomial " + juce::String((int)p));
+        }
+
+        beginTest("Output doesn't depend on the number of workers");
+        for (int workers : { 1, 2, 3 })
+            expect(CoefficientsToRoots::solveBatch(coeffs.data(), count, length, pool, workers) == batch, juce::String(workers) + " workers");
+
+        beginTest("A pool of one worker is the calling thread alone");
+        {
+            WorkerPool single(1);
+            expect(CoefficientsToRoots::solveBatch(coeffs.data(), count, length, single) == batch);
+        }
+
+        beginTest("A body may use the pool it runs on");
+        {
+            std::atomic<int> items{ 0 };
+            pool.parallelFor(8, [&](size_t, int)
+            {
+                pool.parallelFor(8, [&](size_t, int) { items++; });
+            });
+            expectEquals(items.load(), 64);
+        }
+    }
+
+private:
+    static std::vector<double> multiply(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        std::vector<double> product(a.size() + b.size() - 1, 0.0);
+        for (size_t i = 0; i < a.size(); i++)
+            for (size_t j = 0; j < b.size(); j++)
+                product[i + j] += a[i] * b[j];
+        return product;
+    }
+};
+
+static CoefficientsToRootsBatchTest coefficientsToRootsBatchTest;
@@ -0,0 +1,225 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "CoefficientsToRootsDistanceTest.h"
+#include "../src/PluginProcessor.h"
+#include "../src/CoefficientsToRoots.h"
+#include "../src/RootsToCoefficients.h"
+#include "../src/WorkerPool.h"
+#include "../src/CoeffComponents.h"
+
+class CoefficientsToRootsBenchmark : public juce::UnitTest
+{
+public:
+    CoefficientsToRootsBenchmark() : UnitTest("CoefficientsToRootsBenchmark", "Benchmark")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        auto* state = processor.filterState.get();
+
+        beginTest("Distance test cases");
+        Result francisTotal, aberthTotal, gramSchmidtTotal;
+        for (auto& testCase : CoefficientsToRootsDistanceTest::getCases())
+        {
+            TestHelper::makeFilterState(state, testCase.roots, 1);
+            auto& roots = state->zeros.isEmpty() ? state->poles : state->zeros;
+            const auto coeffs = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(roots);
+            const c128 expected = roots[0]->value.get();
+
+            const auto francis = measure(coeffs, expected, [](const std::vector<double>& c) { return CoefficientsToRoots::QR(c); });
+            const auto aberth = measure(coeffs, expected, [](const std::vector<double>& c) { return CoefficientsToRoots::Aberth(c); });
+            const auto gramSchmidt = measure(coeffs, expected, CoefficientsToRoots::QRGramSchmidt);
+            logMessage(testCase.name + ": Francis " + format(francis) + ", Aberth " + format(aberth) + ", Gram-Schmidt " + format(gramSchmidt));
+
+            francisTotal += francis;
+            aberthTotal += aberth;
+            gramSchmidtTotal += gramSchmidt;
+        }
+        logMessage("total: Francis " + format(francisTotal) + ", Aberth " + format(aberthTotal) + ", Gram-Schmidt " + format(gramSchmidtTotal));
+
+        // distinct roots scattered over the disc, the distance is to the nearest given root
+        juce::Random random(3);
+        for (int degree : { 32, 64, 128, 256, 512 })
+        {
+            beginTest("Degree " + juce::String(degree));
+            std::vector<c128> given;
+            std::vector<double> coeffs{ 1.0 };
+            for (int i = 0; i < degree / 2; i++)
+            {
+                const auto root = std::polar(0.3 + 0.69 * random.nextDouble(), 0.05 + 3.0 * random.nextDouble());
+                given.push_back(root);
+                // multiply by z^2 - 2 Re(root) z + |root|^2
+                coeffs.push_back(0.0);
+                coeffs.push_back(0.0);
+                for (size_t k = coeffs.size() - 1; k >= 2; k--)
+                    coeffs[k] += -2.0 * root.real() * coeffs[k - 1] + std::norm(root) * coeffs[k - 2];
+                coeffs[1] += -2.0 * root.real() * coeffs[0];
+            }
+
+            juce::String message = "Aberth " + format(measure(coeffs, given, [](const std::vector<double>& c) { return CoefficientsToRoots::Aberth(c); }));
+            if (degree <= maxFrancisDegree)
+                message << ", Francis " + format(measure(coeffs, given, [](const std::vector<double>& c) { return CoefficientsToRoots::QR(c); }));
+            if (degree <= maxGramSchmidtDegree)
+                message << ", Gram-Schmidt " + format(measure(coeffs, given, CoefficientsToRoots::QRGramSchmidt));
+            logMessage(message);
+        }
+
+        // long FIR designs, only Aberth gets through these; without given roots the count is what's checked
+        for (int length : { 257, 513, 1025, 2049 })
+        {
+            beginTest("FIR length " + juce::String(length));
+            const auto coeffs = firDesign(length);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            const auto roots = CoefficientsToRoots::Aberth(coeffs);
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+            logMessage("Aberth " + juce::String(1e3 * juce::Time::highResolutionTicksToSeconds(elapsed), 4) + " ms, " + juce::String((int)roots.size()) + " roots");
+
+            // one coefficient edited, as in the table, solved again starting from the roots before the edit
+            auto edited = coeffs;
+            edited[(size_t)length / 2] *= 1.01;
+            const auto refineStart = juce::Time::getHighResolutionTicks();
+            const auto refined = CoefficientsToRoots::refine(edited, roots);
+            const auto refineElapsed = juce::Time::getHighResolutionTicks() - refineStart;
+            logMessage("refine after an edit " + juce::String(1e3 * juce::Time::highResolutionTicksToSeconds(refineElapsed), 4) + " ms, " + juce::String((int)refined.size()) + " roots");
+        }
+
+        // the same edit through the table, as a cell edit costs: the roots, then the filter state and everything
+        // listening to it, then the table once the roots have all moved
+        for (int length : { 257, 1025 })
+        {
+            beginTest("Table edit, FIR length " + juce::String(length));
+            const auto coeffs = firDesign(length);
+            state->clear();
+            for (auto& [value, order] : CoefficientsToRoots::Aberth(coeffs))
+                state->add(order, value);
+            CoefficientsComponent table(&processor);
+
+            const int row = length / 2;
+            double total = 0.0;
+            u64 changes = 0;
+            for (int i = 0; i < repeats; i++)
+            {
+                const auto revision = state->revision;
+                const auto start = juce::Time::getHighResolutionTicks();
+                table.updateFilterStateOnCoefEdit(row, 2, coeffs[(size_t)row] * (i % 2 == 0 ? 1.01 : 1.0));
+                total += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                changes += state->revision - revision;
+            }
+            logMessage("edit " + juce::String(1e3 * total / repeats, 4) + " ms, " + juce::String((double)changes / repeats, 1)
+                + " state changes, " + juce::String(state->zeros.size()) + " zeros");
+            state->clear();
+        }
+
+        // a library of filters: many short polynomials, then fewer long ones, from 1 worker to all cores
+        WorkerPool pool;
+        for (auto [count, degree] : { std::pair<size_t, size_t>{ 20000, 12 }, { 200, 256 } })
+        {
+            beginTest("Batch of " + juce::String((int)count) + " at degree " + juce::String((int)degree));
+            const size_t length = degree + 1;
+            std::vector<double> coeffs(count * length);
+            for (size_t p = 0; p < count; p++)
+            {
+                // roots inside the unit disc keep every polynomial well conditioned enough to solve
+                std::vector<double> poly{ 1.0 };
+                for (size_t i = 0; i < degree / 2; i++)
+                {
+                    const auto root = std::polar(0.3 + 0.69 * random.nextDouble(), 0.05 + 3.0 * random.nextDouble());
+                    poly.push_back(0.0);
+                    poly.push_back(0.0);
+                    for (size_t k = poly.size() - 1; k >= 2; k--)
+                        poly[k] += -2.0 * root.real() * poly[k - 1] + std::norm(root) * poly[k - 2];
+                    poly[1] += -2.0 * root.real() * poly[0];
+                }
+                std::copy(poly.begin(), poly.end(), coeffs.begin() + (std::ptrdiff_t)(p * length));
+            }
+
+            std::vector<int> workerCounts;
+            for (int workers = 1; workers < pool.getNumWorkers(); workers *= 2)
+                workerCounts.push_back(workers);
+            workerCounts.push_back(pool.getNumWorkers());
+
+            double single = 0.0;
+            for (int workers : workerCounts)
+            {
+                const auto start = juce::Time::getHighResolutionTicks();
+                CoefficientsToRoots::solveBatch(coeffs.data(), count, length, pool, workers);
+                const double ms = 1e3 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                if (workers == 1)
+                    single = ms;
+                logMessage(juce::String(workers) + " workers: " + juce::String(ms, 2) + " ms, speedup " + juce::String(single / ms, 2));
+            }
+        }
+    }
+
+private:
+    struct Result
+    {
+        double milliseconds = 0;
+        double meanDistance = 0;
+
+        Result& operator+=(const Result& other)
+        {
+            milliseconds += other.milliseconds;
+            meanDistance += other.meanDistance;
+            return *this;
+        }
+    };
+
+    static constexpr int repeats = 10;
+    static constexpr int maxFrancisDegree = 512;
+    static constexpr int maxGramSchmidtDegree = 128;   // it takes seconds beyond that
+
+    // Hamming windowed sinc lowpass, divided by its first coefficient
+    static std::vector<double> firDesign(int length)
+    {
+        std::vector<double> coeffs(static_cast<size_t>(length));
+        for (int i = 0; i < length; i++)
+        {
+            const double m = i - (length - 1) / 2.0;
+            const double sinc = m == 0 ? 0.3 : std::sin(juce::MathConstants<double>::pi * 0.3 * m) / (juce::MathConstants<double>::pi * m);
+            coeffs[(size_t)i] = sinc * (0.54 - 0.46 * std::cos(juce::MathConstants<double>::twoPi * i / (length - 1)));
+        }
+        const double first = coeffs[0];
+        for (auto& c : coeffs)
+            c /= first;
+        return coeffs;
+    }
+
+    template <typename Solver>
+    static Result measure(const std::vector<double>& coeffs, const std::vector<c128>& given, Solver solve)
+    {
+        std::vector<std::pair<c128, int>> roots;
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < repeats; i++)
+            roots = solve(coeffs);
+        const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+        double totalDistance = 0;
+        for (auto& root : roots)
+        {
+            double nearest = std::numeric_limits<double>::max();
+            for (auto& g : given)
+                nearest = std::min({ nearest, std::abs(root.first - g), std::abs(root.first - std::conj(g)) });
+            totalDistance += nearest;
+        }
+        return { 1e3 * juce::Time::highResolutionTicksToSeconds(elapsed) / repeats, totalDistance / (double)std::max<size_t>(1, roots.size()) };
+    }
+
+    template <typename Solver>
+    static Result measure(const std::vector<double>& coeffs, c128 given, Solver solve)
+    {
+        return measure(coeffs, std::vector<c128>{ given }, solve);
+    }
+
+    static juce::String format(const Result& result)
+    {
+        return juce::String(result.milliseconds, 4) + " ms, mean distance " + juce::String(result.meanDistance, 6);
+    }
+};
+
+static CoefficientsToRootsBenchmark coefficientsToRootsBenchmark;
@@ -18,70 +18,86 @@ public:
     void runTest() override
     {
 		AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
-		// poles
-		performTest("{distance} 1:1 real pole order 1 a", 							processor, { {-1, -0.5, 0} } );
-		performTest("{distance} 1:1 real pole order 1 b", 							processor, { {-1, 0.5, 0} } );
-		performTest("{distance} 1:1 real pole order 1 c", 							processor, { {-1, -0.1, 0} } );
-		performTest("{distance} 1:1 real pole order 1 d", 							processor, { {-1, 0.9, 0} } );
-		performTest("{distance} 2:1 real pole order 2", 							processor, { {-2, -0.5, 0} } );
-		performTest("{distance} 2:1 complex pole order 1 a", 						processor, { {-2, 0.3, 0.4} } );
-		performTest("{distance} 2:1 complex pole order 1 b",						processor, { {-2, 0.4, 0.5} } );
-		performTest("{distance} 2:1 complex pole order 1 c",						processor, { {-2, 0.6, 0.7} } );
-		performTest("{distance} 3:1 real pole order 3 a",							processor, { {-3, -0.5, 0} } );
-		performTest("{distance} 3:1 real pole order 3 b",							processor, { {-3, -0.9, 0} } );
-		performTest("{distance} 3:1 real pole order 3 c",							processor, { {-3, 0.9, 0} } );
-		performTest("{distance} 3:1 real pole order 3 d",							processor, { {-3, 0.1, 0} } );
-		performTest("{distance} 4:1 real pole order 4 a",							processor, { {-4,-0.9,0} } );
-		performTest("{distance} 4:1 real pole order 4 b",							processor, { {-4,-0.5,0} } );
-		performTest("{distance} 4:1 real pole order 4 c",							processor, { {-4,-0.1,0} } );
-		performTest("{distance} 5:1 real pole order 5 a",							processor, { {-5,-0.5,0} } );
-		performTest("{distance} 5:1 real pole order 5 b",							processor, { {-5,-0.1,0} } );
-		performTest("{distance} 5:1 real pole order 5 c",							processor, { {-5,-0.9,0} } );
-		performTest("{distance} 6:1 real pole order 6 a",							processor, { {-6,-0.01,0} } );
-		performTest("{distance} 6:1 real pole order 6 b",							processor, { {-6,-0.99,0} } );
-		performTest("{distance} 6:1 complex pole order 3",							processor, { {-3,0.99,0.4} } );
-		performTest("{distance} 6:1 complex pole order 3 b",						processor, { {-3,0.1,0.4} } );
-		performTest("{distance} 7:1 real pole order 7 a",							processor, { {-7,-0.9,0} } );
-		performTest("{distance} 7:1 real pole order 7 b",							processor, { {-7,-0.1,0} } );
-		performTest("{distance} 8:1 real pole order 8",								processor, { {-8,-0.5,0} } );
-		performTest("{distance} 9:1 real pole order 9",								processor, { {-9,-0.5,0} } );
-		performTest("{distance} 10:1 real pole order 10",							processor, { {-10,-0.5,0} } );
-		performTest("{distance} 14:1 real pole order 14",							processor, { {-14,-0.5,0} } );
-		performTest("{distance} 20:1 real pole order 20",							processor, { {-20,-0.5,0} } );
-		performTest("{distance} 28:1 real pole order 28",							processor, { {-28,-0.5,0} } );
-		performTest("{distance} 32:1 real pole order 32",							processor, { {-32,-0.5,0} } );
-		// zeroes
-		performTest("{distance} 1:1 real zero order 1", 							processor, { {1, -0.5, 0} } );
-		performTest("{distance} 1:1 real zero order 1", 							processor, { {1, 0.5, 0} } );
-		performTest("{distance} 1:1 real zero order 1", 							processor, { {1, -0.1, 0} } );
-		performTest("{distance} 1:1 real zero order 1", 							processor, { {1, 0.9, 0} } );
-		performTest("{distance} 2:1 real zero order 2", 							processor, { {2, -0.5, 0} } );
-		performTest("{distance} 2:1 complex zero order 1 a", 						processor, { {2, 0.3, 0.4} } );
-		performTest("{distance} 2:1 complex zero order 1 b",						processor, { {2, 0.4, 0.5} } );
-		performTest("{distance} 2:1 complex zero order 1 c",						processor, { {2, 0.6, 0.7} } );
-		performTest("{distance} 3:1 real zero order 3 a",							processor, { {3, -0.5, 0} } );
-		performTest("{distance} 3:1 real zero order 3 b",							processor, { {3, -0.9, 0} } );
-		performTest("{distance} 3:1 real zero order 3 c",							processor, { {3, 0.9, 0} } );
-		performTest("{distance} 3:1 real zero order 3 d",							processor, { {3, 0.1, 0} } );
-		performTest("{distance} 4:1 real zero order 4 a",							processor, { {4,-0.9,0} } );
-		performTest("{distance} 4:1 real zero order 4 b",							processor, { {4,-0.5,0} } );
-		performTest("{distance} 4:1 real zero order 4 c",							processor, { {4,-0.1,0} } );
-		performTest("{distance} 5:1 real zero order 5",								processor, { {5,-0.5,0} } );
-		performTest("{distance} 5:1 real zero order 5 b",							processor, { {5,-0.1,0} } );
-		performTest("{distance} 5:1 real zero order 5 c",							processor, { {5,-0.9,0} } );
-		performTest("{distance} 6:1 real zero order 6 a",							processor, { {6,-0.01,0} } );
-		performTest("{distance} 6:1 real zero order 6 b",							processor, { {6,-0.99,0} } );
-		performTest("{distance} 6:1 complex zero order 3",							processor, { {3,0.99,0.4} } );
-		performTest("{distance} 6:1 complex zero order 3 b",						processor, { {3,0.1,0.4} } );
-		performTest("{distance} 7:1 real zero order 7 a",							processor, { {7,-0.9,0} } );
-		performTest("{distance} 7:1 real zero order 7 b",							processor, { {7,-0.1,0} } );
-		performTest("{distance} 8:1 real zero order 8",								processor, { {8,-0.5,0} } );
-		performTest("{distance} 9:1 real zero order 9",								processor, { {9,-0.5,0} } );
-		performTest("{distance} 10:1 real zero order 10",							processor, { {10,-0.5,0} } );
-		performTest("{distance} 14:1 real zero order 14",							processor, { {14,-0.5,0} } );
-		performTest("{distance} 20:1 real zero order 20",							processor, { {20,-0.5,0} } );
-		performTest("{distance} 28:1 real zero order 28",							processor, { {28,-0.5,0} } );
-		performTest("{distance} 32:1 real zero order 32",							processor, { {32,-0.5,0} } );
+		for (auto& testCase : getCases())
+			performTest(testCase.name, processor, testCase.roots);
+	}
+
+	struct Case
+	{
+		juce::String name;
+		std::vector<TestRootSpecification> roots;
+	};
+
+	/* one-root cases, shared with CoefficientsToRootsBenchmark */
+	static const std::vector<Case>& getCases()
+	{
+		static const std::vector<Case> cases{
+			// poles
+			{ "{distance} 1:1 real pole order 1 a", { {-1, -0.5, 0} } },
+			{ "{distance} 1:1 real pole order 1 b", { {-1, 0.5, 0} } },
+			{ "{distance} 1:1 real pole order 1 c", { {-1, -0.1, 0} } },
+			{ "{distance} 1:1 real pole order 1 d", { {-1, 0.9, 0} } },
+			{ "{distance} 2:1 real pole order 2", { {-2, -0.5, 0} } },
+			{ "{distance} 2:1 complex pole order 1 a", { {-2, 0.3, 0.4} } },
+			{ "{distance} 2:1 complex pole order 1 b", { {-2, 0.4, 0.5} } },
+			{ "{distance} 2:1 complex pole order 1 c", { {-2, 0.6, 0.7} } },
+			{ "{distance} 3:1 real pole order 3 a", { {-3, -0.5, 0} } },
+			{ "{distance} 3:1 real pole order 3 b", { {-3, -0.9, 0} } },
+			{ "{distance} 3:1 real pole order 3 c", { {-3, 0.9, 0} } },
+			{ "{distance} 3:1 real pole order 3 d", { {-3, 0.1, 0} } },
+			{ "{distance} 4:1 real pole order 4 a", { {-4,-0.9,0} } },
+			{ "{distance} 4:1 real pole order 4 b", { {-4,-0.5,0} } },
+			{ "{distance} 4:1 real pole order 4 c", { {-4,-0.1,0} } },
+			{ "{distance} 5:1 real pole order 5 a", { {-5,-0.5,0} } },
+			{ "{distance} 5:1 real pole order 5 b", { {-5,-0.1,0} } },
+			{ "{distance} 5:1 real pole order 5 c", { {-5,-0.9,0} } },
+			{ "{distance} 6:1 real pole order 6 a", { {-6,-0.01,0} } },
+			{ "{distance} 6:1 real pole order 6 b", { {-6,-0.99,0} } },
+			{ "{distance} 6:1 complex pole order 3", { {-3,0.99,0.4} } },
+			{ "{distance} 6:1 complex pole order 3 b", { {-3,0.1,0.4} } },
+			{ "{distance} 7:1 real pole order 7 a", { {-7,-0.9,0} } },
+			{ "{distance} 7:1 real pole order 7 b", { {-7,-0.1,0} } },
+			{ "{distance} 8:1 real pole order 8", { {-8,-0.5,0} } },
+			{ "{distance} 9:1 real pole order 9", { {-9,-0.5,0} } },
+			{ "{distance} 10:1 real pole order 10", { {-10,-0.5,0} } },
+			{ "{distance} 14:1 real pole order 14", { {-14,-0.5,0} } },
+			{ "{distance} 20:1 real pole order 20", { {-20,-0.5,0} } },
+			{ "{distance} 28:1 real pole order 28", { {-28,-0.5,0} } },
+			{ "{distance} 32:1 real pole order 32", { {-32,-0.5,0} } },
+			// zeroes
+			{ "{distance} 1:1 real zero order 1", { {1, -0.5, 0} } },
+			{ "{distance} 1:1 real zero order 1", { {1, 0.5, 0} } },
+			{ "{distance} 1:1 real zero order 1", { {1, -0.1, 0} } },
+			{ "{distance} 1:1 real zero order 1", { {1, 0.9, 0} } },
+			{ "{distance} 2:1 real zero order 2", { {2, -0.5, 0} } },
+			{ "{distance} 2:1 complex zero order 1 a", { {2, 0.3, 0.4} } },
+			{ "{distance} 2:1 complex zero order 1 b", { {2, 0.4, 0.5} } },
+			{ "{distance} 2:1 complex zero order 1 c", { {2, 0.6, 0.7} } },
+			{ "{distance} 3:1 real zero order 3 a", { {3, -0.5, 0} } },
+			{ "{distance} 3:1 real zero order 3 b", { {3, -0.9, 0} } },
+			{ "{distance} 3:1 real zero order 3 c", { {3, 0.9, 0} } },
+			{ "{distance} 3:1 real zero order 3 d", { {3, 0.1, 0} } },
+			{ "{distance} 4:1 real zero order 4 a", { {4,-0.9,0} } },
+			{ "{distance} 4:1 real zero order 4 b", { {4,-0.5,0} } },
+			{ "{distance} 4:1 real zero order 4 c", { {4,-0.1,0} } },
+			{ "{distance} 5:1 real zero order 5", { {5,-0.5,0} } },
+			{ "{distance} 5:1 real zero order 5 b", { {5,-0.1,0} } },
+			{ "{distance} 5:1 real zero order 5 c", { {5,-0.9,0} } },
+			{ "{distance} 6:1 real zero order 6 a", { {6,-0.01,0} } },
+			{ "{distance} 6:1 real zero order 6 b", { {6,-0.99,0} } },
+			{ "{distance} 6:1 complex zero order 3", { {3,0.99,0.4} } },
+			{ "{distance} 6:1 complex zero order 3 b", { {3,0.1,0.4} } },
+			{ "{distance} 7:1 real zero order 7 a", { {7,-0.9,0} } },
+			{ "{distance} 7:1 real zero order 7 b", { {7,-0.1,0} } },
+			{ "{distance} 8:1 real zero order 8", { {8,-0.5,0} } },
+			{ "{distance} 9:1 real zero order 9", { {9,-0.5,0} } },
+			{ "{distance} 10:1 real zero order 10", { {10,-0.5,0} } },
+			{ "{distance} 14:1 real zero order 14", { {14,-0.5,0} } },
+			{ "{distance} 20:1 real zero order 20", { {20,-0.5,0} } },
+			{ "{distance} 28:1 real zero order 28", { {28,-0.5,0} } },
+			{ "{distance} 32:1 real zero order 32", { {32,-0.5,0} } },
+		};
+		return cases;
 	}
 
 	static void printReport()
@@ -0,0 +1,97 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "../src/PluginProcessor.h"
+
+class CompiledChainCacheTest : public juce::UnitTest
+{
+public:
+    CompiledChainCacheTest() : UnitTest("CompiledChainCacheTest", "Math")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        auto* state = processor.filterState.get();
+        const auto options = ChainCompileOptions::optimised();
+
+        std::vector<TestRootSpecification> a{ { -1, 0.5, 0.5 }, { -2, 0.3, 0 }, { 1, 0.6, 0.7 } };
+        std::vector<TestRootSpecification> aReordered{ { -2, 0.3, 0 }, { -1, 0.5, 0.5 }, { 1, 0.6, 0.7 } };
+        std::vector<TestRootSpecification> b{ { -1, 0.9, 0.1 }, { 1, -0.5, 0 } };
+        std::vector<TestRootSpecification> c{ { -1, -0.2, 0.4 } };
+
+        beginTest("Key doesn't depend on root order");
+        TestHelper::makeFilterState(state, a, 1.f);
+        const auto keyA = CompiledChainCache::makeKey(state, options);
+        TestHelper::makeFilterState(state, aReordered, 1.f);
+        expect(CompiledChainCache::makeKey(state, options) == keyA);
+        TestHelper::makeFilterState(state, a, 0.5f);
+        expect(CompiledChainCache::makeKey(state, options) != keyA, "gain is part of the key");
+        TestHelper::makeFilterState(state, a, 1.f);
+        expect(CompiledChainCache::makeKey(state, {}) != keyA, "options are part of the key");
+
+        beginTest("Going back to a compiled state hits");
+        {
+            CompiledChainCache cache;
+            TestHelper::makeFilterState(state, a, 1.f);
+            auto chainA = cache.getOrCompile(state, options);
+            TestHelper::makeFilterState(state, b, 1.f);
+            auto chainB = cache.getOrCompile(state, options);
+            TestHelper::makeFilterState(state, aReordered, 1.f);
+            expect(cache.getOrCompile(state, options) == chainA);
+            TestHelper::makeFilterState(state, b, 1.f);
+            expect(cache.getOrCompile(state, options) == chainB);
+
+            expectEquals((int)cache.getHits(), 2);
+            expectEquals((int)cache.getMisses(), 2);
+            expectWithinAbsoluteError(cache.getHitRate(), 0.5, 1e-12);
+        }
+
+        beginTest("Least recently used chain is evicted");
+        {
+            CompiledChainCache cache(2);
+            TestHelper::makeFilterState(state, a, 1.f);
+            cache.getOrCompile(state, options);
+            TestHelper::makeFilterState(state, b, 1.f);
+            cache.getOrCompile(state, options);
+            TestHelper::makeFilterState(state, a, 1.f);
+            cache.getOrCompile(state, options);     // b is now the oldest
+            TestHelper::makeFilterState(state, c, 1.f);
+            cache.getOrCompile(state, options);
+            expectEquals((int)cache.size(), 2);
+
+            TestHelper::makeFilterState(state, a, 1.f);
+            cache.getOrCompile(state, options);
+            expectEquals((int)cache.getMisses(), 3);
+            TestHelper::makeFilterState(state, b, 1.f);
+            cache.getOrCompile(state, options);
+            expectEquals((int)cache.getMisses(), 4);
+        }
+
+        beginTest("Cached chain applies like a fresh compile");
+        {
+            CompiledChainCache cache;
+            TestHelper::makeFilterState(state, a, 1.f);
+            cache.getOrCompile(state, options);
+
+            FullState<float> fresh, cached;
+            fresh.add(new ProcessorChain<float>);
+            cached.add(new ProcessorChain<float>);
+            ProcessorChainModifier::rootsToJuceCoeffs(state, &fresh, spec, options);
+            ProcessorChainModifier::apply(*cache.getOrCompile(state, options), &cached, spec);
+
+            expectEquals(cached[0]->iirCascade.size(), fresh[0]->iirCascade.size());
+            for (int i = 0; i < fresh[0]->iirCascade.size(); i++)
+                expect(cached[0]->iirCascade[i]->coefficients->coefficients == fresh[0]->iirCascade[i]->coefficients->coefficients);
+            expect(cached[0]->firFilter->coefficients->coefficients == fresh[0]->firFilter->coefficients->coefficients);
+            expectEquals(cached[0]->delay.getDelay(), fresh[0]->delay.getDelay());
+        }
+    }
+
+private:
+    juce::dsp::ProcessSpec spec{ 48000, 512, 1 };
+};
+
+static CompiledChainCacheTest compiledChainCacheTest;
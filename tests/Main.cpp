@@ -4,18 +4,39 @@
 #include "PhaseFrequencyResponseTest.h"
 #include "CoefficientsToRootsTest.h"
 #include "CoefficientsToRootsDistanceTest.h"
+#include "MinCostPairingTest.h"
+#include "SectionScalingTest.h"
+#include "CompiledChainCacheTest.h"
+#include "AberthTest.h"
+#include "CoefficientsToRootsBatchTest.h"
+#include "TimeResponseTest.h"
+#include "TransferFunctionMapTest.h"
+#include "PlayerFileLoaderTest.h"
+#include "SincResamplerTest.h"
+#include "AnalysisTapTest.h"
+#include "AnalysisTapBenchmark.h"
+#include "PairingBenchmark.h"
+#include "CoefficientsToRootsBenchmark.h"
+#include "RootsToCoefficientsBenchmark.h"
+#include "PhaseFrequencyResponseBenchmark.h"
 
 //==============================================================================
 int main (int argc, char* argv[])
 {
-    juce::ignoreUnused(argc);
-    juce::ignoreUnused(argv);
+    // NOTE: benchmarks only run with --benchmark, and then nothing else does
+    const bool runBenchmarks = juce::ArgumentList(argc, argv).containsOption("--benchmark");
 
     juce::ScopedJuceInitialiser_GUI libraryInitialiser; // for proper processor initialization in test classes
     juce::UnitTestRunner runner;
-    runner.runAllTests();
+    juce::Array<juce::UnitTest*> tests;
+    for (auto* test : juce::UnitTest::getAllTests())
+        if ((test->getCategory() == "Benchmark") == runBenchmarks)
+            tests.add(test);
+    runner.runTests(tests);
 
     std::cout << "\n===== All tests complete =====\n"<<std::endl;
+    if (runBenchmarks)
+        return 0;
 
     CoefficientsToRootsTest::printReport();
     std::cout<<"\n------------------------------\n"<<std::endl;
@@ -0,0 +1,110 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "../src/PluginProcessor.h"
+#include "../src/MinCostAssignment.h"
+#include "../src/PhaseFrequencyResponseCalculator.h"
+
+class MinCostPairingTest : public juce::UnitTest
+{
+public:
+    MinCostPairingTest() : UnitTest("MinCostPairingTest", "Math")
+    { }
+
+    void runTest() override
+    {
+        beginTest("Assignment is optimal");
+        juce::Random random(42);
+        for (int trial = 0; trial < 200; trial++)
+        {
+            const int rows = 1 + random.nextInt(5);
+            const int columns = rows + random.nextInt(3);
+            std::vector<double> cost(static_cast<size_t>(rows * columns));
+            for (auto& c : cost)
+                c = random.nextInt(100);
+
+            const auto assignment = MinCostAssignment::solve(cost, rows, columns);
+            std::vector<bool> isColumnUsed(static_cast<size_t>(columns), false);
+            double total = 0;
+            for (int r = 0; r < rows; r++)
+            {
+                const int c = assignment[static_cast<size_t>(r)];
+                expect(c >= 0 && c < columns && !isColumnUsed[static_cast<size_t>(c)]);
+                isColumnUsed[static_cast<size_t>(c)] = true;
+                total += cost[static_cast<size_t>(r * columns + c)];
+            }
+            expectWithinAbsoluteError(total, bruteForce(cost, rows, columns), 1e-9);
+        }
+
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+
+        performTest(
+            "Complex poles and zeros",
+            processor,
+            { { -1, 0.5, 0.5 }, { -1, -0.3, 0.6 }, { 1, 0.6, 0.7 }, { 1, -0.9, 0.1 } });
+
+        performTest(
+            "Real poles of higher order",
+            processor,
+            { { -3, 0.8, 0 }, { -2, -0.4, 0 }, { 1, 0.9, 0 }, { 2, -1, 0 }, { 1, 0.2, 0.7 } });
+
+        performTest(
+            "More zeros than fit into sections",
+            processor,
+            { { -1, 0.7, 0.2 }, { 1, 0.5, 0 }, { 1, -0.5, 0 }, { 1, 0.1, 0.9 } });
+    }
+
+private:
+    juce::dsp::ProcessSpec spec{ 48000, 512, 1 };
+
+    static double bruteForce(const std::vector<double>& cost, int rows, int columns)
+    {
+        std::vector<int> permutation(static_cast<size_t>(columns));
+        for (int i = 0; i < columns; i++)
+            permutation[static_cast<size_t>(i)] = i;
+
+        double best = std::numeric_limits<double>::max();
+        do
+        {
+            double total = 0;
+            for (int r = 0; r < rows; r++)
+                total += cost[static_cast<size_t>(r * columns + permutation[static_cast<size_t>(r)])];
+            best = std::min(best, total);
+        } while (std::next_permutation(permutation.begin(), permutation.end()));
+        return best;
+    }
+
+    void performTest(
+        const juce::String testName,
+        AudioPluginAudioProcessor& processor,
+        std::vector<TestRootSpecification> roots)
+    {
+        // the min-cost chain must realise the same transfer function as the roots
+        beginTest(testName);
+        TestHelper::makeFilterState(processor.filterState.get(), roots, 1.f);
+
+        FullState<float> state;
+        state.add(new ProcessorChain<float>);
+        ProcessorChainModifier::rootsToJuceCoeffs(processor.filterState.get(), &state, spec, ChainCompileOptions::optimised());
+        auto* chain = state[0];
+
+        for (int i = 1; i < 16; i++)
+        {
+            const double angle = juce::MathConstants<double>::pi * i / 16;
+            const double freq = angle / juce::MathConstants<double>::twoPi * spec.sampleRate;
+
+            double expectedDb, phase;
+            PhaseFrequencyResponseCalculator::calculateForAngle(processor.filterState.get(), 1, juce::MathConstants<double>::pi, angle, expectedDb, phase);
+
+            double magnitude = chain->firFilter->coefficients->getMagnitudeForFrequency(freq, spec.sampleRate);
+            for (auto* filter : chain->iirCascade)
+                magnitude *= filter->coefficients->getMagnitudeForFrequency(freq, spec.sampleRate);
+
+            expectWithinAbsoluteError(juce::Decibels::gainToDecibels(magnitude, -300.0), expectedDb, 1e-2);
+        }
+    }
+};
+
+static MinCostPairingTest minCostPairingTest;
@@ -0,0 +1,84 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "../src/PluginProcessor.h"
+
+class PairingBenchmark : public juce::UnitTest
+{
+public:
+    PairingBenchmark() : UnitTest("PairingBenchmark", "Benchmark")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        juce::Random random(7);
+
+        for (int rootCount : { 8, 32, 128, 256 })
+        {
+            beginTest(juce::String(rootCount) + " poles and zeros");
+            makeRandomState(processor.filterState.get(), rootCount, random);
+
+            ChainCompileOptions greedy;
+            const auto greedyResult = measure(processor, greedy);
+            const auto minCostResult = measure(processor, ChainCompileOptions::optimised());
+
+            logMessage("greedy:   " + juce::String(greedyResult.milliseconds, 3) + " ms, peak section gain "
+                + juce::String(greedyResult.peakGainDb, 2) + " dB");
+            logMessage("min-cost: " + juce::String(minCostResult.milliseconds, 3) + " ms, peak section gain "
+                + juce::String(minCostResult.peakGainDb, 2) + " dB");
+        }
+    }
+
+private:
+    struct Result
+    {
+        double milliseconds;
+        double peakGainDb;
+    };
+
+    juce::dsp::ProcessSpec spec{ 48000, 512, 1 };
+    static constexpr int repeats = 5;
+    static constexpr int gridSize = 512;
+
+    static void makeRandomState(FilterState* state, int rootCount, juce::Random& random)
+    {
+        state->clear();
+        for (int i = 0; i < rootCount; i++)
+        {
+            const double magnitude = 0.2 + 0.75 * random.nextDouble();
+            const double angle = juce::MathConstants<double>::pi * random.nextDouble();
+            const bool isReal = random.nextBool();
+            state->add(-1, std::polar(magnitude, isReal ? 0.0 : angle));
+
+            const double zeroMagnitude = 1.2 * random.nextDouble();
+            const double zeroAngle = juce::MathConstants<double>::pi * random.nextDouble();
+            state->add(1, std::polar(zeroMagnitude, isReal ? 0.0 : zeroAngle));
+        }
+    }
+
+    Result measure(AudioPluginAudioProcessor& processor, const ChainCompileOptions& options)
+    {
+        FullState<float> state;
+        state.add(new ProcessorChain<float>);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < repeats; i++)
+            ProcessorChainModifier::rootsToJuceCoeffs(processor.filterState.get(), &state, spec, options);
+        const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+        // the loudest any single section gets, on a fine grid
+        double peak = 0;
+        for (auto* filter : state[0]->iirCascade)
+            for (int i = 0; i <= gridSize; i++)
+            {
+                const double freq = 0.5 * spec.sampleRate * i / gridSize;
+                peak = std::max(peak, filter->coefficients->getMagnitudeForFrequency(freq, spec.sampleRate));
+            }
+
+        return { 1e3 * juce::Time::highResolutionTicksToSeconds(elapsed) / repeats, juce::Decibels::gainToDecibels(peak) };
+    }
+};
+
+static PairingBenchmark pairingBenchmark;
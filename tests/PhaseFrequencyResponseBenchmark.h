@@ -0,0 +1,126 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "../src/PluginProcessor.h"
+#include "../src/PhaseFrequencyResponseCalculator.h"
+
+class PhaseFrequencyResponseBenchmark : public juce::UnitTest
+{
+public:
+    PhaseFrequencyResponseBenchmark() : UnitTest("PhaseFrequencyResponseBenchmark", "Benchmark")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        auto* state = processor.filterState.get();
+        juce::Random random(7);
+
+        for (int rootCount : { 16, 64, 128, 256 })
+        {
+            beginTest(juce::String(rootCount) + " poles and zeros, " + juce::String(width) + " wide");
+            state->clear();
+            for (int i = 0; i < rootCount; i++)
+            {
+                const bool isReal = random.nextBool();
+                state->add(-1, std::polar(0.2 + 0.75 * random.nextDouble(), isReal ? 0.0 : pi * random.nextDouble()));
+                state->add(1, std::polar(1.2 * random.nextDouble(), isReal ? 0.0 : pi * random.nextDouble()));
+            }
+
+            // what calculate did before the grid evaluation: every root read and evaluated at every point
+            std::vector<double> angles, amplitudes, phases;
+            const auto pointStart = juce::Time::getHighResolutionTicks();
+            for (int r = 0; r < repeats; r++)
+            {
+                PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, true, true, width, angles, amplitudes, phases);
+                for (size_t i = 0; i < angles.size(); i++)
+                    PhaseFrequencyResponseCalculator::calculateForAngle(state, 180.0 / pi, 180.0, angles[i], amplitudes[i], phases[i]);
+            }
+            const auto pointTicks = juce::Time::getHighResolutionTicks() - pointStart;
+
+            const auto gridStart = juce::Time::getHighResolutionTicks();
+            for (int r = 0; r < repeats; r++)
+                PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, true, true, width, angles, amplitudes, phases);
+            const auto gridTicks = juce::Time::getHighResolutionTicks() - gridStart;
+
+            // the point by point loop includes one grid evaluation for the angles
+            const double grid = 1e3 * juce::Time::highResolutionTicksToSeconds(gridTicks) / repeats;
+            const double point = 1e3 * juce::Time::highResolutionTicksToSeconds(pointTicks) / repeats - grid;
+            logMessage("point by point " + juce::String(point, 3) + " ms, grid " + juce::String(grid, 3) + " ms");
+        }
+
+        // linear export sized grids from the roots and from the coefficients by FFT
+        for (int rootCount : { 32, 128, 512 })
+        {
+            beginTest(juce::String(rootCount) + " poles and zeros, " + juce::String(exportWidth) + " wide, uniform grid");
+            RootSnapshot snapshot;
+            for (int i = 0; i < rootCount; i++)
+            {
+                for (auto [roots, value] : { std::pair{ &snapshot.poles, std::polar(0.5 + 0.499 * random.nextDouble(), pi * random.nextDouble()) },
+                                             std::pair{ &snapshot.zeros, std::polar(1.2 * random.nextDouble(), pi * random.nextDouble()) } })
+                {
+                    roots->re.push_back(value.real());
+                    roots->im.push_back(value.imag());
+                    roots->order.push_back(1);
+                    roots->isReal.push_back(0);
+                }
+            }
+
+            const size_t count = exportWidth;
+            std::vector<double> cosines(count), sines(count), logMagnitudes(count), phases(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                cosines[i] = std::cos(pi / count * i);
+                sines[i] = std::sin(pi / count * i);
+            }
+
+            const auto directStart = juce::Time::getHighResolutionTicks();
+            PhaseFrequencyResponseCalculator::evaluate(snapshot, cosines.data(), sines.data(), count, logMagnitudes.data(), phases.data());
+            const auto directTicks = juce::Time::getHighResolutionTicks() - directStart;
+
+            const auto fftStart = juce::Time::getHighResolutionTicks();
+            PhaseFrequencyResponseCalculator::evaluateUniform(snapshot, count, logMagnitudes.data(), phases.data());
+            const auto fftTicks = juce::Time::getHighResolutionTicks() - fftStart;
+
+            logMessage("from the roots " + juce::String(1e3 * juce::Time::highResolutionTicksToSeconds(directTicks), 3)
+                + " ms, by FFT " + juce::String(1e3 * juce::Time::highResolutionTicksToSeconds(fftTicks), 3) + " ms");
+        }
+
+        // export sized grids split between more and more workers
+        WorkerPool pool;
+        for (int rootCount : { 16, 256 })
+        {
+            beginTest(juce::String(rootCount) + " poles and zeros, " + juce::String(exportWidth) + " wide, by workers");
+            state->clear();
+            for (int i = 0; i < rootCount; i++)
+            {
+                state->add(-1, std::polar(0.2 + 0.75 * random.nextDouble(), pi * random.nextDouble()));
+                state->add(1, std::polar(1.2 * random.nextDouble(), pi * random.nextDouble()));
+            }
+
+            std::vector<double> angles, amplitudes, phases;
+            double serial = 0.0;
+            for (int workers = 1; ; workers = std::min(2 * workers, pool.getNumWorkers()))
+            {
+                const auto start = juce::Time::getHighResolutionTicks();
+                for (int r = 0; r < repeats; r++)
+                    PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, true, true, exportWidth, angles, amplitudes, phases, &pool, workers);
+                const double ms = 1e3 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) / repeats;
+                if (workers == 1)
+                    serial = ms;
+                logMessage(juce::String(workers) + " workers " + juce::String(ms, 3) + " ms, x" + juce::String(serial / ms, 2));
+                if (workers == pool.getNumWorkers())
+                    break;
+            }
+        }
+    }
+
+private:
+    static constexpr int width = 3840;
+    static constexpr int exportWidth = 65536;
+    static constexpr int repeats = 5;
+    static constexpr double pi = juce::MathConstants<double>::pi;
+};
+
+static PhaseFrequencyResponseBenchmark phaseFrequencyResponseBenchmark;
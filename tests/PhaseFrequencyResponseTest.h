@@ -4,7 +4,7 @@
 #include <juce_data_structures/juce_data_structures.h>
 #include "TestHelper.h"
 #include "../src/PluginProcessor.h"
-#include "../src/PhaseFrequencyResponseCalculator.h"
+#include "../src/PhaseFrequencyResponseWorker.h"
 
 class PhaseFrequencyResponseTest : public juce::UnitTest
 {
@@ -68,6 +68,287 @@ public:
             0.75 * pi,
             8.3630811007041093, // 2 * std::sqrt(3) * (1 + std::sqrt(2))
             2.5261129449194057); // -pi + 0.75 * pi + pi + std::atan2(1 - 1 / std::sqrt(2), 1 + 1 / std::sqrt(2))
+
+        performGridTest(processor, 60);
+
+        beginTest("Uniform grid by FFT");
+        {
+            // spread roots, some close to the unit circle, and an 8-fold zero at -1 whose
+            // expanded coefficients are binomial
+            juce::Random random(11);
+            RootSnapshot snapshot;
+            for (int i = 0; i < 60; i++)
+            {
+                const auto pole = std::polar(0.5 + 0.499 * random.nextDouble(), pi * random.nextDouble());
+                const auto zero = std::polar(1.3 * random.nextDouble(), pi * random.nextDouble());
+                for (auto [roots, value] : { std::pair{ &snapshot.poles, pole }, std::pair{ &snapshot.zeros, zero } })
+                {
+                    roots->re.push_back(value.real());
+                    roots->im.push_back(value.imag());
+                    roots->order.push_back(1);
+                    roots->isReal.push_back(0);
+                }
+            }
+            snapshot.zeros.re.push_back(-1);
+            snapshot.zeros.im.push_back(0);
+            snapshot.zeros.order.push_back(8);
+            snapshot.zeros.isReal.push_back(1);
+
+            const size_t count = 4096;
+            std::vector<double> cosines(count), sines(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                cosines[i] = std::cos(pi / count * i);
+                sines[i] = std::sin(pi / count * i);
+            }
+            std::vector<double> logMagnitudes(count), phases(count), expectedLogs(count), expectedPhases(count);
+            PhaseFrequencyResponseCalculator::evaluate(snapshot, cosines.data(), sines.data(), count, expectedLogs.data(), expectedPhases.data());
+            expect(PhaseFrequencyResponseCalculator::evaluateUniform(snapshot, count, logMagnitudes.data(), phases.data()));
+            for (size_t i = 0; i < count; i++)
+            {
+                expectWithinAbsoluteError(logMagnitudes[i], expectedLogs[i], 1e-7);
+                expectWithinAbsoluteError(std::remainder(phases[i] - expectedPhases[i], 2 * pi), 0.0, 1e-7);
+            }
+
+            expect(!PhaseFrequencyResponseCalculator::evaluateUniform(snapshot, 3000, logMagnitudes.data(), phases.data()),
+                "only powers of 2");
+        }
+
+        beginTest("Adaptive samples resolve a notch and a peak");
+        {
+            auto* state = processor.filterState.get();
+            std::vector<TestRootSpecification> roots{
+                { 1, 0.9999 * std::cos(1.0), 0.9999 * std::sin(1.0) },
+                { -1, 0.9999 * std::cos(2.0), 0.9999 * std::sin(2.0) },
+                { -1, 0.5, 0.3 },
+                { 1, -0.7, 0.1 } };
+            TestHelper::makeFilterState(state, roots, 1);
+
+            ResponseSamples samples;
+            PhaseFrequencyResponseCalculator::calculateAdaptive(state, 20.0f, 48000.0, false, true, 250, samples);
+            expectEquals((int)samples.size(), 250);
+            bool isIncreasing = samples.positions.front() >= 0 && samples.positions.back() < 1;
+            for (size_t i = 0; i < samples.size(); i++)
+            {
+                isIncreasing = isIncreasing && (i == 0 || samples.positions[i] > samples.positions[i - 1]);
+                double amplitude, phase;
+                PhaseFrequencyResponseCalculator::calculateForAngle(state, 180.0 / pi, 180.0, samples.angles[i], amplitude, phase);
+                expectWithinAbsoluteError(samples.amplitudes[i], amplitude, 1e-9 * std::max(1.0, std::abs(amplitude)));
+            }
+            expect(isIncreasing, "positions increase within the band");
+
+            // a uniform grid of four times as many points misses both
+            double notch, peak, phase;
+            PhaseFrequencyResponseCalculator::calculateForAngle(state, 180.0 / pi, 180.0, 1.0, notch, phase);
+            PhaseFrequencyResponseCalculator::calculateForAngle(state, 180.0 / pi, 180.0, 2.0, peak, phase);
+            std::vector<double> angles, amplitudes, phases;
+            PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, false, true, 1000, angles, amplitudes, phases);
+            const auto [minAdaptive, maxAdaptive] = std::minmax_element(samples.amplitudes.begin(), samples.amplitudes.end());
+            const auto [minUniform, maxUniform] = std::minmax_element(amplitudes.begin(), amplitudes.end());
+            expectLessOrEqual(*minAdaptive, notch + 1e-6);
+            expectGreaterOrEqual(*maxAdaptive, peak - 1e-6);
+            expectGreaterThan(*minUniform, notch + 6.0);
+            expectLessThan(*maxUniform, peak - 6.0);
+        }
+
+        beginTest("Group and phase delay");
+        {
+            auto* state = processor.filterState.get();
+            std::vector<TestRootSpecification> roots{
+                { -1, 0.95 * std::cos(0.7), 0.95 * std::sin(0.7) },
+                { -2, -0.6, 0 },
+                { 1, 1.3 * std::cos(2.2), 1.3 * std::sin(2.2) },
+                { 1, 0.4, 0 },
+                { 1, 0.98 * std::cos(2.8), 0.98 * std::sin(2.8) } };
+            TestHelper::makeFilterState(state, roots, 1);
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+
+            const size_t count = 2000;
+            std::vector<double> angles(count), cosines(count), sines(count), logMagnitudes(count), phases(count), groupDelays(count), phaseDelays(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                angles[i] = pi * i / count;
+                cosines[i] = std::cos(angles[i]);
+                sines[i] = std::sin(angles[i]);
+            }
+            PhaseFrequencyResponseCalculator::evaluate(snapshot, cosines.data(), sines.data(), count, logMagnitudes.data(), phases.data(), groupDelays.data());
+            PhaseFrequencyResponseCalculator::phaseDelays(snapshot, angles.data(), phases.data(), groupDelays.data(), count, phaseDelays.data());
+            for (size_t i = 1; i < count; i++)
+            {
+                // against the central difference of the unwrapped phase, which is the wrapped one up to turns
+                const double h = 1e-6;
+                const double phase = PhaseFrequencyResponseCalculator::unwrappedPhase(snapshot, angles[i]);
+                const double difference = -(PhaseFrequencyResponseCalculator::unwrappedPhase(snapshot, angles[i] + h)
+                    - PhaseFrequencyResponseCalculator::unwrappedPhase(snapshot, angles[i] - h)) / (2 * h);
+                expectWithinAbsoluteError(std::remainder(phase - phases[i], 2 * pi), 0.0, 1e-9);
+                expectWithinAbsoluteError(groupDelays[i], difference, 1e-4 * std::max(1.0, std::abs(difference)));
+                expectWithinAbsoluteError(phaseDelays[i], -phase / angles[i], 1e-9 * std::max(1.0, std::abs(phaseDelays[i])));
+            }
+
+            // a pure delay of 3 samples
+            std::vector<TestRootSpecification> delay{ { -3, 0, 0 } };
+            TestHelper::makeFilterState(state, delay, 1);
+            snapshot.capture(*state);
+            PhaseFrequencyResponseCalculator::evaluate(snapshot, cosines.data(), sines.data(), count, logMagnitudes.data(), phases.data(), groupDelays.data());
+            PhaseFrequencyResponseCalculator::phaseDelays(snapshot, angles.data(), phases.data(), groupDelays.data(), count, phaseDelays.data());
+            for (size_t i = 0; i < count; i++)
+            {
+                expectWithinAbsoluteError(groupDelays[i], 3.0, 1e-12);
+                expectWithinAbsoluteError(phaseDelays[i], 3.0, 1e-9);
+            }
+        }
+
+        beginTest("Incremental updates follow a dragged root");
+        {
+            auto* state = processor.filterState.get();
+            std::vector<TestRootSpecification> roots;
+            for (int i = 0; i < 20; i++)
+            {
+                // double poles, so the order changes below never need a slack pole
+                roots.push_back({ -2, 0.9 * std::cos(0.15 * i), 0.9 * std::sin(0.15 * i) });
+                roots.push_back({ 1, 1.1 * std::cos(0.1 * i), 1.1 * std::sin(0.1 * i) });
+            }
+            TestHelper::makeFilterState(state, roots, 1);
+
+            std::vector<double> angles;
+            PhaseFrequencyResponseCalculator::calculateAngles(20.0f, 48000.0, true, 1000, angles);
+            std::vector<double> cosines, sines;
+            for (double angle : angles)
+            {
+                cosines.push_back(std::cos(angle));
+                sines.push_back(std::sin(angle));
+            }
+
+            IncrementalResponse response;
+            response.setGrid(angles);
+            const auto check = [&](const juce::String& name, bool isIncremental)
+            {
+                RootSnapshot snapshot;
+                snapshot.capture(*state);
+                expect(response.update(snapshot) == isIncremental, name);
+
+                const size_t count = angles.size();
+                std::vector<double> logMagnitudes(count), phases(count), delays(count), expectedLogs(count), expectedPhases(count), expectedDelays(count);
+                response.getResponse(logMagnitudes.data(), phases.data(), delays.data());
+                PhaseFrequencyResponseCalculator::evaluate(snapshot, cosines.data(), sines.data(), count, expectedLogs.data(), expectedPhases.data(), expectedDelays.data());
+                for (size_t i = 0; i < count; i++)
+                {
+                    expectWithinAbsoluteError(logMagnitudes[i], expectedLogs[i], 1e-9, name);
+                    expectWithinAbsoluteError(std::remainder(phases[i] - expectedPhases[i], 2 * pi), 0.0, 1e-9, name);
+                    expectWithinAbsoluteError(delays[i], expectedDelays[i], 1e-9 * std::max(1.0, std::abs(expectedDelays[i])), name);
+                }
+            };
+
+            check("first evaluation", false);
+            for (int step = 1; step <= 10; step++)
+            {
+                state->poles[3]->value = std::polar(0.9, 0.45 + 0.02 * step);
+                check("drag step " + juce::String(step), true);
+            }
+            state->poles[3]->value = c128(0.5, 0);
+            check("onto the real axis", true);
+            state->zeros[5]->order = 3;
+            check("changed order", true);
+            state->add(-1, c128(0.2, 0.2));
+            check("added root", false);
+        }
+
+        beginTest("The worker publishes the latest request");
+        {
+            auto* state = processor.filterState.get();
+            PhaseFrequencyResponseWorker worker;
+            expect(worker.getResult() == nullptr);
+
+            PhaseFrequencyResponseWorker::Request request;
+            request.sampleRate = 48000.0;
+            request.isLogScale = true;
+            request.gridSize = 500;
+            request.refineBudget = 250;
+
+            // a drag: requests faster than the worker can keep up with, of which only the last has to come out
+            std::shared_ptr<const PhaseFrequencyResponseWorker::Result> held;
+            for (int step = 1; step <= 20; step++)
+            {
+                state->poles[3]->value = std::polar(0.9, 0.5 + 0.02 * step);
+                request.snapshot.capture(*state);
+                request.revision = static_cast<u64>(step);
+                worker.request(request);
+                if (held == nullptr)
+                    held = worker.getResult();
+            }
+
+            auto result = worker.getResult();
+            for (int wait = 0; wait < 500 && (result == nullptr || result->request.revision != 20); wait++)
+            {
+                juce::Thread::sleep(10);
+                result = worker.getResult();
+            }
+            expect(result != nullptr && result->request.revision == 20);
+            if (result == nullptr)
+                return;
+
+            // a result taken before stays as it was
+            if (held != nullptr)
+                expect(held != result && held->request.revision < 20);
+
+            const auto& samples = result->samples;
+            expect(samples.size() >= request.gridSize && samples.size() <= request.gridSize + request.refineBudget);
+            expectEquals((int)result->phaseDelays.size(), (int)samples.size());
+
+            std::vector<double> cosines, sines;
+            for (double angle : samples.angles)
+            {
+                cosines.push_back(std::cos(angle));
+                sines.push_back(std::sin(angle));
+            }
+            const size_t count = samples.size();
+            std::vector<double> logMagnitudes(count), phases(count);
+            PhaseFrequencyResponseCalculator::evaluate(request.snapshot, cosines.data(), sines.data(), count, logMagnitudes.data(), phases.data());
+            PhaseFrequencyResponseCalculator::toDisplayUnits(count, logMagnitudes.data(), phases.data(), true);
+            for (size_t i = 0; i < count; i++)
+                expectWithinAbsoluteError(samples.amplitudes[i], logMagnitudes[i], 1e-6);
+        }
+
+        beginTest("Revision follows changes to the state");
+        {
+            auto* state = processor.filterState.get();
+            std::vector<TestRootSpecification> roots{ { -1, 0.5, 0.5 }, { 1, 1, 0 } };
+            TestHelper::makeFilterState(state, roots, 1);
+            auto revision = state->revision;
+
+            std::vector<double> angles, amplitudes, phases;
+            PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, true, true, 100, angles, amplitudes, phases);
+            expectEquals(state->revision, revision, "reading the state");
+
+            state->poles[0]->value = c128(0.5, 0.25);
+            expectGreaterThan(state->revision, revision, "moving a root");
+            revision = state->revision;
+
+            state->poles[0]->order = -2;
+            expectGreaterThan(state->revision, revision, "changing an order");
+            revision = state->revision;
+
+            state->add(1, c128(-1, 0));
+            expectGreaterThan(state->revision, revision, "adding a root");
+        }
+
+        beginTest("A restored state misses what was cached for the one it replaces");
+        {
+            std::vector<TestRootSpecification> roots{ { -1, 0.5, 0.5 }, { 1, 1, 0 } };
+            TestHelper::makeFilterState(processor.filterState.get(), roots, 1);
+            juce::MemoryBlock saved;
+            processor.getStateInformation(saved);
+
+            PhaseFrequencyResponseWorker::Request cached;
+            cached.revision = processor.filterState->revision;
+
+            // the same edits on the restored state don't bring it back to the cached revision
+            processor.setStateInformation(saved.getData(), static_cast<int>(saved.getSize()));
+            auto* state = processor.filterState.get();
+            TestHelper::makeFilterState(state, roots, 1);
+            expectGreaterThan(state->revision, cached.revision);
+        }
     }
 
 private:
@@ -92,6 +373,67 @@ private:
             expectWithinAbsoluteError(phase, expectedPhase, maxRelError * std::abs(expectedPhase));
     }
 
+    // the grid evaluation in calculate against calculateForAngle at every point
+    void performGridTest(AudioPluginAudioProcessor& processor, int rootCount)
+    {
+        beginTest("Grid of " + juce::String(rootCount) + " poles and zeros");
+        auto* state = processor.filterState.get();
+        juce::Random random(5);
+        std::vector<TestRootSpecification> roots;
+        for (int i = 0; i < rootCount; i++)
+        {
+            const bool isReal = random.nextInt(3) == 0;
+            const int order = 1 + random.nextInt(2);
+            const auto pole = std::polar(0.2 + 0.75 * random.nextDouble(), isReal ? 0.0 : pi * random.nextDouble());
+            const auto zero = std::polar(1.5 * random.nextDouble(), isReal ? 0.0 : pi * random.nextDouble());
+            roots.push_back({ -order, pole.real(), pole.imag() });
+            roots.push_back({ order, zero.real(), zero.imag() });
+        }
+        TestHelper::makeFilterState(state, roots, 1);
+
+        std::vector<double> angles, amplitudes, phases;
+        PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, true, true, 1000, angles, amplitudes, phases);
+        for (size_t i = 0; i < angles.size(); i++)
+        {
+            double amplitude, phase;
+            PhaseFrequencyResponseCalculator::calculateForAngle(state, 180.0 / pi, 180.0, angles[i], amplitude, phase);
+            expectWithinAbsoluteError(amplitudes[i], amplitude, 1e-9 * std::max(1.0, std::abs(amplitude)));
+            const double difference = std::abs(phases[i] - phase);
+            expectLessThan(std::min(difference, 360.0 - difference), 1e-6);
+        }
+
+        beginTest("Grid split between workers");
+        WorkerPool pool(4);
+        for (int width : { 1000, 4000, 4097 })
+        {
+            std::vector<double> serialAngles, serialAmplitudes, serialPhases;
+            PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, true, true, width, serialAngles, serialAmplitudes, serialPhases);
+            PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, true, true, width, angles, amplitudes, phases, &pool);
+            expect(angles == serialAngles && amplitudes == serialAmplitudes && phases == serialPhases,
+                "same as serial, " + juce::String(width) + " wide");
+        }
+
+        beginTest("Zoomed band");
+        for (bool isLogScale : { false, true })
+        {
+            // a band of about 0.1 Hz at 48 kHz on the linear scale
+            const double bandBegin = 0.3, bandEnd = 0.3 + 4e-6;
+            std::vector<double> fullAngles;
+            PhaseFrequencyResponseCalculator::calculateAngles(20.0f, 48000.0, isLogScale, 1, fullAngles, bandBegin, bandEnd);
+            PhaseFrequencyResponseCalculator::calculate(state, 20.0f, 48000.0, isLogScale, true, 4096, angles, amplitudes, phases, &pool, 0, bandBegin, bandEnd);
+            expectEquals(angles.front(), fullAngles.front());
+            expect(angles.back() > angles.front() && angles.back() - angles.front() < 2e-5, "angles within the band");
+            for (size_t i = 0; i < angles.size(); i++)
+            {
+                double amplitude, phase;
+                PhaseFrequencyResponseCalculator::calculateForAngle(state, 180.0 / pi, 180.0, angles[i], amplitude, phase);
+                expectWithinAbsoluteError(amplitudes[i], amplitude, 1e-9 * std::max(1.0, std::abs(amplitude)));
+                const double difference = std::abs(phases[i] - phase);
+                expectLessThan(std::min(difference, 360.0 - difference), 1e-6);
+            }
+        }
+    }
+
     const double pi = juce::MathConstants<double>::pi;
     const double phaseUnitCoeff = 1.0;
     const double phaseAmplitude = pi;
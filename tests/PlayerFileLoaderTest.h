@@ -0,0 +1,84 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../src/PlayerFileLoader.h"
+
+class PlayerFileLoaderTest : public juce::UnitTest
+{
+public:
+    PlayerFileLoaderTest() : UnitTest("PlayerFileLoaderTest", "Audio")
+    { }
+
+    void runTest() override
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        beginTest("A mono file plays on both channels, streamed or preloaded");
+        {
+            const juce::TemporaryFile temporary(".wav");
+            const auto file = temporary.getFile();
+            constexpr int length = 4800;
+            constexpr double sampleRate = 48000.0;
+            expect(writeMonoSine(file, length, sampleRate));
+
+            // streamed, as AudioFormatReaderSource reads it
+            juce::AudioBuffer<float> streamed(2, length);
+            {
+                juce::AudioFormatReaderSource source(formatManager.createReaderFor(file), true);
+                source.prepareToPlay(length, sampleRate);
+                source.getNextAudioBlock(juce::AudioSourceChannelInfo(streamed));
+            }
+
+            // preloaded, as PlayerFileLoader and MemoryAudioSource play it
+            juce::AudioBuffer<float> preloaded(2, length);
+            {
+                PlayerFileLoader loader(formatManager);
+                loader.start(file, 0.0, 2);
+                while (loader.isLoading())
+                    juce::Thread::sleep(1);
+
+                juce::AudioBuffer<float> loaded;
+                double loadedSampleRate = 0.0;
+                expect(loader.takeResult(loaded, loadedSampleRate));
+                expectEquals(loaded.getNumChannels(), 2);
+                expectEquals(loadedSampleRate, sampleRate);
+
+                juce::MemoryAudioSource source(loaded, false);
+                source.prepareToPlay(length, sampleRate);
+                source.getNextAudioBlock(juce::AudioSourceChannelInfo(preloaded));
+            }
+
+            for (auto* buffer : { &streamed, &preloaded })
+            {
+                expectGreaterThan(buffer->getMagnitude(1, 0, length), 0.4f);
+                for (int i = 0; i < length; i++)
+                    expectEquals(buffer->getSample(1, i), buffer->getSample(0, i));
+            }
+            for (int ch = 0; ch < 2; ch++)
+                for (int i = 0; i < length; i++)
+                    expectEquals(preloaded.getSample(ch, i), streamed.getSample(ch, i));
+        }
+    }
+
+private:
+    static bool writeMonoSine(const juce::File& file, int length, double sampleRate)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 1, 24, {}, 0));
+        if (writer == nullptr)
+            return false;
+        stream.release(); // the writer owns it now
+
+        juce::AudioBuffer<float> sine(1, length);
+        for (int i = 0; i < length; i++)
+            sine.setSample(0, i, 0.5f * (float)std::sin(2.0 * juce::MathConstants<double>::pi * 1000.0 * i / sampleRate));
+        return writer->writeFromAudioSampleBuffer(sine, 0, length);
+    }
+};
+
+static PlayerFileLoaderTest playerFileLoaderTest;
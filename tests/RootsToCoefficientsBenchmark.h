@@ -0,0 +1,70 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "../src/PluginProcessor.h"
+#include "../src/RootsToCoefficients.h"
+
+class RootsToCoefficientsBenchmark : public juce::UnitTest
+{
+public:
+    RootsToCoefficientsBenchmark() : UnitTest("RootsToCoefficientsBenchmark", "Benchmark")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        auto* state = processor.filterState.get();
+        juce::Random random(3);
+
+        // where the product tree catches up with one factor at a time, see ProductTreeMinOrder
+        for (int order : { 16, 64, 128, 256, 512, 1024, 2048, 4096 })
+        {
+            beginTest("Order " + juce::String(order));
+            std::vector<TestRootSpecification> roots;
+            for (int i = 0; i < order / 2; i++)
+            {
+                const auto root = std::polar(0.3 + 0.69 * random.nextDouble(), 0.05 + 3.0 * random.nextDouble());
+                roots.push_back({ 1, root.real(), root.imag() });
+            }
+            TestHelper::makeFilterState(state, roots, 1);
+
+            const auto oneAtATime = measure([&] { return RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->zeros, 1, nullptr, RootsToCoefficients::Expansion::oneAtATime); });
+            const auto productTree = measure([&] { return RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->zeros, 1, nullptr, RootsToCoefficients::Expansion::productTree); });
+            logMessage("one at a time " + juce::String(oneAtATime, 4) + " ms, product tree " + juce::String(productTree, 4) + " ms");
+        }
+
+        // where FFT multiplication catches up with direct, see FftMinLength
+        for (size_t length : { 16, 64, 128, 256, 512, 1024, 2048 })
+        {
+            beginTest("Multiplication of length " + juce::String((int)length));
+            std::vector<double> a(length), b(length);
+            for (auto& c : a)
+                c = 2.0 * random.nextDouble() - 1.0;
+            for (auto& c : b)
+                c = 2.0 * random.nextDouble() - 1.0;
+
+            const auto direct = measure([&] { return RootsToCoefficients::multiply(a, b, std::numeric_limits<size_t>::max()); });
+            const auto fft = measure([&] { return RootsToCoefficients::multiply(a, b, 1); });
+            logMessage("direct " + juce::String(direct, 4) + " ms, FFT " + juce::String(fft, 4) + " ms");
+        }
+    }
+
+private:
+    static constexpr int repeats = 20;
+
+    template <typename Expand>
+    static double measure(Expand expand)
+    {
+        double checksum = 0.0;
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < repeats; i++)
+            checksum += expand().back();
+        const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+        juce::ignoreUnused(checksum);
+        return 1e3 * juce::Time::highResolutionTicksToSeconds(elapsed) / repeats;
+    }
+};
+
+static RootsToCoefficientsBenchmark rootsToCoefficientsBenchmark;
@@ -51,6 +51,26 @@ public:
 			processor,
 			{ {1, 2, -3}, {1, -2, 0} },
 			{ 1, -2, 5, 26 });
+
+		performHighOrderTest(processor, 150);
+
+		beginTest("FFT multiplication against direct");
+		{
+			juce::Random random(5);
+			std::vector<double> a(1500), b(1100);
+			for (auto& c : a)
+				c = 2.0 * random.nextDouble() - 1.0;
+			for (auto& c : b)
+				c = 2.0 * random.nextDouble() - 1.0;
+			a[0] = b[0] = 1.0;
+
+			const auto direct = RootsToCoefficients::multiply(a, b, std::numeric_limits<size_t>::max());
+			const auto fft = RootsToCoefficients::multiply(a, b, 1);
+			expectEquals(fft.size(), direct.size());
+			expectEquals(fft[0], 1.0);
+			for (size_t i = 0; i < fft.size(); i++)
+				expectLessThan(std::abs(fft[i] - direct[i]), 1e-12);
+		}
 	}
 
 private:
@@ -67,11 +87,38 @@ private:
 
 		auto* state = processor.filterState.get();
 		TestHelper::makeFilterState(state, roots, 1);
-		auto res = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->zeros);
+		for (auto expansion : { RootsToCoefficients::Expansion::oneAtATime, RootsToCoefficients::Expansion::productTree })
+		{
+			auto res = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->zeros, 1, nullptr, expansion);
+
+			expectEquals(res.size(), expectedCoefficients.size());
+			for (size_t i = 0; i < res.size(); i++)
+				expectEquals(res[i], expectedCoefficients[i]);
+		}
+	}
+
+	void performHighOrderTest(AudioPluginAudioProcessor& processor, int numRoots)
+	{
+		beginTest("Product tree against one at a time, " + juce::String(2 * numRoots) + " zeros");
+
+		auto* state = processor.filterState.get();
+		juce::Random random(11);
+		std::vector<TestRootSpecification> roots;
+		std::vector<double> bound{ 1.0 };	// coefficients of prod (z + |r|), which bound the rounding of each coefficient
+		for (int i = 0; i < numRoots; i++)
+		{
+			const auto root = std::polar(0.3 + 0.69 * random.nextDouble(), 0.05 + 3.0 * random.nextDouble());
+			roots.push_back({ 1, root.real(), root.imag() });
+			bound = RootsToCoefficients::multiply(bound, { 1.0, 2.0 * std::abs(root), std::norm(root) });
+		}
+		TestHelper::makeFilterState(state, roots, 1);
 
-		expectEquals(res.size(), expectedCoefficients.size());
-		for (size_t i = 0; i < res.size(); i++)
-			expectEquals(res[i], expectedCoefficients[i]);
+		const auto oneAtATime = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->zeros, 1, nullptr, RootsToCoefficients::Expansion::oneAtATime);
+		const auto productTree = RootsToCoefficients::CalculatePolynomialCoefficientsFrom(state->zeros, 1, nullptr, RootsToCoefficients::Expansion::productTree);
+		expectEquals(productTree.size(), oneAtATime.size());
+		expectEquals(productTree[0], 1.0);
+		for (size_t i = 0; i < productTree.size(); i++)
+			expectLessThan(std::abs(productTree[i] - oneAtATime[i]), 1e-12 * bound[i]);
 	}
 };
 
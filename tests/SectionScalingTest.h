@@ -0,0 +1,131 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "../src/PluginProcessor.h"
+#include "../src/PhaseFrequencyResponseCalculator.h"
+
+class SectionScalingTest : public juce::UnitTest
+{
+public:
+    SectionScalingTest() : UnitTest("SectionScalingTest", "Math")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        std::vector<TestRootSpecification> roots{
+            { -1, 0.9362, 0.2896 }, { -1, 0.3515, 0.9041 }, { -1, -0.7210, 0.5386 }, { -1, 0.95, 0 },
+            { 1, 0.6967, 0.7174 }, { 1, -0.2081, 0.4546 }, { 1, -1, 0 } };
+        TestHelper::makeFilterState(processor.filterState.get(), roots, 1.f);
+
+        ChainCompileOptions options;
+        options.pairing = ChainCompileOptions::Pairing::MinCost;
+        options.ordering = ChainCompileOptions::Ordering::MinPartialNorm;
+
+        beginTest("Ordering starts with the quietest section");
+        {
+            compile(processor, options);
+            auto& cascade = state[0]->iirCascade;
+            const double first = peakGain(cascade, 1);
+            for (auto* filter : cascade)
+                expect(first <= peakGain(*filter) * 1.01);
+        }
+
+        beginTest("L-inf scaling keeps every partial response at or below unity");
+        {
+            options.scaling = ChainCompileOptions::Scaling::LInf;
+            compile(processor, options);
+            auto& cascade = state[0]->iirCascade;
+            for (int count = 1; count <= cascade.size(); count++)
+                expectWithinAbsoluteError(peakGain(cascade, count), 1.0, 0.01);
+            expectResponseMatchesRoots(processor);
+        }
+
+        beginTest("L2 scaling gives every partial impulse response unit energy");
+        {
+            options.scaling = ChainCompileOptions::Scaling::L2;
+            compile(processor, options);
+            auto& cascade = state[0]->iirCascade;
+            for (auto* filter : cascade)
+                filter->reset();
+
+            std::vector<double> energy(static_cast<size_t>(cascade.size()), 0.0);
+            for (int n = 0; n < impulseLength; n++)
+            {
+                float sample = n == 0 ? 1.f : 0.f;
+                for (int i = 0; i < cascade.size(); i++)
+                {
+                    sample = cascade[i]->processSample(sample);
+                    energy[static_cast<size_t>(i)] += static_cast<double>(sample) * sample;
+                }
+            }
+            for (double e : energy)
+                expectWithinAbsoluteError(std::sqrt(e), 1.0, 0.02);
+            expectResponseMatchesRoots(processor);
+        }
+
+        state.clear(); // before the processor goes away
+    }
+
+private:
+    juce::dsp::ProcessSpec spec{ 48000, 512, 1 };
+    FullState<float> state;
+    static constexpr int gridSize = 2048;
+    static constexpr int impulseLength = 1 << 16;
+
+    void compile(AudioPluginAudioProcessor& processor, const ChainCompileOptions& options)
+    {
+        state.clear();
+        state.add(new ProcessorChain<float>);
+        ProcessorChainModifier::rootsToJuceCoeffs(processor.filterState.get(), &state, spec, options);
+    }
+
+    double peakGain(const juce::OwnedArray<juce::dsp::IIR::Filter<float>>& cascade, int count) const
+    {
+        double peak = 0;
+        for (int k = 0; k <= gridSize; k++)
+        {
+            const double freq = 0.5 * spec.sampleRate * k / gridSize;
+            double magnitude = 1;
+            for (int i = 0; i < count; i++)
+                magnitude *= cascade[i]->coefficients->getMagnitudeForFrequency(freq, spec.sampleRate);
+            peak = std::max(peak, magnitude);
+        }
+        return peak;
+    }
+
+    double peakGain(const juce::dsp::IIR::Filter<float>& filter) const
+    {
+        double peak = 0;
+        for (int k = 0; k <= gridSize; k++)
+        {
+            const double freq = 0.5 * spec.sampleRate * k / gridSize;
+            peak = std::max(peak, filter.coefficients->getMagnitudeForFrequency(freq, spec.sampleRate));
+        }
+        return peak;
+    }
+
+    void expectResponseMatchesRoots(AudioPluginAudioProcessor& processor)
+    {
+        // scaling must be undone by the FIR, the chain still realises the roots
+        auto* chain = state[0];
+        for (int i = 1; i < 16; i++)
+        {
+            const double angle = juce::MathConstants<double>::pi * i / 16;
+            const double freq = angle / juce::MathConstants<double>::twoPi * spec.sampleRate;
+
+            double expectedDb, phase;
+            PhaseFrequencyResponseCalculator::calculateForAngle(processor.filterState.get(), 1, juce::MathConstants<double>::pi, angle, expectedDb, phase);
+
+            double magnitude = chain->firFilter->coefficients->getMagnitudeForFrequency(freq, spec.sampleRate);
+            for (auto* filter : chain->iirCascade)
+                magnitude *= filter->coefficients->getMagnitudeForFrequency(freq, spec.sampleRate);
+
+            expectWithinAbsoluteError(juce::Decibels::gainToDecibels(magnitude, -300.0), expectedDb, 1e-2);
+        }
+    }
+};
+
+static SectionScalingTest sectionScalingTest;
@@ -0,0 +1,196 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../src/SincResampler.h"
+
+class SincResamplerTest : public juce::UnitTest
+{
+public:
+    SincResamplerTest() : UnitTest("SincResamplerTest", "Audio")
+    { }
+
+    void runTest() override
+    {
+        const std::pair<double, double> ratePairs[] = { { 44100.0, 48000.0 }, { 48000.0, 44100.0 }, { 96000.0, 48000.0 }, { 48000.0, 96000.0 } };
+
+        beginTest("The passband has unity gain");
+        {
+            for (auto [source, target] : ratePairs)
+            {
+                const SincResampler resampler(source, target);
+                const auto output = resampleConstant(resampler, 0.5f);
+                for (size_t i = margin; i + margin < output.size(); i++)
+                    expectWithinAbsoluteError(output[i], 0.5f, 5e-4f);
+
+                // up to a little below the cutoff of the lower Nyquist frequency
+                for (double fraction : { 0.1, 0.5, 0.85 })
+                {
+                    const double frequency = fraction * 0.5 * std::min(source, target);
+                    const auto sine = resampleSine(resampler, source, frequency);
+                    const auto fit = fitSine(sine, 2.0 * pi * frequency / target);
+                    expectWithinAbsoluteError(juce::Decibels::gainToDecibels(fit.amplitude / amplitude), 0.0, 0.01,
+                        juce::String(source) + " -> " + juce::String(target) + " at " + juce::String(frequency) + " Hz");
+                    // images folded back by the conversion, and anything else that isn't the sine
+                    expectLessThan(juce::Decibels::gainToDecibels(fit.residual / amplitude), -75.0);
+                }
+            }
+        }
+
+        beginTest("Frequencies above the output Nyquist frequency are rejected");
+        {
+            for (auto [source, target] : ratePairs)
+            {
+                if (target >= source)
+                    continue;
+
+                // the Kaiser window's transition ends short of the output Nyquist frequency
+                const SincResampler resampler(source, target);
+                for (double fraction : { 0.97, 1.0, 1.1, 1.5 })
+                {
+                    const double frequency = fraction * 0.5 * target;
+                    if (frequency >= 0.5 * source)
+                        continue;
+
+                    const auto sine = resampleSine(resampler, source, frequency);
+                    double energy = 0.0;
+                    for (size_t i = margin; i + margin < sine.size(); i++)
+                        energy += (double)sine[i] * sine[i];
+                    const double rmsAmplitude = std::sqrt(2.0 * energy / (double)(sine.size() - 2 * margin));
+                    expectLessThan(juce::Decibels::gainToDecibels(rmsAmplitude / amplitude, -300.0), -75.0,
+                        juce::String(source) + " -> " + juce::String(target) + " at " + juce::String(frequency) + " Hz");
+                }
+            }
+        }
+
+        auto random = getRandom();
+        constexpr int inputLength = 20000;
+        juce::AudioBuffer<float> noise(1, inputLength);
+        for (int i = 0; i < inputLength; i++)
+            noise.setSample(0, i, random.nextFloat() * 2.0f - 1.0f);
+
+        beginTest("Streaming in odd blocks gives the one-shot conversion");
+        {
+            for (auto [source, target] : ratePairs)
+            {
+                const auto expected = resampleOnce(noise, source, target);
+                juce::MemoryAudioSource memory(noise, true);
+                SincResamplingAudioSource streaming(&memory, source, target, 1);
+                streaming.prepareToPlay(512, target);
+
+                const auto streamed = read(streaming, (int)expected.size());
+                for (size_t i = 0; i < expected.size(); i++)
+                    expectWithinAbsoluteError(streamed[i], expected[i], 1e-5f);
+            }
+        }
+
+        beginTest("The start is zero-padded, and seeking lands on the same samples");
+        {
+            constexpr double source = 44100.0, target = 48000.0;
+            const SincResampler resampler(source, target);
+            const int halfLength = resampler.getHalfLength();
+
+            // the first outputs are as if the file started after explicit silence
+            juce::AudioBuffer<float> padded(1, halfLength + inputLength);
+            padded.clear();
+            padded.copyFrom(0, halfLength, noise, 0, 0, inputLength);
+            std::vector<float> expected(200);
+            resampler.process(padded.getReadPointer(0), padded.getNumSamples(), halfLength, expected.data(), (int)expected.size());
+
+            juce::MemoryAudioSource memory(noise, true);
+            SincResamplingAudioSource streaming(&memory, source, target, 1);
+            streaming.prepareToPlay(512, target);
+            const auto start = read(streaming, (int)expected.size());
+            for (size_t i = 0; i < expected.size(); i++)
+                expectWithinAbsoluteError(start[i], expected[i], 1e-5f);
+
+            const auto whole = resampleOnce(noise, source, target);
+            for (juce::int64 position : { 5000, 17, 12000 })
+            {
+                streaming.setNextReadPosition(position);
+                const auto seeked = read(streaming, 300);
+                expectEquals(streaming.getNextReadPosition(), position + 300);
+                for (size_t i = 0; i < seeked.size(); i++)
+                    expectWithinAbsoluteError(seeked[i], whole[(size_t)position + i], 1e-5f);
+            }
+        }
+    }
+
+private:
+    static constexpr double pi = juce::MathConstants<double>::pi;
+    static constexpr float amplitude = 0.5f;
+    static constexpr int sineLength = 40000;
+    /** outputs the kernel reaches the ends of the input from, left out of the measurements */
+    static constexpr size_t margin = 500;
+
+    struct SineFit
+    {
+        double amplitude = 0.0, residual = 0.0;
+    };
+
+    static std::vector<float> resampleConstant(const SincResampler& resampler, float value)
+    {
+        const std::vector<float> input(sineLength, value);
+        std::vector<float> output((size_t)resampler.getOutputLength(sineLength));
+        resampler.process(input.data(), sineLength, 0.0, output.data(), (int)output.size());
+        return output;
+    }
+
+    static std::vector<float> resampleSine(const SincResampler& resampler, double sampleRate, double frequency)
+    {
+        std::vector<float> input(sineLength);
+        for (int i = 0; i < sineLength; i++)
+            input[(size_t)i] = amplitude * (float)std::sin(2.0 * pi * frequency * i / sampleRate);
+        std::vector<float> output((size_t)resampler.getOutputLength(sineLength));
+        resampler.process(input.data(), sineLength, 0.0, output.data(), (int)output.size());
+        return output;
+    }
+
+    /** least-squares sine at the given frequency over the measured part, and
+     * the RMS amplitude of what's left */
+    static SineFit fitSine(const std::vector<float>& values, double omega)
+    {
+        const size_t begin = margin, end = values.size() - margin;
+        const double n = (double)(end - begin);
+        double s = 0.0, c = 0.0;
+        for (size_t i = begin; i < end; i++)
+        {
+            s += values[i] * std::sin(omega * (double)i);
+            c += values[i] * std::cos(omega * (double)i);
+        }
+        s *= 2.0 / n;
+        c *= 2.0 / n;
+
+        double error = 0.0;
+        for (size_t i = begin; i < end; i++)
+        {
+            const double difference = values[i] - s * std::sin(omega * (double)i) - c * std::cos(omega * (double)i);
+            error += difference * difference;
+        }
+        return { std::hypot(s, c), std::sqrt(2.0 * error / n) };
+    }
+
+    static std::vector<float> resampleOnce(const juce::AudioBuffer<float>& input, double source, double target)
+    {
+        const SincResampler resampler(source, target);
+        std::vector<float> output((size_t)resampler.getOutputLength(input.getNumSamples()));
+        resampler.process(input.getReadPointer(0), input.getNumSamples(), 0.0, output.data(), (int)output.size());
+        return output;
+    }
+
+    /** reads count samples in blocks of awkward sizes */
+    static std::vector<float> read(juce::PositionableAudioSource& source, int count)
+    {
+        static constexpr int blockSizes[] = { 1, 7, 13, 64, 251, 509 };
+        juce::AudioBuffer<float> buffer(1, count);
+        int position = 0;
+        for (size_t block = 0; position < count; block++)
+        {
+            const int numSamples = std::min(blockSizes[block % std::size(blockSizes)], count - position);
+            source.getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, position, numSamples));
+            position += numSamples;
+        }
+        return { buffer.getReadPointer(0), buffer.getReadPointer(0) + count };
+    }
+};
+
+static SincResamplerTest sincResamplerTest;
@@ -0,0 +1,211 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "../src/PluginProcessor.h"
+#include "../src/TimeResponseCalculator.h"
+
+class TimeResponseTest : public juce::UnitTest
+{
+public:
+    TimeResponseTest() : UnitTest("TimeResponseTest", "Math")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        auto* state = processor.filterState.get();
+
+        beginTest("The length covers the decay of the slowest pole");
+        {
+            for (int order : { 1, 2, 3 })
+            {
+                std::vector<TestRootSpecification> roots{ { -order, 0.95, 0 }, { 1, -0.5, 0 } };
+                TestHelper::makeFilterState(state, roots, 1.f);
+                auto chain = ProcessorChainModifier::compile(state);
+                RootSnapshot snapshot;
+                snapshot.capture(*state);
+
+                bool isDecaying = false;
+                const int length = TimeResponseCalculator::responseLength(snapshot.poles, *chain, isDecaying);
+                expect(isDecaying);
+
+                // the tail after the length is 80 dB below the peak, and not much of it is
+                std::vector<float> impulse, step;
+                TimeResponseCalculator::render(*chain, 2 * length, impulse, step);
+                const float peak = largest(impulse, 0, length);
+                const float tail = largest(impulse, length, 2 * length);
+                expect(tail <= 1e-4f * peak, "order " + juce::String(order) + ": tail " + juce::String(tail / peak));
+                expect(largest(impulse, length - length / 8, length) > 1e-4f * peak);
+            }
+        }
+
+        beginTest("A pole on the unit circle doesn't decay");
+        {
+            std::vector<TestRootSpecification> roots{ { -1, 0, 1 }, { -1, 0.5, 0 } };
+            TestHelper::makeFilterState(state, roots, 1.f);
+            auto chain = ProcessorChainModifier::compile(state);
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+
+            bool isDecaying = true;
+            expectEquals(TimeResponseCalculator::responseLength(snapshot.poles, *chain, isDecaying), TimeResponseCalculator::maxLength);
+            expect(!isDecaying);
+        }
+
+        beginTest("The rendered responses realise the roots");
+        {
+            std::vector<TestRootSpecification> roots{
+                { -1, 0.9362, 0.2896 }, { -1, 0.3515, 0.9041 }, { -1, -0.7210, 0.5386 }, { -1, 0.95, 0 },
+                { 1, 0.6967, 0.7174 }, { 1, -0.2081, 0.4546 }, { 1, -1, 0 } };
+            TestHelper::makeFilterState(state, roots, 1.f);
+            auto chain = ProcessorChainModifier::compile(state, ChainCompileOptions::optimised());
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+
+            // NOTE: the 80 dB the length is good for leaves some hundredths of a dB
+            // of truncation error at the notch, longer responses are compared
+            bool isDecaying = false;
+            const int length = 4 * TimeResponseCalculator::responseLength(snapshot.poles, *chain, isDecaying);
+            std::vector<float> impulse, step;
+            expect(TimeResponseCalculator::render(*chain, length, impulse, step));
+            expectEquals((int)impulse.size(), length);
+            expectEquals((int)step.size(), length);
+
+            // the spectrum of the impulse response is the response of the roots
+            for (int i = 1; i < 16; i++)
+            {
+                const double angle = pi * i / 16;
+                std::complex<double> sum = 0;
+                for (int n = 0; n < length; n++)
+                    sum += static_cast<double>(impulse[static_cast<size_t>(n)]) * std::polar(1.0, -angle * n);
+
+                double expectedDb, phase;
+                PhaseFrequencyResponseCalculator::calculateForAngle(state, 1, pi, angle, expectedDb, phase);
+                expectWithinAbsoluteError(juce::Decibels::gainToDecibels(std::abs(sum), -300.0), expectedDb, 1e-2);
+            }
+
+            // the step response is the running sum of the impulse response
+            double sum = 0, largestSum = 0, largestError = 0;
+            for (int n = 0; n < length; n++)
+            {
+                sum += impulse[static_cast<size_t>(n)];
+                largestSum = std::max(largestSum, std::abs(sum));
+                largestError = std::max(largestError, std::abs(sum - step[static_cast<size_t>(n)]));
+            }
+            expect(largestError <= 1e-3 * largestSum, "step error " + juce::String(largestError / largestSum));
+        }
+
+        beginTest("The realisation error of float sections is small");
+        {
+            auto chain = ProcessorChainModifier::compile(state, ChainCompileOptions::optimised());
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+
+            bool isDecaying = false;
+            const int length = TimeResponseCalculator::responseLength(snapshot.poles, *chain, isDecaying, TimeResponseCalculator::analysisDecayDb);
+            std::vector<float> impulse, step, errorDb;
+            TimeResponseCalculator::render(*chain, length, impulse, step);
+            const double snrDb = TimeResponseCalculator::realisationError(snapshot, 1.0, impulse, errorDb);
+            expect(snrDb > 90.0, "SNR " + juce::String(snrDb) + " dB");
+            expect(juce::isPowerOfTwo((int)errorDb.size()) && 2 * errorDb.size() >= impulse.size());
+            expect(*std::max_element(errorDb.begin(), errorDb.end()) < -60.f);
+
+            // a 1% gain error is 40 dB below the response everywhere
+            expectWithinAbsoluteError(TimeResponseCalculator::realisationError(snapshot, 1.01, impulse, errorDb), -20.0 * std::log10(0.01 / 1.01), 0.01);
+        }
+
+        beginTest("Renders in the background for a revision");
+        {
+            auto chain = ProcessorChainModifier::compile(state);
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+            TimeResponseCalculator calculator;
+            TimeResponseCalculator::Response response;
+            expect(!calculator.getResponse(response));
+
+            calculator.start(chain, snapshot, 1.0, state->revision);
+            expect(calculator.getRequestedRevision() == state->revision);
+            for (int wait = 0; wait < 500 && calculator.isRendering(); wait++)
+                juce::Thread::sleep(10);
+
+            expect(calculator.getResponse(response));
+            expect(response.revision == state->revision);
+            expect(response.isDecaying);
+            bool isDecaying = false;
+            expectEquals(response.length, TimeResponseCalculator::responseLength(snapshot.poles, *chain, isDecaying));
+            expect((int)response.impulse.size() > response.length);
+            expect(response.snrDb > 90.0);
+
+            std::vector<float> impulse, step;
+            TimeResponseCalculator::render(*chain, (int)response.impulse.size(), impulse, step);
+            expect(impulse == response.impulse && step == response.step);
+        }
+
+        beginTest("A restart doesn't wait for the render it replaces");
+        {
+            // a slow decay, so each render runs to the longest responses
+            std::vector<TestRootSpecification> roots{ { -2, 0.9999, 0 }, { 1, -0.5, 0 } };
+            TestHelper::makeFilterState(state, roots, 1.f);
+            auto chain = ProcessorChainModifier::compile(state);
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+            TimeResponseCalculator calculator;
+
+            // as a drag restarts it on every move
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (u64 revision = 1; revision <= 20; revision++)
+                calculator.start(chain, snapshot, 1.0, revision);
+            const auto restarted = juce::Time::getHighResolutionTicks();
+            for (int wait = 0; wait < 1000 && calculator.isRendering(); wait++)
+                juce::Thread::sleep(10);
+            const auto finished = juce::Time::getHighResolutionTicks();
+
+            TimeResponseCalculator::Response response;
+            expect(calculator.getResponse(response));
+            expect(response.revision == 20);
+            expectLessThan(restarted - start, finished - restarted, "20 restarts against the render of the last one");
+        }
+
+        beginTest("Decimation keeps every spike");
+        {
+            juce::Random random(3);
+            std::vector<float> values(1000);
+            for (auto& value : values)
+                value = random.nextFloat() - 0.5f;
+            values[417] = 3.f;
+            values[733] = -3.f;
+
+            for (int columns : { 1, 7, 250, 1000 })
+            {
+                std::vector<float> minima(static_cast<size_t>(columns)), maxima(static_cast<size_t>(columns));
+                TimeResponseCalculator::decimate(values.data(), (int)values.size(), columns, minima.data(), maxima.data());
+                expectEquals(*std::max_element(maxima.begin(), maxima.end()), 3.f);
+                expectEquals(*std::min_element(minima.begin(), minima.end()), -3.f);
+
+                // each column's range reaches the next one's first sample, so the lines join
+                for (int column = 0; column + 1 < columns; column++)
+                {
+                    const auto next = static_cast<size_t>((column + 1) * (int)values.size() / columns);
+                    expect(minima[static_cast<size_t>(column)] <= values[next] && values[next] <= maxima[static_cast<size_t>(column)]);
+                }
+            }
+        }
+
+        state->clear();
+    }
+
+private:
+    static constexpr double pi = juce::MathConstants<double>::pi;
+
+    static float largest(const std::vector<float>& values, int begin, int end)
+    {
+        float result = 0.f;
+        for (int n = begin; n < end; n++)
+            result = std::max(result, std::abs(values[static_cast<size_t>(n)]));
+        return result;
+    }
+};
+
+static TimeResponseTest timeResponseTest;
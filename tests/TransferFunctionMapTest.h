@@ -0,0 +1,162 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include "TestHelper.h"
+#include "../src/PluginProcessor.h"
+#include "../src/TransferFunctionMap.h"
+
+class TransferFunctionMapTest : public juce::UnitTest
+{
+public:
+    TransferFunctionMapTest() : UnitTest("TransferFunctionMapTest", "Math")
+    { }
+
+    void runTest() override
+    {
+        AudioPluginAudioProcessor processor; // shouldn't be a field of this class as its static object is defined.
+        auto* state = processor.filterState.get();
+        auto random = getRandom();
+
+        std::vector<TestRootSpecification> roots{
+            { 2, 0.9, 0.3 }, { 1, -0.5, 0 }, { 1, 0.2, 1.1 }, { 3, -1.0, 0 },
+            { -1, 0.8, 0.5 }, { -2, 0.3, 0 }, { -1, -0.6, 0.6 }, { -3, 0.1, 0.2 }
+        };
+        TestHelper::makeFilterState(state, roots, 1.f);
+
+        beginTest("The tiles are ln|H| of the roots");
+        {
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+
+            constexpr int size = 32;
+            const double left = -1.7, top = 1.3, step = 0.09;
+            std::vector<float> logMagnitudes(size * size);
+            TransferFunctionMap::evaluateTile(snapshot, left, top, step, size, logMagnitudes.data());
+            for (int row = 0; row < size; row++)
+                for (int column = 0; column < size; column++)
+                {
+                    const c128 z(left + (column + 0.5) * step, top - (row + 0.5) * step);
+                    expectWithinAbsoluteError((double)logMagnitudes[static_cast<size_t>(row * size + column)], directLog(snapshot, z), 1e-5);
+                }
+        }
+
+        beginTest("A far pair of high order doesn't overflow the products");
+        {
+            // each order of a pair is a fourth power of the distance, 8 of them would overflow
+            RootSnapshot snapshot;
+            for (auto [roots, re] : { std::pair{ &snapshot.zeros, 1e10 }, std::pair{ &snapshot.poles, -1e10 } })
+            {
+                roots->re.push_back(re);
+                roots->im.push_back(1e10);
+                roots->order.push_back(8);
+                roots->isReal.push_back(0);
+            }
+
+            constexpr int size = 16;
+            const double left = -1.0, top = 1.0, step = 0.125;
+            std::vector<float> logMagnitudes(size * size);
+            TransferFunctionMap::evaluateTile(snapshot, left, top, step, size, logMagnitudes.data());
+            for (int row = 0; row < size; row++)
+                for (int column = 0; column < size; column++)
+                {
+                    const c128 z(left + (column + 0.5) * step, top - (row + 0.5) * step);
+                    expectWithinAbsoluteError((double)logMagnitudes[static_cast<size_t>(row * size + column)], directLog(snapshot, z), 1e-5);
+                }
+        }
+
+        beginTest("A move changes ln|z - root| by no more than its bound");
+        {
+            const double left = 0.2, right = 0.6, bottom = -0.3, top = 0.1;
+            for (int i = 0; i < 1000; i++)
+            {
+                const c128 from(random.nextDouble() * 4 - 2, random.nextDouble() * 4 - 2);
+                const c128 to = from + c128(random.nextDouble() * 0.2 - 0.1, random.nextDouble() * 0.2 - 0.1);
+                const double bound = TransferFunctionMap::moveBound(left, right, bottom, top, from, to);
+                for (int j = 0; j < 10; j++)
+                {
+                    const c128 z(left + random.nextDouble() * (right - left), bottom + random.nextDouble() * (top - bottom));
+                    expect(std::abs(std::log(std::abs(z - to)) - std::log(std::abs(z - from))) <= bound);
+                }
+            }
+        }
+
+        beginTest("Dragging a root keeps the tiles far from it");
+        {
+            TransferFunctionMap map;
+            const double unitsPerPixel = 1.0 / 100;
+            const double left = -2.5, right = 2.5, bottom = -2.0, top = 2.0;
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+            map.update(snapshot, state->gain.get(), unitsPerPixel, left, right, bottom, top);
+            const auto visible = static_cast<u32>(map.getVisibleTiles().size());
+            expectEquals((int)map.getEvaluatedTiles(), (int)visible);
+
+            // a pixel or so per step, as a mouse drag moves it
+            constexpr int steps = 10;
+            for (int i = 1; i <= steps; i++)
+            {
+                state->zeros[0]->value = c128(0.9 + 0.01 * i, 0.3 - 0.005 * i);
+                snapshot.capture(*state);
+                const u32 evaluated = map.getEvaluatedTiles(), kept = map.getKeptTiles();
+                map.update(snapshot, state->gain.get(), unitsPerPixel, left, right, bottom, top);
+                expectEquals((int)(map.getEvaluatedTiles() - evaluated + map.getKeptTiles() - kept), (int)visible);
+            }
+            expect(map.getEvaluatedTiles() - visible < steps * visible / 2, juce::String(map.getEvaluatedTiles() - visible) + " tiles evaluated");
+
+            // every tile still drawn is within maxErrorDb of the roots as they are now
+            const double maxError = TransferFunctionMap::maxErrorDb / 20.0 * std::log(10.0);
+            const double tileUnits = map.getTileUnits();
+            for (const auto* tile : map.getVisibleTiles())
+                for (int row = 0; row < TransferFunctionMap::tileSize; row += 7)
+                    for (int column = 0; column < TransferFunctionMap::tileSize; column += 7)
+                    {
+                        const c128 z(tile->column * tileUnits + (column + 0.5) * unitsPerPixel, -tile->row * tileUnits - (row + 0.5) * unitsPerPixel);
+                        const double exact = directLog(snapshot, z);
+                        const double mapped = tile->logMagnitudes[static_cast<size_t>(row * TransferFunctionMap::tileSize + column)];
+                        if (std::isfinite(exact) && std::isfinite(mapped))
+                            expect(std::abs(mapped - exact) <= maxError + 1e-5);
+                    }
+        }
+
+        beginTest("Any other change of the roots evaluates every tile");
+        {
+            TransferFunctionMap map;
+            const double unitsPerPixel = 1.0 / 80;
+            RootSnapshot snapshot;
+            snapshot.capture(*state);
+            map.update(snapshot, state->gain.get(), unitsPerPixel, -2.0, 2.0, -1.5, 1.5);
+            const auto visible = static_cast<u32>(map.getVisibleTiles().size());
+
+            // a gain change only colours them again
+            state->gain.setValue(2.0, nullptr);
+            map.update(snapshot, state->gain.get(), unitsPerPixel, -2.0, 2.0, -1.5, 1.5);
+            expectEquals((int)map.getEvaluatedTiles(), (int)visible);
+
+            state->poles[0]->order = -2;
+            snapshot.capture(*state);
+            map.update(snapshot, state->gain.get(), unitsPerPixel, -2.0, 2.0, -1.5, 1.5);
+            expectEquals((int)map.getEvaluatedTiles(), (int)(2 * visible));
+        }
+
+        state->clear();
+    }
+
+private:
+    static double directLog(const RootSnapshot& snapshot, c128 z)
+    {
+        double result = 0.0;
+        for (auto [roots, sign] : { std::pair{ &snapshot.zeros, 1.0 }, std::pair{ &snapshot.poles, -1.0 } })
+            for (size_t k = 0; k < roots->size(); k++)
+            {
+                const c128 root(roots->re[k], roots->im[k]);
+                double factor = std::log(std::abs(z - root));
+                if (!roots->isReal[k])
+                    factor += std::log(std::abs(z - std::conj(root)));
+                result += sign * roots->order[k] * factor;
+            }
+        return result;
+    }
+};
+
+static TransferFunctionMapTest transferFunctionMapTest;